@@ -2,6 +2,25 @@ def can_build(env, platform):
     return True
 
 
+def get_opts(platform):
+    from SCons.Variables import BoolVariable
+
+    return [
+        BoolVariable(
+            "javascript_inline_cache", "Cache the property lookups of the QuickJS interpreter by object shape", True
+        ),
+        BoolVariable(
+            "javascript_incremental_gc", "Allow the QuickJS cycle collection to be spread over several frames", True
+        ),
+        BoolVariable(
+            "javascript_bignum", "Build QuickJS with BigInt, BigFloat, BigDecimal and the math mode", True
+        ),
+        BoolVariable(
+            "javascript_debugger", "Build the QuickJS debugger, which listens for or connects to a debug client", False
+        ),
+    ]
+
+
 def configure(env):
     pass
 
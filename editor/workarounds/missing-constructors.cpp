@@ -45,6 +45,26 @@ Dictionary create_missing_constructors() {
 	dict["AABB"] =
 			"\t\tconstructor(from: AABB);\n"
 			"\t\tconstructor(position?: Vector3, size?: Vector3);\n";
+	dict["Vector2i"] = "\t\tconstructor(x?: number, y?: number);\n"
+					   "\t\tconstructor(v: Vector2i);\n"
+					   "\t\tconstructor(from: Vector2);\n";
+	dict["Vector3i"] = "\t\tconstructor(x?: number, y?: number, z?: number);\n"
+					   "\t\tconstructor(v: Vector3i);\n"
+					   "\t\tconstructor(from: Vector3);\n";
+	dict["Vector4"] = "\t\tconstructor(x?: number, y?: number, z?: number, w?: number);\n"
+					  "\t\tconstructor(v: Vector4);\n"
+					  "\t\tconstructor(from: Vector4i);\n";
+	dict["Vector4i"] = "\t\tconstructor(x?: number, y?: number, z?: number, w?: number);\n"
+					   "\t\tconstructor(v: Vector4i);\n"
+					   "\t\tconstructor(from: Vector4);\n";
+	dict["Rect2i"] = "\t\tconstructor(from: Rect2i);\n"
+					 "\t\tconstructor(from: Rect2);\n"
+					 "\t\tconstructor(x?: number, y?: number, w?: number, h?: number);\n"
+					 "\t\tconstructor(pos: Vector2i, size: Vector2i);\n";
+	dict["Projection"] = "\t\tconstructor();\n"
+						 "\t\tconstructor(from: Projection);\n"
+						 "\t\tconstructor(from: Transform3D);\n"
+						 "\t\tconstructor(x_axis: Vector4, y_axis: Vector4, z_axis: Vector4, w_axis: Vector4);\n";
 	dict["PackedByteArray"] =
 			"\t\tconstructor(source?: number[]);\n"
 			"\t\tconstructor(from: PackedByteArray);\n"
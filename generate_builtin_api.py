@@ -14,6 +14,12 @@ BUILTIN_CLASSES = [
     "Plane",
     "AABB",
     "Transform3D",
+    "Vector2i",
+    "Vector3i",
+    "Vector4",
+    "Vector4i",
+    "Rect2i",
+    "Projection",
     "PackedByteArray",
     "PackedInt32Array",
     "PackedInt64Array",
@@ -37,6 +43,12 @@ MAX_CONSTRUCTOR_ARGC = {
     "Plane": 0,
     "AABB": 0,
     "Transform3D": 0,
+    "Vector2i": 2,
+    "Vector3i": 3,
+    "Vector4": 4,
+    "Vector4i": 4,
+    "Rect2i": 4,
+    "Projection": 0,
     "PackedByteArray": 0,
     "PackedInt32Array": 0,
     "PackedInt64Array": 0,
@@ -49,11 +61,12 @@ MAX_CONSTRUCTOR_ARGC = {
 }
 
 TYPE_MAP = {
-    "int": "number",
+    "int": "int",
     "float": "number",
     "bool": "boolean",
     "String": "string",
-    "NodePath": "string",
+    "StringName": "StringName",
+    "NodePath": "NodePath",
 }
 
 METHOD_OP_EQUALS = {
@@ -107,14 +120,14 @@ METHOD_OP_MUL_ASSIGN = {
 
 METHOD_OP_DIV = {
     "arguments": [{"default_value": None, "has_default_value": False, "type": "${class_name}"}],
-    "name": "multiply",
+    "name": "divide",
     "native_method": "operator/",
     "return": "${class_name}",
 }
 
 METHOD_OP_DIV_ASSIGN = {
     "arguments": [{"default_value": None, "has_default_value": False, "type": "${class_name}"}],
-    "name": "multiply_assign",
+    "name": "divide_assign",
     "native_method": "operator/=",
     "return": "this",
 }
@@ -157,6 +170,8 @@ IGNORED_PROPS = {
     "Plane": ["intersects_segment", "intersects_ray", "intersect_3"],
     "AABB": ["end"],
     "Transform3D": ["xform", "xform_inv"],
+    "Rect2i": ["end", "grow_side"],
+    "Projection": ["get_projection_plane"],
     "PackedByteArray": [
         "compress",
         "decompress",
@@ -190,6 +205,12 @@ PROPERTY_REMAP = {
         "y": "normal.y",
         "z": "normal.z",
     },
+    "Projection": {
+        "x": "columns[0]",
+        "y": "columns[1]",
+        "z": "columns[2]",
+        "w": "columns[3]",
+    },
 }
 
 OPERATOR_METHODS = {
@@ -237,6 +258,8 @@ OPERATOR_METHODS = {
         METHOD_OP_ADD_ASSIGN,
         METHOD_OP_SUB,
         METHOD_OP_SUB_ASSIGN,
+        METHOD_OP_MUL,
+        METHOD_OP_MUL_ASSIGN,
     ],
     "Rect2": [METHOD_OP_EQUALS],
     "Transform2D": [
@@ -274,6 +297,67 @@ OPERATOR_METHODS = {
         METHOD_OP_MUL,
         METHOD_OP_MUL_ASSIGN,
     ],
+    "Vector2i": [
+        METHOD_OP_NEG,
+        METHOD_OP_EQUALS,
+        METHOD_OP_LESS,
+        METHOD_OP_LESS_EQAUL,
+        METHOD_OP_ADD,
+        METHOD_OP_ADD_ASSIGN,
+        METHOD_OP_SUB,
+        METHOD_OP_SUB_ASSIGN,
+        METHOD_OP_MUL,
+        METHOD_OP_MUL_ASSIGN,
+        METHOD_OP_DIV,
+        METHOD_OP_DIV_ASSIGN,
+    ],
+    "Vector3i": [
+        METHOD_OP_NEG,
+        METHOD_OP_EQUALS,
+        METHOD_OP_LESS,
+        METHOD_OP_LESS_EQAUL,
+        METHOD_OP_ADD,
+        METHOD_OP_ADD_ASSIGN,
+        METHOD_OP_SUB,
+        METHOD_OP_SUB_ASSIGN,
+        METHOD_OP_MUL,
+        METHOD_OP_MUL_ASSIGN,
+        METHOD_OP_DIV,
+        METHOD_OP_DIV_ASSIGN,
+    ],
+    "Vector4": [
+        METHOD_OP_NEG,
+        METHOD_OP_EQUALS,
+        METHOD_OP_LESS,
+        METHOD_OP_LESS_EQAUL,
+        METHOD_OP_ADD,
+        METHOD_OP_ADD_ASSIGN,
+        METHOD_OP_SUB,
+        METHOD_OP_SUB_ASSIGN,
+        METHOD_OP_MUL,
+        METHOD_OP_MUL_ASSIGN,
+        METHOD_OP_DIV,
+        METHOD_OP_DIV_ASSIGN,
+    ],
+    "Vector4i": [
+        METHOD_OP_NEG,
+        METHOD_OP_EQUALS,
+        METHOD_OP_LESS,
+        METHOD_OP_LESS_EQAUL,
+        METHOD_OP_ADD,
+        METHOD_OP_ADD_ASSIGN,
+        METHOD_OP_SUB,
+        METHOD_OP_SUB_ASSIGN,
+        METHOD_OP_MUL,
+        METHOD_OP_MUL_ASSIGN,
+        METHOD_OP_DIV,
+        METHOD_OP_DIV_ASSIGN,
+    ],
+    "Rect2i": [METHOD_OP_EQUALS],
+    "Projection": [
+        METHOD_OP_EQUALS,
+        METHOD_OP_MUL,
+    ],
 }
 
 
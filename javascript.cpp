@@ -37,7 +37,7 @@ StringName JavaScript::get_instance_base_type() const {
 }
 
 ScriptInstance *JavaScript::instance_create(Object *p_this) {
-	JavaScriptBinder *binder = JavaScriptLanguage::get_thread_binder(Thread::get_caller_id());
+	JavaScriptBinder *binder = JavaScriptLanguage::get_current_thread_binder();
 	ERR_FAIL_NULL_V_MSG(binder, NULL, "Cannot create instance from this thread");
 	const JavaScriptClassInfo *cls = NULL;
 	JavaScriptError js_err;
@@ -81,7 +81,7 @@ PlaceHolderScriptInstance *JavaScript::placeholder_instance_create(Object *p_thi
 Error JavaScript::reload(bool p_keep_state) {
 	javascript_class = NULL;
 	Error err = OK;
-	JavaScriptBinder *binder = JavaScriptLanguage::get_thread_binder(Thread::get_caller_id());
+	JavaScriptBinder *binder = JavaScriptLanguage::get_current_thread_binder();
 #ifdef TOOLS_ENABLED
 	// This is a workaround for files generated outside of the godot editor
 	if (binder == NULL) {
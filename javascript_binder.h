@@ -32,6 +32,16 @@ struct BasicJavaScriptClassInfo {
 struct JavaScriptClassInfo : public BasicJavaScriptClassInfo {
 	JavaScriptGCHandler constructor;
 	JavaScriptGCHandler prototype;
+	// Static `_process_batch(instances, delta)` and `_physics_process_batch(instances, delta)` of the class, they replace the `_process` and `_physics_process` of its instances
+	JavaScriptGCHandler process_batch;
+	JavaScriptGCHandler physics_process_batch;
+	// Frames in which the batch update hooks have been called in the context of the class
+	mutable uint64_t process_batch_frame;
+	mutable uint64_t physics_process_batch_frame;
+	// Object with the final shape of the instances and the default values of the exported properties
+	JavaScriptGCHandler instance_template;
+	// Count of freed instances kept for reuse, 0 if the class is not pooled
+	int pool_size;
 };
 
 struct GlobalNumberConstant {
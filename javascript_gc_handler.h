@@ -21,6 +21,8 @@ struct JavaScriptGCHandler {
 		FLAG_REF_COUNTED = 1 << 4,
 		FLAG_FINALIZED = 1 << 5,
 		FLAG_TRANSFERABLE = 1 << 6,
+		// Kept by the instance pool of its script class after its object was freed
+		FLAG_POOLED = 1 << 7,
 	};
 	Variant::Type type;
 	uint8_t flags;
@@ -58,6 +60,18 @@ struct JavaScriptGCHandler {
 				return *(static_cast<Plane *>(godot_builtin_object_ptr));
 			case Variant::AABB:
 				return *(static_cast<AABB *>(godot_builtin_object_ptr));
+			case Variant::VECTOR2I:
+				return *(static_cast<Vector2i *>(godot_builtin_object_ptr));
+			case Variant::VECTOR3I:
+				return *(static_cast<Vector3i *>(godot_builtin_object_ptr));
+			case Variant::VECTOR4:
+				return *(static_cast<Vector4 *>(godot_builtin_object_ptr));
+			case Variant::VECTOR4I:
+				return *(static_cast<Vector4i *>(godot_builtin_object_ptr));
+			case Variant::RECT2I:
+				return *(static_cast<Rect2i *>(godot_builtin_object_ptr));
+			case Variant::PROJECTION:
+				return *(static_cast<Projection *>(godot_builtin_object_ptr));
 			case Variant::PACKED_INT32_ARRAY:
 				return *(static_cast<PackedInt32Array *>(godot_builtin_object_ptr));
 			case Variant::PACKED_INT64_ARRAY:
@@ -100,6 +114,12 @@ struct JavaScriptGCHandler {
 	_FORCE_INLINE_ RID *getRID() const { return static_cast<RID *>(godot_builtin_object_ptr); }
 	_FORCE_INLINE_ Plane *getPlane() const { return static_cast<Plane *>(godot_builtin_object_ptr); }
 	_FORCE_INLINE_ Quaternion *getQuaternion() const { return static_cast<Quaternion *>(godot_builtin_object_ptr); }
+	_FORCE_INLINE_ Vector2i *getVector2i() const { return static_cast<Vector2i *>(godot_builtin_object_ptr); }
+	_FORCE_INLINE_ Vector3i *getVector3i() const { return static_cast<Vector3i *>(godot_builtin_object_ptr); }
+	_FORCE_INLINE_ Vector4 *getVector4() const { return static_cast<Vector4 *>(godot_builtin_object_ptr); }
+	_FORCE_INLINE_ Vector4i *getVector4i() const { return static_cast<Vector4i *>(godot_builtin_object_ptr); }
+	_FORCE_INLINE_ Rect2i *getRect2i() const { return static_cast<Rect2i *>(godot_builtin_object_ptr); }
+	_FORCE_INLINE_ Projection *getProjection() const { return static_cast<Projection *>(godot_builtin_object_ptr); }
 	_FORCE_INLINE_ PackedInt32Array *getPackedInt32Array() const { return static_cast<PackedInt32Array *>(godot_builtin_object_ptr); }
 	_FORCE_INLINE_ PackedInt64Array *getPackedInt64Array() const { return static_cast<PackedInt64Array *>(godot_builtin_object_ptr); }
 	_FORCE_INLINE_ PackedByteArray *getPackedByteArray() const { return static_cast<PackedByteArray *>(godot_builtin_object_ptr); }
@@ -1,5 +1,7 @@
 #include "javascript_instance.h"
+#include "core/config/engine.h"
 #include "javascript.h"
+#include "scene/main/node.h"
 #include "src/language/javascript_language.h"
 
 Ref<Script> JavaScriptInstance::get_script() const {
@@ -17,6 +19,11 @@ void JavaScriptInstance::get_method_list(List<MethodInfo> *p_list) const {
 bool JavaScriptInstance::has_method(const StringName &p_method) const {
 	if (!binder || !javascript_object.javascript_object)
 		return false;
+	// Keep the processing of the node enabled for the batch update hooks
+	if (javascript_class && javascript_class->process_batch.javascript_object && p_method == SNAME("_process"))
+		return true;
+	if (javascript_class && javascript_class->physics_process_batch.javascript_object && p_method == SNAME("_physics_process"))
+		return true;
 	return binder->has_method(javascript_object, p_method);
 }
 
@@ -56,12 +63,51 @@ Variant JavaScriptInstance::callp(const StringName &p_method, const Variant **p_
 		r_error.error = Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL;
 		ERR_FAIL_V(Variant());
 	}
+	if (javascript_class->process_batch.javascript_object && p_method == SNAME("_process")) {
+		call_batch(javascript_class->process_batch, false, p_args, p_argcount, r_error);
+		return Variant();
+	}
+	if (javascript_class->physics_process_batch.javascript_object && p_method == SNAME("_physics_process")) {
+		call_batch(javascript_class->physics_process_batch, true, p_args, p_argcount, r_error);
+		return Variant();
+	}
 	if (binder->has_method(javascript_object, p_method)) {
 		return binder->call_method(javascript_object, p_method, p_args, p_argcount, r_error);
 	}
 	return Variant();
 }
 
+void JavaScriptInstance::call_batch(const JavaScriptGCHandler &p_function, bool p_physics, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	r_error.error = Callable::CallError::CALL_OK;
+	// The first instance processed in the frame updates all the instances of the class owned by the same context
+	const uint64_t frame = p_physics ? Engine::get_singleton()->get_physics_frames() : Engine::get_singleton()->get_process_frames();
+	uint64_t &last_frame = p_physics ? javascript_class->physics_process_batch_frame : javascript_class->process_batch_frame;
+	if (last_frame == frame) {
+		return;
+	}
+	last_frame = frame;
+
+	Array instances;
+	for (Object *obj : script->instances) {
+		ScriptInstance *si = obj->get_script_instance();
+		if (si == NULL || si->is_placeholder() || static_cast<JavaScriptInstance *>(si)->binder != binder) {
+			continue;
+		}
+		// Only the instances the engine would call this frame
+		if (Node *node = Object::cast_to<Node>(obj)) {
+			if (!node->is_inside_tree() || !node->can_process() || !(p_physics ? node->is_physics_processing() : node->is_processing())) {
+				continue;
+			}
+		}
+		instances.push_back(obj);
+	}
+
+	const Variant instances_var = instances;
+	const Variant delta = p_argcount > 0 ? *p_args[0] : Variant();
+	const Variant *args[2] = { &instances_var, &delta };
+	binder->call(p_function, javascript_class->constructor, args, 2, r_error);
+}
+
 ScriptLanguage *JavaScriptInstance::get_language() {
 	return JavaScriptLanguage::get_singleton();
 }
@@ -17,6 +17,8 @@ class JavaScriptInstance : public ScriptInstance {
 	JavaScriptBinder *binder;
 	const JavaScriptClassInfo *javascript_class;
 
+	void call_batch(const JavaScriptGCHandler &p_function, bool p_physics, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+
 public:
 	virtual bool set(const StringName &p_name, const Variant &p_value) override;
 	virtual bool get(const StringName &p_name, Variant &r_ret) const override;
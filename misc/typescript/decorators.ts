@@ -20,6 +20,17 @@ export function icon<T extends godot.Object>(icon) {
 	}
 }
 
+/**
+ * Keep up to `size` freed instances of the class to reuse them for the next objects of the class
+ *
+ * The constructor is not called for reused instances, implement `_reset()` to initialize them
+ */
+export function pooled<T extends godot.Object>(size: number) {
+	return function (target: new() => T) {
+		godot.set_script_pooled(target, size);
+	}
+}
+
 /** Register signal to godot script */
 export function signal(target: godot.Object | (new() => godot.Object), property: string, descriptor?: any) {
 	var constructor: Function = typeof(target) === 'function' ? target : target.constructor;
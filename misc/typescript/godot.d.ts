@@ -51,6 +51,27 @@ declare module globalThis {
 		LOG_OBJECT_TO_JSON: boolean;
 	}
 
+	interface WorkerOptions {
+		/**
+		 * How the messages are copied between the contexts
+		 * - `"variant"` (default): messages are converted to `godot.Variant`
+		 * - `"structured"`: messages are written to a binary buffer with a structured clone of the value graph, which keeps `Map`, `Set`, `Date`, typed arrays and object references.
+		 *   Messages that cannot be cloned this way (like godot objects and builtin types) are converted to `godot.Variant` instead.
+		 */
+		serialization?: "variant" | "structured";
+
+		/**
+		 * What the context of the worker is set up with
+		 * - `"full"` (default): all the godot API
+		 * - `"compute"`: only the builtin types (`godot.Vector2`, `godot.Color` ...), the number constants and the classes listed in `classes` with their base classes.
+		 *   Other engine classes, singletons, global constants and `godot.Object.prototype.connect` with functions are not available, the worker starts faster and uses less memory.
+		 */
+		profile?: "full" | "compute";
+
+		/** Names of the engine classes available in a `"compute"` worker, `godot.Object` and `godot.RefCounted` are always available */
+		classes?: string[];
+	}
+
 	/**
 	 * A worker is an object created using a constructor of `Worker` that runs a named JavaScript file — this file contains the code that will run in the worker thread;
 	 *
@@ -61,6 +82,10 @@ declare module globalThis {
 	 * Data is sent between workers and the main thread via a system of messages — both sides send their messages using the `postMessage()` method, and respond to messages via the `onmessage` event handler (the message is contained within the Message event's data attribute.) The data is copied rather than shared.
 	 *
 	 * You can **transfer** value with `Worker.abandonValue` and `Worker.adoptValue`. After a value is abandoned you cannot using it anymore in the context.
+	 * `ArrayBuffer`s can also be transferred without copy by listing them in the `transfer` argument of `postMessage()`.
+	 *
+	 * A `SharedArrayBuffer` sent in a structured clone message is shared by reference: both contexts see the same memory and can synchronize with `Atomics`.
+	 * `Atomics.wait()` is only allowed inside workers, it throws on the main thread.
 	 *
 	 * Workers may, in turn, spawn new workers, all sub-worker will be stopped when the host context stop.
 	 */
@@ -70,7 +95,7 @@ declare module globalThis {
 		/**
 		 * Creates a dedicated worker thread that executes the script at the specified file
 		 */
-		constructor(script: string);
+		constructor(script: string, options?: WorkerOptions);
 
 		/**
 		 * The `onmessage` property of the Worker interface represents an event handler, that is a function to be called when the message event occurs.
@@ -82,8 +107,10 @@ declare module globalThis {
 		 * Sends a message to the worker's inner scope. This accepts a single parameter, which is the data to send to the worker.
 		 * @param message The object to deliver to the worker; this will be in the data field in the event delivered to the `onmessage` handler.
 		 * @note The data cannot be instance of `godot.Object` or any other JavaScript object contains functions.
+		 * @param transfer `ArrayBuffer`s to move to the worker instead of copying them, they are detached in the current context. The message is always sent as structured clone when this is not empty.
+		 * @throws {RangeError} If the worker has too many (1024) messages waiting to be handled.
 		 */
-		postMessage(message: any): void;
+		postMessage(message: any, transfer?: ArrayBuffer[]): void;
 
 		/**
 		 * Stop the worker thread
@@ -109,8 +136,10 @@ declare module globalThis {
 	 * Sends a message to the host thread context that spawned it.
 	 *
 	 * @param {*} message The message to send
+	 * @param transfer `ArrayBuffer`s to move to the host instead of copying them, they are detached in the current context. The message is always sent as structured clone when this is not empty.
+	 * @throws {RangeError} If the host has too many (1024) messages waiting to be handled.
 	 */
-	function postMessage(message: any): void;
+	function postMessage(message: any, transfer?: ArrayBuffer[]): void;
 
 	/** **Worker context only**
 	 *
@@ -178,6 +207,24 @@ declare module godot {
 	 */
 	function set_script_icon(target: GodotClass, icon: string);
 
+	/**
+	 * Reuse the instances of the script class instead of creating new ones.
+	 *
+	 * When an object of the class is freed on the thread of its context and its instance is not referenced by scripts anymore, the instance is kept in the pool of the class.
+	 * The next object of the class takes an instance from the pool: its own fields are set to `undefined`, its exported properties are restored to their default values and its `_reset()` method is called.
+	 * The constructor is not called, so `_reset()` must initialize the fields that are not exported.
+	 * @param target The script class
+	 * @param size The maximum count of instances kept in the pool
+	 * @note Only classes that do not extend `godot.RefCounted` can be pooled.
+	 */
+	function set_script_pooled(target: GodotClass, size: number);
+
+	/**
+	 * Returns the state of the instance pool of a script class, or `null` if the class is not pooled
+	 * @param target The script class
+	 */
+	function get_script_pool_info(target: GodotClass): { size: number, capacity: number, hits: number, misses: number, hit_rate: number } | null;
+
 	/**
 	 * Returns the internal type of the given `Variant` object, using the `godot.TYPE_*`
 	 */
@@ -204,6 +251,9 @@ declare module godot {
 	 * You can adopt the value in another thread context to transfer the `value` in threads.
 	 *
 	 * A `non zero` ID is return if no error happen.
+	 * If `value` is an array all the godot objects it contains, nested arrays included, are abandoned at once, they are adopted together as a new array.
+	 *
+	 * Values that are not adopted within `JavaScript/worker/transfer_timeout` seconds (project setting, `0` to disable) are dropped, their `godot.Object` that are not references are freed.
 	 * @param value The value to abandon in the context
 	 * @note You can only transfer values the godot `Variant` can represent.
 	 * @returns The ID of the abandoned value
@@ -216,6 +266,88 @@ declare module godot {
 	*/
 	function adopt_value(value_id: number): any;
 
+	/**
+	 * A function exported by a module, as `"res://path/to/module.js#exportName"` or `{ module, export }`.
+	 *
+	 * The `default` export is used if the export name is omitted.
+	 */
+	type TaskFunction = string | { module: string, export?: string };
+
+	/**
+	 * Runs functions on a fixed pool of threads, each thread has its own context where the task modules are loaded once.
+	 *
+	 * Values are copied between the contexts as structured clones, `SharedArrayBuffer`s are shared.
+	 *
+	 * The size of the pool is set by the `JavaScript/parallel/thread_count` project setting.
+	 *
+	 * @note Not available inside the tasks.
+	 */
+	namespace parallel {
+		/**
+		 * Calls `fn(index, data)` for every index of `range` on the threads of the pool.
+		 * @param range The count of calls, or the `[start, end)` indices
+		 * @param fn The function to call
+		 * @param data A value passed to every call
+		 * @returns A promise resolved when all the calls are done, or rejected with the first error
+		 */
+		function parallelFor(range: number | [number, number], fn: TaskFunction, data?: any): Promise<void>;
+
+		/**
+		 * Calls `fn(item, index)` for every item of `array` on the threads of the pool.
+		 * @returns A promise resolved with the values returned by the calls, or rejected with the first error.
+		 * It is also rejected if a call returns a `godot.Object`, the objects of a task stay in its thread.
+		 */
+		function map<T = any, R = any>(array: T[], fn: TaskFunction): Promise<R[]>;
+	}
+
+	/**
+	 * The handle of a `godot.Object` that is bound to another context, for example a node of the main thread passed to a worker with `abandon_value`.
+	 *
+	 * The proxy only keeps the instance id of the object. Every call is sent to the context that owns the object and runs at its next frame, the returned promise is settled with the result.
+	 * The promise is rejected if the object was freed or the owner context has been destroyed.
+	 *
+	 * Passing a proxy back to the engine passes the object itself.
+	 */
+	class ObjectProxy {
+		private constructor();
+
+		/** Calls the method `method` of the object in the context that owns it */
+		call(method: string, ...args: any[]): Promise<any>;
+
+		/** Gets the property `property` of the object in the context that owns it */
+		get(property: string): Promise<any>;
+
+		/** Sets the property `property` of the object in the context that owns it */
+		set(property: string, value: any): Promise<void>;
+
+		/** Returns the instance id of the object */
+		get_instance_id(): number;
+	}
+
+	/**
+	 * An engine `Array` shared with the scripts, returned by the engine when `JavaScript/bindings/live_collections` is enabled.
+	 *
+	 * The elements are converted when they are read and written back to the array when they are set. It has the methods of `Array.prototype`.
+	 * Only the last element can be deleted, which `pop`, `shift` and `splice` do. Setting the length or an index past the end fills the array with nulls.
+	 * Passing it back to the engine passes the array itself, without copying it.
+	 */
+	class ArrayProxy<T = any> extends Array<T> {
+		/** Creates an empty engine array */
+		constructor();
+	}
+
+	/**
+	 * An engine `Dictionary` shared with the scripts, returned by the engine when `JavaScript/bindings/live_collections` is enabled.
+	 *
+	 * Its keys are the string keys of the dictionary, or the integer keys read as indices. Deleting a property erases the key.
+	 * Passing it back to the engine passes the dictionary itself, without copying it.
+	 */
+	class DictionaryProxy {
+		/** Creates an empty engine dictionary */
+		constructor();
+		[key: string]: any;
+	}
+
 	/**
 	 * Wait a signal of an object
 	 * @param target The owner of the signal to wait
@@ -1,5 +1,6 @@
 /* This is the language server implementation. It handles how/when to use JS Scripts. */
 
+#include "core/config/project_settings.h"
 #include "core/io/file_access.h"
 #include "core/object/class_db.h"
 
@@ -7,6 +8,7 @@
 #include "javascript_language.h"
 
 JavaScriptLanguage *JavaScriptLanguage::singleton = nullptr;
+thread_local JavaScriptBinder *JavaScriptLanguage::thread_binder = nullptr;
 
 JavaScriptLanguage::JavaScriptLanguage() {
 	ERR_FAIL_COND(singleton);
@@ -25,6 +27,20 @@ JavaScriptLanguage::~JavaScriptLanguage() {
 
 void JavaScriptLanguage::init() {
 	ERR_FAIL_NULL(main_binder);
+	// Threads used by `godot.parallel`, 0 uses all the cores but one
+	GLOBAL_DEF("JavaScript/parallel/thread_count", 0);
+	// Seconds before a value abandoned with `godot.abandon_value` is dropped if it was not adopted, 0 keeps it forever
+	GLOBAL_DEF("JavaScript/worker/transfer_timeout", 60);
+	// Copy the inherited methods of the engine classes onto each class prototype so their lookup does not walk the chain.
+	// Uses more memory, and later changes to the prototype of a base class are not seen by the classes that copied it
+	GLOBAL_DEF("JavaScript/bindings/flatten_prototypes", false);
+	// Pass the engine arrays and dictionaries to the scripts as `godot.ArrayProxy` and `godot.DictionaryProxy` sharing them,
+	// their elements are converted when they are read instead of copying the whole collection
+	GLOBAL_DEF("JavaScript/bindings/live_collections", false);
+	// Microseconds of each frame spent collecting the reference cycles a slice at a time, 0 collects them all at once when the heap has grown
+	GLOBAL_DEF("JavaScript/gc/incremental_step_usec", 1000);
+	// Objects allocated between two collections of the cycles made only of new objects, 0 leaves them to the full collection
+	GLOBAL_DEF("JavaScript/gc/nursery_size", 4096);
 	main_binder->initialize();
 }
 
@@ -23,6 +23,8 @@ private:
 	static JavaScriptLanguage *singleton;
 	JavaScriptBinder *main_binder;
 	HashMap<Thread::ID, JavaScriptBinder *> thread_binder_map;
+	// The binder initialized on the calling thread, a lock free shortcut of `thread_binder_map` for the hot paths
+	static thread_local JavaScriptBinder *thread_binder;
 	GDExtensionInstanceBindingCallbacks instance_binding_callbacks;
 
 	CallableMiddleman *callable_middleman;
@@ -118,6 +120,7 @@ public:
 		}
 		return nullptr;
 	}
+	_FORCE_INLINE_ static JavaScriptBinder *get_current_thread_binder() { return thread_binder; }
 	_FORCE_INLINE_ CallableMiddleman *get_callable_middleman() const { return callable_middleman; }
 	const GDExtensionInstanceBindingCallbacks *get_instance_binding_callbacks() const { return &instance_binding_callbacks; }
 
@@ -56,6 +56,278 @@ test(
   "core",
 );
 
+test(
+  "Vector2i, Vector3i and Vector4i",
+  () => {
+    const v2 = new godot.Vector2i(new godot.Vector2(1.7, -2.2));
+    const v3 = new godot.Vector3i(3);
+    const v4 = new godot.Vector4i(new godot.Vector4(1, 2, 3, 4));
+    return (
+      v2 instanceof godot.Vector2i &&
+      v2.x === 1 &&
+      v2.y === -2 &&
+      v3.x === 3 &&
+      v3.z === 3 &&
+      v4.w === 4 &&
+      new godot.Vector2i(3, 4).length_squared() === 25 &&
+      new godot.Vector4(new godot.Vector4i(1, 2, 3, 4)).z === 3
+    );
+  },
+  "builtin",
+);
+
+test(
+  "Integer vectors scaled by numbers",
+  () => {
+    const v = new godot.Vector2i(3, 4);
+    const doubled = v * 2;
+    const halved = v / 2;
+    const scaled = v * 0.5;
+    return (
+      doubled instanceof godot.Vector2i &&
+      doubled.x === 6 &&
+      2 * new godot.Vector3i(1, 2, 3) instanceof godot.Vector3i &&
+      halved instanceof godot.Vector2i &&
+      halved.x === 1 &&
+      halved.y === 2 &&
+      scaled instanceof godot.Vector2 &&
+      scaled.x === 1.5 &&
+      (v / 0.5).x === 6
+    );
+  },
+  "builtin",
+);
+
+test(
+  "Integer vector division by zero",
+  () => {
+    const throwsRangeError = (block) => {
+      try {
+        block();
+      } catch (e) {
+        return e instanceof RangeError;
+      }
+      return false;
+    };
+    const min = new godot.Vector4i(-2147483648, 1, 1, 1);
+    const out = new godot.Vector2i(5, 5);
+    const v = new godot.Vector2i(7, 9);
+    let threwTypeError = false;
+    try {
+      v.divide_assign(0.5);
+    } catch (e) {
+      threwTypeError = e instanceof TypeError;
+    }
+    return (
+      throwsRangeError(() => new godot.Vector2i(1, 1) / new godot.Vector2i(0, 1)) &&
+      throwsRangeError(() => new godot.Vector2i(1, 1) / 0) &&
+      throwsRangeError(() => new godot.Vector3i(1, 1, 1) / -0) &&
+      // The divide methods take an integer number too
+      throwsRangeError(() => godot.Vector2i.divide(out, v, 0)) &&
+      throwsRangeError(() => v.divide_assign(0)) &&
+      throwsRangeError(() => min.divide_assign(-1)) &&
+      threwTypeError &&
+      out.x === 5 &&
+      v.x === 7 &&
+      godot.Vector2i.divide(out, v, 2) === out &&
+      out.x === 3 &&
+      out.y === 4 &&
+      v.divide_assign(-3) === v &&
+      v.x === -2 &&
+      v.y === -3 &&
+      throwsRangeError(() => new godot.Vector3i(1, 1, 1) / new godot.Vector3i(1, 1, 0)) &&
+      throwsRangeError(() => min / new godot.Vector4i(-1, 1, 1, 1)) &&
+      throwsRangeError(() => min / -1) &&
+      (new godot.Vector2i(7, 9) / new godot.Vector2i(2, 3)).x === 3
+    );
+  },
+  "builtin",
+);
+
+test(
+  "Rect2i and Projection",
+  () => {
+    const rect = new godot.Rect2i(new godot.Vector2i(1, 2), new godot.Vector2i(3, 4));
+    const from_rect2 = new godot.Rect2i(new godot.Rect2(1.5, 2, 3, 4));
+    const projection = new godot.Projection();
+    const moved = new godot.Projection(new godot.Transform3D(new godot.Basis(), new godot.Vector3(1, 2, 3)));
+    return (
+      rect.position.x === 1 &&
+      rect.size.y === 4 &&
+      rect.get_area() === 12 &&
+      from_rect2.position.x === 1 &&
+      projection.x.x === 1 &&
+      projection.w.w === 1 &&
+      projection.x.y === 0 &&
+      moved.w.x === 1 &&
+      moved.w.z === 3
+    );
+  },
+  "builtin",
+);
+
+test(
+  "In-place operators",
+  () => {
+    const a = new godot.Vector3(1, 2, 3);
+    const b = new godot.Vector3(2, 4, 8);
+    const sum = a + b;
+    const difference = a - b;
+    const product = a * b;
+    const quotient = a / b;
+    const v = new godot.Vector3(1, 2, 3);
+    const same = (x, y) => x.x === y.x && x.y === y.y && x.z === y.z;
+    let ok = v.add_assign(b) === v && same(v, sum);
+    ok = ok && v.subtract_assign(b) === v && same(v, a);
+    ok = ok && v.multiply_assign(b) === v && same(v, product);
+    ok = ok && v.divide_assign(b) === v && same(v, a);
+    return ok && same(a, new godot.Vector3(1, 2, 3)) && same(difference, new godot.Vector3(-1, -2, -5)) && quotient.z === 0.375;
+  },
+  "builtin",
+);
+
+test(
+  "Out parameter operators",
+  () => {
+    const a = new godot.Vector3(1, 2, 3);
+    const b = new godot.Vector3(2, 4, 8);
+    const out = new godot.Vector3();
+    const same = (x, y) => x.x === y.x && x.y === y.y && x.z === y.z;
+    let ok = godot.Vector3.add(out, a, b) === out && same(out, a + b);
+    ok = ok && godot.Vector3.subtract(out, a, b) === out && same(out, a - b);
+    ok = ok && godot.Vector3.multiply(out, a, b) === out && same(out, a * b);
+    ok = ok && godot.Vector3.divide(out, a, b) === out && same(out, a / b);
+    // The result may be written into an operand
+    const c = new godot.Vector3(1, 2, 3);
+    ok = ok && godot.Vector3.add(c, c, c) === c && same(c, new godot.Vector3(2, 4, 6));
+    ok = ok && godot.Vector3.subtract(c, b, c) === c && same(c, new godot.Vector3(0, 0, 2));
+    const i = new godot.Vector2i(7, 9);
+    ok = ok && godot.Vector2i.divide(i, i, new godot.Vector2i(2, 3)) === i && i.x === 3 && i.y === 3;
+    try {
+      godot.Vector2i.divide(i, i, new godot.Vector2i(0, 1));
+      ok = false;
+    } catch (e) {
+      ok = ok && e instanceof RangeError && i.x === 3;
+    }
+    try {
+      i.divide_assign(new godot.Vector2i(1, 0));
+      ok = false;
+    } catch (e) {
+      ok = ok && e instanceof RangeError && i.y === 3;
+    }
+    return ok;
+  },
+  "builtin",
+);
+
+test(
+  "Transform xform_into and xform_inv_into",
+  () => {
+    const t3 = new godot.Transform3D(new godot.Basis(), new godot.Vector3(1, 2, 3));
+    const v3 = new godot.Vector3(1, 1, 1);
+    const out3 = new godot.Vector3();
+    let ok = t3.xform_into(out3, v3) === out3 && out3.x === 2 && out3.y === 3 && out3.z === 4;
+    ok = ok && t3.xform_inv_into(out3, out3) === out3 && out3.x === 1 && out3.y === 1 && out3.z === 1;
+    ok = ok && t3.xform_into(v3, v3) === v3 && v3.z === 4;
+
+    const t2 = new godot.Transform2D(0, new godot.Vector2(5, 6));
+    const v2 = new godot.Vector2(1, 2);
+    const out2 = new godot.Vector2();
+    ok = ok && t2.xform_into(out2, v2) === out2 && out2.x === 6 && out2.y === 8;
+    ok = ok && t2.xform_inv_into(out2, out2) === out2 && out2.x === 1 && out2.y === 2;
+    return ok;
+  },
+  "builtin",
+);
+
+test(
+  "Quaternion multiply",
+  () => {
+    const q = new godot.Quaternion(new godot.Vector3(0, 1, 0), Math.PI / 2);
+    const product = q * q;
+    const out = new godot.Quaternion();
+    const close = (x, y) => Math.abs(x - y) < 1e-5;
+    const same = (a, b) => close(a.x, b.x) && close(a.y, b.y) && close(a.z, b.z) && close(a.w, b.w);
+    let ok = close(product.y, 1) && close(product.w, 0);
+    ok = ok && godot.Quaternion.multiply(out, q, q) === out && same(out, product);
+    const r = new godot.Quaternion(q);
+    ok = ok && r.multiply_assign(q) === r && same(r, product);
+    return ok;
+  },
+  "builtin",
+);
+
+test(
+  "Operators of the builtin types",
+  () => {
+    const a = new godot.Vector2(1, 2);
+    const b = new godot.Vector2(3, 5);
+    const same = (x, y) => x.x === y.x && x.y === y.y;
+    let ok = same(a + b, new godot.Vector2(4, 7)) && same(b - a, new godot.Vector2(2, 3));
+    ok = ok && same(a * b, new godot.Vector2(3, 10)) && same(b / new godot.Vector2(2, 4), new godot.Vector2(1.5, 1.25));
+    ok = ok && same(a * 2, new godot.Vector2(2, 4)) && same(2 * a, new godot.Vector2(2, 4)) && same(b / 2, new godot.Vector2(1.5, 2.5));
+    ok = ok && same(-a, new godot.Vector2(-1, -2));
+    ok = ok && a == new godot.Vector2(1, 2) && a != b && !(a == b);
+    // > and <= are derived from <
+    ok = ok && a < b && b > a && a <= new godot.Vector2(1, 2) && b >= a && !(b < a);
+
+    const v = new godot.Vector3(1, 2, 3);
+    const w = -v + new godot.Vector3(2, 4, 8);
+    ok = ok && w.x === 1 && w.y === 2 && w.z === 5 && v < w && w == new godot.Vector3(1, 2, 5);
+    const q = -new godot.Quaternion(0, 1, 0, 0);
+    ok = ok && q.x === 0 && q.y === -1;
+    const c = new godot.Color(0.5, 0.25, 0, 1) + new godot.Color(0.25, 0.25, 0.5, 0);
+    ok = ok && c == new godot.Color(0.75, 0.5, 0.5, 1) && new godot.Color(0, 0, 0, 1) < c;
+
+    // ~ has no overload, it throws instead of aborting
+    try {
+      ~a;
+      ok = false;
+    } catch (e) {
+      ok = ok && e instanceof TypeError;
+    }
+    return ok;
+  },
+  "builtin",
+);
+
+test(
+  "Array methods on the collection proxies",
+  () => {
+    const same = (a, values) => a.length === values.length && values.every((v, i) => a[i] === v);
+    const array = new godot.ArrayProxy();
+    let ok = array.push(1, 2, 3, 4) === 4 && same(array, [1, 2, 3, 4]);
+    ok = ok && array.pop() === 4 && array.shift() === 1 && same(array, [2, 3]);
+    ok = ok && same(array.splice(0, 1, "a", "b", "c"), [2]) && same(array, ["a", "b", "c", 3]);
+    ok = ok && same(array.splice(1, 2), ["b", "c"]) && same(array, ["a", 3]);
+    array.length = 4;
+    ok = ok && same(array, ["a", 3, null, null]);
+    array.length = 1;
+    ok = ok && same(array, ["a"]);
+    // Only the last element can be deleted, the others would leave a hole
+    array.push("b");
+    ok = ok && !Reflect.deleteProperty(array, 0) && Reflect.deleteProperty(array, 1) && same(array, ["a"]);
+    // The engine reads the same array
+    const res = new godot.Resource();
+    res.set_meta("array", array);
+    array.push("c");
+    ok = ok && Array.from(res.get_meta("array")).join() === "a,c";
+
+    // A dictionary is an array-like object with a length key
+    const dict = new godot.DictionaryProxy();
+    ok = ok && Array.prototype.push.call(dict, "x", "y", "z") === 3 && dict.length === 3 && dict[0] === "x";
+    ok = ok && Array.prototype.pop.call(dict) === "z" && !(2 in dict) && dict.length === 2;
+    ok = ok && Array.prototype.shift.call(dict) === "x" && dict[0] === "y" && !(1 in dict) && dict.length === 1;
+    ok = ok && same(Array.prototype.splice.call(dict, 0, 1, "a", "b"), ["y"]) && dict[0] === "a" && dict[1] === "b";
+    dict.length = 0;
+    ok = ok && dict.length === 0 && Object.keys(dict).sort().join() === "0,1,length";
+    res.set_meta("dict", dict);
+    ok = ok && res.get_meta("dict")[1] === "b";
+    return ok;
+  },
+  "core",
+);
+
 // --------------------------- Unit Test Implementation ------------------------
 
 /**
@@ -4,18 +4,1198 @@
 
 #include "../src/language/javascript_language.h"
 #include "../src/tests/test_manager.h"
+#include "../thirdparty/quickjs/quickjs_task_pool.h"
+#ifdef QUICKJS_WITH_DEBUGGER
+#include "../thirdparty/quickjs/quickjs_debugger.h"
+#endif
 
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/io/resource_loader.h"
+#include "core/os/os.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
 #include "tests/test_macros.h"
 
 namespace JavaScriptTests {
 
+static void init_language() {
+	static bool initialized = false;
+	if (!initialized) {
+		JavaScriptLanguage::get_singleton()->init();
+		initialized = true;
+	}
+}
+
+static Error execute(const String &p_code) {
+	init_language();
+	return JavaScriptLanguage::get_singleton()->execute_file(p_code);
+}
+
+// Runs the frames of the main context until `p_code` stops throwing, for the results sent by other threads
+static Error execute_until(const String &p_code, uint64_t p_timeout_msec = 5000) {
+	const uint64_t deadline = OS::get_singleton()->get_ticks_msec() + p_timeout_msec;
+	ERR_PRINT_OFF;
+	Error err = execute(p_code);
+	while (err != OK && OS::get_singleton()->get_ticks_msec() < deadline) {
+		JavaScriptLanguage::get_singleton()->frame();
+		OS::get_singleton()->delay_usec(1000);
+		err = execute(p_code);
+	}
+	ERR_PRINT_ON;
+	if (err != OK) {
+		// Once more to print why it failed
+		err = execute(p_code);
+	}
+	return err;
+}
+
+// Writes a script loaded by a worker and returns its path
+static String write_script(const String &p_name, const String &p_code) {
+	const String dir = OS::get_singleton()->get_cache_path().path_join("godot_javascript_tests");
+	DirAccess::make_dir_recursive_absolute(dir);
+	const String path = dir.path_join(p_name);
+	Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+	ERR_FAIL_COND_V(file.is_null(), String());
+	file->store_string(p_code);
+	return path;
+}
+
+// `p_path` as a string literal
+static String js_path(const String &p_path) {
+	return "'" + p_path.c_escape() + "'";
+}
+
+// Module of the functions run by the task pool tests, the runners cache it so it is only written once
+static String tasks_module() {
+	static String path;
+	if (path.is_empty()) {
+		path = write_script("tasks.js", R"(
+export function square(x) { return x * x; }
+export function engine_object() { return new godot.RefCounted(); }
+// Blocks until the pool interrupts it, after setting `state[1]` to 1
+export function block(index, data) {
+	const state = new Int32Array(data);
+	Atomics.store(state, 1, 1);
+	Atomics.notify(state, 1);
+	Atomics.wait(state, 0, 0);
+}
+// Stores an object of the runner in the metadata of `holder`, an object of the main context
+export function stash(holder) {
+	holder.call('set_meta', 'made', new godot.Object());
+	return 0;
+}
+)");
+	}
+	return path;
+}
+
+static Error check_task_pool_map() {
+	const String code = R"((function () {
+	globalThis.task_squares = undefined;
+	godot.parallel.map([1, 2, 3, 4, 5], TASKS + '#square').then((r) => { globalThis.task_squares = r; }, (e) => { globalThis.task_squares = e; });
+})();)";
+	Error err = execute(code.replace("TASKS", js_path(tasks_module())));
+	if (err == OK) {
+		err = execute_until(R"(if (!Array.isArray(globalThis.task_squares) || globalThis.task_squares.join() !== '1,4,9,16,25') throw new Error('unexpected squares ' + globalThis.task_squares);)");
+	}
+	return err;
+}
+
 TEST_CASE("[JavaScript] Test all") {
-	JavaScriptLanguage::get_singleton()->init();
+	init_language();
 	const String code = TestManager::UNIT_TEST;
 	Error err = JavaScriptLanguage::get_singleton()->execute_file(code);
 	CHECK(err == OK);
 }
 
+TEST_CASE("[JavaScript] Transfer an ArrayBuffer to a worker") {
+	const String worker = write_script("echo_buffer.mjs", "onmessage = function (buffer) { postMessage(buffer, [buffer]); };");
+	const String code = R"((function () {
+	const buffer = new ArrayBuffer(16);
+	new Uint8Array(buffer)[3] = 42;
+	const worker = new Worker(WORKER_PATH);
+	worker.onmessage = (echo) => { globalThis.transfer_echo = echo; };
+	worker.postMessage(buffer, [buffer]);
+	if (buffer.byteLength !== 0) throw new Error('the sent buffer is not detached');
+	let detached = false;
+	try {
+		new Uint8Array(buffer);
+	} catch (e) {
+		detached = e instanceof TypeError;
+	}
+	if (!detached) throw new Error('the sent buffer can still be read');
+	globalThis.transfer_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", "'" + worker.c_escape() + "'")) == OK);
+	CHECK(execute_until(R"((function () {
+	const echo = globalThis.transfer_echo;
+	if (!(echo instanceof ArrayBuffer) || echo.byteLength !== 16) throw new Error('no buffer received');
+	if (new Uint8Array(echo)[3] !== 42) throw new Error('unexpected content');
+	globalThis.transfer_worker.terminate();
+})();)") == OK);
+}
+
+TEST_CASE("[JavaScript] Map on the task pool") {
+	CHECK(check_task_pool_map() == OK);
+
+	const String code = R"((function () {
+	godot.parallel.map([0], TASKS + '#engine_object').then((r) => { globalThis.task_object = r; }, (e) => { globalThis.task_object = e; });
+})();)";
+	CHECK(execute(code.replace("TASKS", js_path(tasks_module()))) == OK);
+	CHECK(execute_until(R"(if (!(globalThis.task_object instanceof Error)) throw new Error('an engine object was returned by a task');)") == OK);
+}
+
+TEST_CASE("[JavaScript] Cancel the tasks of a terminated worker") {
+	String worker = R"(
+const state = new Int32Array(new SharedArrayBuffer(8));
+godot.parallel.parallelFor(1, TASKS + '#block', state.buffer);
+Atomics.wait(state, 1, 0, 5000);
+postMessage(Atomics.load(state, 1));
+)";
+	worker = write_script("cancel_worker.mjs", worker.replace("TASKS", js_path(tasks_module())));
+	const String code = R"((function () {
+	const worker = new Worker(WORKER_PATH);
+	worker.onmessage = (blocked) => { globalThis.cancel_blocked = blocked; };
+	globalThis.cancel_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", js_path(worker))) == OK);
+	CHECK(execute_until("if (globalThis.cancel_blocked !== 1) throw new Error('the task is not running');") == OK);
+	// Returns once the blocked task is interrupted
+	CHECK(execute("globalThis.cancel_worker.terminate();") == OK);
+	// The runner of the cancelled task takes new tasks
+	CHECK(check_task_pool_map() == OK);
+}
+
+TEST_CASE("[JavaScript] Shut the task pool down with a blocked task") {
+	const String code = R"((function () {
+	const state = new Int32Array(new SharedArrayBuffer(8));
+	globalThis.shutdown_state = state;
+	godot.parallel.parallelFor(1, TASKS + '#block', state.buffer).then(() => { globalThis.shutdown_result = 'resolved'; }, (e) => { globalThis.shutdown_result = e; });
+})();)";
+	CHECK(execute(code.replace("TASKS", js_path(tasks_module()))) == OK);
+	CHECK(execute_until("if (Atomics.load(globalThis.shutdown_state, 1) !== 1) throw new Error('the task is not running');") == OK);
+	QuickJSTaskPool::finalize();
+	CHECK(execute_until("if (!(globalThis.shutdown_result instanceof Error)) throw new Error('the batch was not rejected');") == OK);
+	// The pool is created again on the next call
+	CHECK(check_task_pool_map() == OK);
+}
+
+TEST_CASE("[JavaScript] Proxy commands sent to a task runner") {
+	const String code = R"((function () {
+	globalThis.proxy_holder = new godot.Object();
+	godot.parallel.map([globalThis.proxy_holder], TASKS + '#stash');
+})();)";
+	CHECK(execute(code.replace("TASKS", js_path(tasks_module()))) == OK);
+	CHECK(execute_until("if (!globalThis.proxy_holder.has_meta('made')) throw new Error('the runner did not set the metadata');") == OK);
+	CHECK(execute(R"((function () {
+	const made = globalThis.proxy_holder.get_meta('made');
+	if (!(made instanceof godot.ObjectProxy)) throw new Error('the object of the runner is not a proxy');
+	// Runs in the idle runner
+	made.call('get_class').then((name) => {
+		globalThis.proxy_class = name;
+		return made.call('free');
+	}).then(() => { globalThis.proxy_freed = true; });
+})();)") == OK);
+	CHECK(execute_until("if (globalThis.proxy_class !== 'Object' || !globalThis.proxy_freed) throw new Error('the runner did not answer');") == OK);
+	CHECK(execute("globalThis.proxy_holder.free();") == OK);
+}
+
+TEST_CASE("[JavaScript] Adopt the objects of nested arrays in a worker") {
+	const String worker = write_script("adopt_nested.mjs", R"(
+onmessage = function (id) {
+	const [first, [second]] = godot.adopt_value(id);
+	// Abandoned objects are bound to the context adopting them, not reached through a proxy
+	const owned = [first, second].every((o) => !(o instanceof godot.ObjectProxy) && o.get_class() === 'Object');
+	first.free();
+	second.free();
+	postMessage(owned);
+};
+)");
+	const String code = R"((function () {
+	const worker = new Worker(WORKER_PATH);
+	worker.onmessage = (owned) => { globalThis.adopt_owned = owned; };
+	worker.postMessage(godot.abandon_value([new godot.Object(), [new godot.Object()]]));
+	globalThis.adopt_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", js_path(worker))) == OK);
+	CHECK(execute_until("if (globalThis.adopt_owned !== true) throw new Error('the nested objects were not adopted');") == OK);
+	CHECK(execute("globalThis.adopt_worker.terminate();") == OK);
+}
+
+TEST_CASE("[JavaScript] Free the objects of expired abandoned values") {
+	init_language();
+	Object *first = memnew(Object);
+	Object *second = memnew(Object);
+	const ObjectID first_id = first->get_instance_id();
+	const ObjectID second_id = second->get_instance_id();
+	Array nested;
+	nested.push_back(second);
+	Array objects;
+	objects.push_back(first);
+	objects.push_back(nested);
+	Engine::get_singleton()->set_meta("abandoned_objects", objects);
+	CHECK(execute("godot.abandon_value(godot.Engine.get_meta('abandoned_objects'));") == OK);
+	Engine::get_singleton()->remove_meta("abandoned_objects");
+
+	QuickJSTransferDepot &depot = QuickJSBinder::get_transfer_depot();
+	depot.set_timeout(1);
+	const uint64_t deadline = OS::get_singleton()->get_ticks_msec() + 5000;
+	ERR_PRINT_OFF;
+	while ((ObjectDB::get_instance(first_id) || ObjectDB::get_instance(second_id)) && OS::get_singleton()->get_ticks_msec() < deadline) {
+		JavaScriptLanguage::get_singleton()->frame();
+		OS::get_singleton()->delay_usec(1000);
+	}
+	ERR_PRINT_ON;
+	depot.set_timeout(uint64_t(GLOBAL_GET("JavaScript/worker/transfer_timeout")) * 1000);
+	CHECK(ObjectDB::get_instance(first_id) == nullptr);
+	CHECK(ObjectDB::get_instance(second_id) == nullptr);
+}
+
+TEST_CASE("[JavaScript] Compute worker profile") {
+	const String worker = write_script("compute_worker.mjs", R"(
+const missing = [];
+const check = (name, ok) => { if (!ok) missing.push(name); };
+check('builtin types', new godot.Vector2(1, 2).y === 2);
+check('number constants', godot.PI === Math.PI);
+check('listed class', typeof godot.Node === 'function');
+check('base classes', typeof godot.Object === 'function' && typeof godot.RefCounted === 'function');
+check('no other classes', godot.CanvasItem === undefined && godot.Resource === undefined);
+check('no global constants', godot.OK === undefined && godot.Error === undefined);
+const node = new godot.Node();
+check('listed class instance', node instanceof godot.Object);
+node.free();
+postMessage(missing.join());
+)");
+	const String code = R"((function () {
+	let rejected = false;
+	try {
+		new Worker(WORKER_PATH, { profile: 'compute', classes: ['NotAnEngineClass'] });
+	} catch (e) {
+		rejected = e instanceof TypeError;
+	}
+	if (!rejected) throw new Error('an unknown class was accepted');
+	const worker = new Worker(WORKER_PATH, { profile: 'compute', classes: ['Node'] });
+	worker.onmessage = (missing) => { globalThis.compute_missing = missing; };
+	globalThis.compute_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", js_path(worker))) == OK);
+	CHECK(execute_until("if (globalThis.compute_missing !== '') throw new Error('unexpected compute context: ' + globalThis.compute_missing);") == OK);
+	CHECK(execute("globalThis.compute_worker.terminate();") == OK);
+}
+
+static void store_thread_binder(void *p_binder) {
+	*static_cast<JavaScriptBinder **>(p_binder) = JavaScriptLanguage::get_current_thread_binder();
+}
+
+TEST_CASE("[JavaScript] Binder of the calling thread") {
+	init_language();
+	JavaScriptLanguage *language = JavaScriptLanguage::get_singleton();
+	CHECK(language->get_current_thread_binder() == language->get_main_binder());
+	CHECK(language->get_current_thread_binder() == language->get_thread_binder(Thread::get_caller_id()));
+
+	// Threads without a context have no binder
+	JavaScriptBinder *binder = language->get_main_binder();
+	Thread thread;
+	thread.start(store_thread_binder, &binder);
+	thread.wait_to_finish();
+	CHECK(binder == nullptr);
+
+	// The references of a worker are counted by the binder of its thread
+	const String worker = write_script("reference_worker.mjs", R"(
+const ref = new godot.RefCounted();
+const count = ref.get_reference_count();
+ref.reference();
+ref.unreference();
+postMessage(ref.get_reference_count() === count);
+)");
+	const String code = R"((function () {
+	const worker = new Worker(WORKER_PATH);
+	worker.onmessage = (counted) => { globalThis.reference_counted = counted; };
+	globalThis.reference_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", js_path(worker))) == OK);
+	CHECK(execute_until("if (globalThis.reference_counted !== true) throw new Error('the worker references were not counted');") == OK);
+	CHECK(execute("globalThis.reference_worker.terminate();") == OK);
+	CHECK(language->get_current_thread_binder() == language->get_main_binder());
+}
+
+TEST_CASE("[JavaScript] Object proxies of a worker") {
+	const String worker = write_script("proxy_owner.mjs", R"(
+globalThis.resource = new godot.Resource();
+resource.resource_name = 'worker';
+postMessage(resource);
+)");
+	const String code = R"((function () {
+	const worker = new Worker(WORKER_PATH);
+	worker.onmessage = (proxy) => {
+		if (!(proxy instanceof godot.ObjectProxy)) throw new Error('the object of the worker is not a proxy');
+		globalThis.owner_proxy = proxy;
+		proxy.get('resource_name').then((name) => {
+			globalThis.proxy_name = name;
+			return proxy.set('resource_name', 'main');
+		}).then(() => proxy.call('get_name')).then((name) => { globalThis.proxy_renamed = name; });
+	};
+	globalThis.owner_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", js_path(worker))) == OK);
+	CHECK(execute_until("if (globalThis.proxy_name !== 'worker' || globalThis.proxy_renamed !== 'main') throw new Error('unexpected proxy results');") == OK);
+
+	// Commands sent once the owner is gone are rejected
+	CHECK(execute(R"((function () {
+	globalThis.owner_worker.terminate();
+	globalThis.owner_proxy.call('get_name').then(() => { globalThis.proxy_orphan = 'resolved'; }, (e) => { globalThis.proxy_orphan = e; });
+})();)") == OK);
+	CHECK(execute_until("if (!(globalThis.proxy_orphan instanceof Error)) throw new Error('a call to a destroyed context was not rejected');") == OK);
+}
+
+TEST_CASE("[SceneTree][JavaScript] Batch process hooks") {
+	init_language();
+	const String path = write_script("batch_node.mjs", R"(
+export default class BatchNode extends godot.Node {
+	static _process_batch(instances, delta) {
+		globalThis.batch_calls = (globalThis.batch_calls || 0) + 1;
+		globalThis.batch_size = instances.length;
+	}
+	// Replaced by the hook of the class
+	_process(delta) {
+		globalThis.batch_instance_called = true;
+	}
+}
+)");
+	ERR_PRINT_OFF;
+	Ref<Script> script = ResourceLoader::load(path);
+	ERR_PRINT_ON;
+	REQUIRE(script.is_valid());
+
+	Node *first = memnew(Node);
+	Node *second = memnew(Node);
+	first->set_script(script);
+	second->set_script(script);
+	SceneTree::get_singleton()->get_root()->add_child(first);
+	SceneTree::get_singleton()->get_root()->add_child(second);
+
+	// Both nodes are processed in the same frame, the hook runs once for both
+	SceneTree::get_singleton()->process(0.1);
+	CHECK(execute("if (globalThis.batch_calls !== 1 || globalThis.batch_size !== 2) throw new Error('unexpected batch ' + globalThis.batch_calls + ' ' + globalThis.batch_size);") == OK);
+	CHECK(execute("if (globalThis.batch_instance_called) throw new Error('the _process of an instance was called');") == OK);
+
+	memdelete(first);
+	memdelete(second);
+}
+
+// Instantiates the class of `p_path` on two objects, `p_check` gets them as `first` and `second`
+static Error check_script_instances(const String &p_path, const String &p_check) {
+	Ref<Script> script = ResourceLoader::load(p_path);
+	ERR_FAIL_COND_V(script.is_null(), ERR_CANT_OPEN);
+	Object *first = memnew(Object);
+	Object *second = memnew(Object);
+	first->set_script(script);
+	second->set_script(script);
+	Array objects;
+	objects.push_back(first);
+	objects.push_back(second);
+	Engine::get_singleton()->set_meta("script_instances", objects);
+	const String code = "(function () { const [first, second] = godot.Engine.get_meta('script_instances'); CHECK })();";
+	Error err = execute(code.replace("CHECK", p_check));
+	Engine::get_singleton()->remove_meta("script_instances");
+	memdelete(first);
+	memdelete(second);
+	return err;
+}
+
+TEST_CASE("[JavaScript] Script instances built from the class template") {
+	init_language();
+	const String check = R"(
+	if (Object.getPrototypeOf(first).constructor.name !== 'CLASS' || !(first instanceof godot.Object)) throw new Error('wrong prototype');
+	if (first.speed !== 5 || first.label !== 'text' || first.offset.y !== 2) throw new Error('wrong defaults');
+	// Defaults that are objects are not shared
+	if (first.offset === second.offset) throw new Error('shared builtin default');
+	first.speed = 6;
+	first.offset.x = 10;
+	if (second.speed !== 5 || second.offset.x !== 1) throw new Error('the instances share their state');
+	EXTRA
+)";
+	const String exports = R"(
+godot.register_property(CLASS, 'speed', 5);
+godot.register_property(CLASS, 'label', 'text');
+godot.register_property(CLASS, 'offset', new godot.Vector2(1, 2));
+)";
+	// Instances take the shape and the defaults of the template
+	const String templated = write_script("templated_object.mjs", "export default class TemplatedObject extends godot.Object {}" + exports.replace("CLASS", "TemplatedObject"));
+	CHECK(check_script_instances(templated, check.replace("CLASS", "TemplatedObject").replace("EXTRA", "if (Object.keys(first).join() !== Object.keys(second).join()) throw new Error('different shapes');")) == OK);
+
+	// A constructor adding class fields falls back to setting the properties one by one
+	const String fields = write_script("field_object.mjs", "export default class FieldObject extends godot.Object { extra = 3; }" + exports.replace("CLASS", "FieldObject"));
+	CHECK(check_script_instances(fields, check.replace("CLASS", "FieldObject").replace("EXTRA", "if (first.extra !== 3 || second.extra !== 3) throw new Error('missing class field');")) == OK);
+}
+
+TEST_CASE("[JavaScript] Reuse the instances of a pooled class") {
+	init_language();
+	const String path = write_script("pooled_object.mjs", R"(
+export default class PooledObject extends godot.Object {
+	constructor() {
+		super();
+		this.items = [];
+	}
+	_reset() {
+		this.items = [];
+	}
+}
+godot.register_property(PooledObject, 'speed', 5);
+godot.set_script_pooled(PooledObject, 4);
+)");
+	Ref<Script> script = ResourceLoader::load(path);
+	REQUIRE(script.is_valid());
+
+	Object *first = memnew(Object);
+	first->set_script(script);
+	Engine::get_singleton()->set_meta("pooled_object", first);
+	CHECK(execute(R"((function () {
+	const first = godot.Engine.get_meta('pooled_object');
+	first.speed = 6;
+	first.items.push(1);
+	first.tag = 'first';
+})();)") == OK);
+	Engine::get_singleton()->remove_meta("pooled_object");
+	memdelete(first);
+
+	Object *second = memnew(Object);
+	second->set_script(script);
+	Engine::get_singleton()->set_meta("pooled_object", second);
+	CHECK(execute(R"((function () {
+	const second = godot.Engine.get_meta('pooled_object');
+	if (godot.get_script_pool_info(second.constructor).hits !== 1) throw new Error('the instance was not reused');
+	if (second.speed !== 5) throw new Error('the exported property was not restored');
+	if (second.items.length !== 0 || second.tag !== undefined) throw new Error('the fields of the freed object were kept');
+})();)") == OK);
+	Engine::get_singleton()->remove_meta("pooled_object");
+	memdelete(second);
+}
+
+TEST_CASE("[JavaScript] Flatten the prototypes of the engine classes") {
+	init_language();
+	// Read by the worker context when it starts
+	const String worker = write_script("flat_worker.mjs", R"(
+const own = (proto, name) => Object.getOwnPropertyDescriptor(proto, name);
+const missing = [];
+const check = (name, ok) => { if (!ok) missing.push(name); };
+check('inherited method', own(godot.Node2D.prototype, 'get_class')?.value === godot.Object.prototype.get_class);
+check('inherited accessor', own(godot.Node2D.prototype, 'visible')?.get === own(godot.CanvasItem.prototype, 'visible').get);
+check('chain', Object.getPrototypeOf(godot.Node2D.prototype) === godot.Node.prototype);
+const node = new godot.Node2D();
+check('call', node.get_class() === 'Node2D' && node instanceof godot.CanvasItem);
+node.free();
+postMessage(missing.join());
+)");
+	ProjectSettings::get_singleton()->set_setting("JavaScript/bindings/flatten_prototypes", true);
+	const String code = R"((function () {
+	const worker = new Worker(WORKER_PATH);
+	worker.onmessage = (missing) => { globalThis.flat_missing = missing; };
+	globalThis.flat_worker = worker;
+})();)";
+	CHECK(execute(code.replace("WORKER_PATH", js_path(worker))) == OK);
+	CHECK(execute_until("if (globalThis.flat_missing !== '') throw new Error('unexpected flat prototypes: ' + globalThis.flat_missing);") == OK);
+	ProjectSettings::get_singleton()->set_setting("JavaScript/bindings/flatten_prototypes", false);
+	CHECK(execute("globalThis.flat_worker.terminate();") == OK);
+
+	// The main context was not flattened
+	CHECK(execute("if (Object.getOwnPropertyDescriptor(godot.Node2D.prototype, 'get_class')) throw new Error('the main context was flattened');") == OK);
+}
+
+// Property accesses whose cached lookup no longer holds, `javascript_inline_cache` must not change their results
+TEST_CASE("[JavaScript] Inline cache invalidation") {
+	const String code = R"((function () {
+	const check = (name, ok) => { if (!ok) throw new Error('inline cache: ' + name); };
+	// Each site is warmed on the same shapes before the change
+	const warm = (f, ...args) => { let r; for (let i = 0; i < 64; i++) r = f(...args); return r; };
+	const getX = (o) => o.x;
+	const setX = (o, v) => { o.x = v; };
+	const strictSetX = (o, v) => { 'use strict'; o.x = v; };
+
+	// Prototype changes after warm-up
+	const proto = { x: 1 };
+	const child = Object.create(proto);
+	check('prototype property', warm(getX, child) === 1);
+	proto.x = 2;
+	check('prototype property changed', getX(child) === 2);
+	Object.setPrototypeOf(child, { x: 3 });
+	check('prototype replaced', getX(child) === 3);
+	child.x = 4;
+	check('own property shadowing the prototype', getX(child) === 4);
+	const grand = Object.create(Object.create({ x: 5 }));
+	warm(getX, grand);
+	Object.getPrototypeOf(grand).x = 6;
+	check('property added in the middle of the chain', getX(grand) === 6);
+
+	// Accessors installed on warmed shapes
+	const a = { x: 1 };
+	const b = { x: 2 };
+	warm(getX, a);
+	warm(setX, a, 1);
+	let stored;
+	Object.defineProperty(a, 'x', { get() { return 10; }, set(v) { stored = v; }, configurable: true });
+	check('getter on a warmed object', getX(a) === 10);
+	setX(a, 11);
+	check('setter on a warmed object', stored === 11 && getX(b) === 2);
+	const base = {};
+	const derived = Object.create(base);
+	check('missing property', warm(getX, derived) === undefined);
+	Object.defineProperty(base, 'x', { get() { return 7; } });
+	check('getter added to the prototype', getX(derived) === 7);
+
+	// Frozen objects
+	const frozen = { x: 1 };
+	warm(setX, frozen, 1);
+	warm(strictSetX, frozen, 1);
+	Object.freeze(frozen);
+	setX(frozen, 2);
+	check('write to a frozen object', frozen.x === 1);
+	let threw = false;
+	try {
+		strictSetX(frozen, 3);
+	} catch (e) {
+		threw = e instanceof TypeError;
+	}
+	check('strict write to a frozen object', threw && frozen.x === 1);
+
+	// Deleted properties and dictionary mode objects
+	const deleted = { x: 1, y: 2 };
+	warm(getX, deleted);
+	warm(setX, deleted, 1);
+	delete deleted.x;
+	check('deleted property', getX(deleted) === undefined);
+	setX(deleted, 3);
+	check('property added again', getX(deleted) === 3 && Object.keys(deleted).join() === 'y,x');
+	const dict = {};
+	for (let i = 0; i < 1000; i++) dict['p' + i] = i;
+	dict.x = 'dict';
+	check('dictionary mode object', warm(getX, dict) === 'dict');
+	delete dict.p10;
+	dict.x = 'changed';
+	check('dictionary mode object changed', getX(dict) === 'changed');
+	delete dict.x;
+	check('dictionary mode property deleted', getX(dict) === undefined);
+
+	// Megamorphic site, more shapes than the cache keeps
+	const shapes = [];
+	for (let i = 0; i < 32; i++) {
+		const o = {};
+		o['k' + i] = i;
+		o.x = i;
+		shapes.push(o);
+	}
+	let sum = 0;
+	for (let r = 0; r < 8; r++) for (const o of shapes) sum += getX(o);
+	check('megamorphic reads', sum === 8 * 31 * 32 / 2);
+	for (const o of shapes) setX(o, 1);
+	check('megamorphic writes', shapes.every((o) => o.x === 1));
+	shapes[3].x = 100;
+	check('megamorphic after a change', getX(shapes[3]) === 100);
+
+	// with scopes
+	const scope = { x: 1 };
+	const x = 'outer';
+	const inScope = new Function('scope', 'x', 'with (scope) { return x; }');
+	check('with scope', warm(inScope, scope, x) === 1);
+	scope.x = 2;
+	check('with scope changed', inScope(scope, x) === 2);
+	delete scope.x;
+	check('with scope property deleted', inScope(scope, x) === 'outer');
+
+	// Proxies are never cached
+	const target = { x: 1 };
+	let traps = 0;
+	const proxy = new Proxy(target, { get(t, k) { traps++; return k === 'x' ? 42 : t[k]; }, set(t, k, v) { traps++; t[k] = v + 1; return true; } });
+	warm(getX, target);
+	warm(setX, target, 1);
+	check('proxy read', getX(proxy) === 42 && getX(proxy) === 42 && traps === 2);
+	setX(proxy, 5);
+	check('proxy write', traps === 3 && getX(target) === 6);
+})();)";
+	CHECK(execute(code) == OK);
+}
+
+// A runtime without the engine bindings, the objects returned by `track()` are counted once freed
+static JSClassID tracked_class_id = 0;
+static int tracked_made = 0;
+static int tracked_finalized = 0;
+
+static void tracked_finalizer(JSRuntime *rt, JSValue val) {
+	tracked_finalized++;
+}
+
+static JSValue js_track(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	tracked_made++;
+	return JS_NewObjectClass(ctx, tracked_class_id);
+}
+
+static JSContext *new_gc_context(int p_nursery_size) {
+	if (tracked_class_id == 0) {
+		JS_NewClassID(&tracked_class_id);
+	}
+	JSRuntime *rt = JS_NewRuntime();
+	JSClassDef tracked_class = {};
+	tracked_class.class_name = "Tracked";
+	tracked_class.finalizer = tracked_finalizer;
+	JS_NewClass(rt, tracked_class_id, &tracked_class);
+	JS_SetGCNurserySize(rt, p_nursery_size);
+	JS_SetGCIncremental(rt, true);
+	JSContext *ctx = JS_NewContext(rt);
+	JSValue global = JS_GetGlobalObject(ctx);
+	JS_SetPropertyStr(ctx, global, "track", JS_NewCFunction(ctx, js_track, "track", 0));
+	JS_FreeValue(ctx, global);
+	tracked_made = 0;
+	tracked_finalized = 0;
+	return ctx;
+}
+
+static void free_gc_context(JSContext *ctx) {
+	JSRuntime *rt = JS_GetRuntime(ctx);
+	JS_FreeContext(ctx);
+	JS_FreeRuntime(rt);
+}
+
+// Runs `p_code` and the jobs it queued
+static bool eval_gc(JSContext *ctx, const char *p_code) {
+	JSValue ret = JS_Eval(ctx, p_code, strlen(p_code), "<gc>", JS_EVAL_TYPE_GLOBAL);
+	const bool ok = !JS_IsException(ret);
+	if (!ok) {
+		JSValue e = JS_GetException(ctx);
+		const char *message = JS_ToCString(ctx, e);
+		ERR_PRINT(message);
+		JS_FreeCString(ctx, message);
+		JS_FreeValue(ctx, e);
+	}
+	JS_FreeValue(ctx, ret);
+	JSContext *job_ctx;
+	while (JS_ExecutePendingJob(JS_GetRuntime(ctx), &job_ctx) > 0) {
+	}
+	return ok;
+}
+
+// Collects the cycles one object visit at a time, running `p_mutation` in `ctx` between two visits.
+// Without the incremental collection, they are collected at once by JS_RunGC().
+static bool collect_cycles(JSRuntime *rt, JSContext *ctx = nullptr, const char *p_mutation = nullptr) {
+	if (!JS_IsGCIncremental(rt)) {
+		JS_RunGC(rt);
+		return true;
+	}
+	// The objects created since the start of a cycle in progress are left out of it
+	while (!JS_RunGCStep(rt, INT32_MAX)) {
+	}
+	JS_RequestGCStep(rt);
+	bool ok = true;
+	while (!JS_RunGCStep(rt, 1)) {
+		if (p_mutation) {
+			ok = eval_gc(ctx, p_mutation) && ok;
+		}
+	}
+	return ok;
+}
+
+static void check_collected_cycles(int p_nursery_size) {
+	JSContext *ctx = new_gc_context(p_nursery_size);
+	CHECK(eval_gc(ctx, R"(globalThis.keep = {};
+(function () {
+	// Cycles only referenced by each other, each one holds a tracked object
+	{ const o = { t: track() }; o.f = () => o; }
+	{ let it; function* g() { const t = track(); yield it; } it = g(); it.next(); }
+	{ let p; async function f() { const t = track(); const never = new Promise(() => {}); await never; return p; } p = f(); }
+	{ const m = new Map(); m.set({ t: track() }, m); }
+	{ const wm = new WeakMap(); const k = {}; wm.set(k, { k, wm, t: track() }); }
+	// The same cycles reachable from `keep`
+	{ const o = { t: track(), n: 1 }; o.f = () => o; keep.closure = o.f; }
+	{ let it; function* g() { const t = track(); const n = yield it; yield n + 1; } it = g(); it.next(); keep.generator = it; }
+	{ let p; async function f() { const t = track(); const v = await new Promise((r) => { keep.resolve = r; }); return p && v + 1; } p = f(); p.then((v) => { keep.resolved = v; }); }
+	{ const m = new Map(); const k = { t: track() }; m.set(k, m); keep.map = m; keep.mapKey = k; }
+	{ const wm = new WeakMap(); const k = {}; wm.set(k, { k, wm, t: track() }); keep.weakMap = wm; keep.weakKey = k; }
+	keep.a = {};
+	keep.b = { x: { t: track(), v: 42 } };
+})();)"));
+
+	// Moves a live object between an object already visited by the cycle and one which is not yet,
+	// and references old objects from new ones
+	CHECK(collect_cycles(JS_GetRuntime(ctx), ctx, R"(if (keep.b.x) { keep.a.x = keep.b.x; keep.b.x = undefined; } else { keep.b.x = keep.a.x; keep.a.x = undefined; }
+keep.fresh = { old: keep.mapKey, closure: keep.closure };)"));
+	CHECK(tracked_finalized == 5);
+	CHECK(eval_gc(ctx, R"(if (keep.closure().n !== 1) throw new Error('closure');
+if (keep.generator.next(1).value !== 2) throw new Error('generator');
+if (keep.map.get(keep.mapKey) !== keep.map) throw new Error('map');
+if (keep.weakMap.get(keep.weakKey).k !== keep.weakKey) throw new Error('weak map');
+if ((keep.a.x || keep.b.x).v !== 42) throw new Error('moved object');
+keep.resolve(41);)"));
+	CHECK(eval_gc(ctx, "if (keep.resolved !== 42) throw new Error('async function');"));
+	// The frame of the finished async function is released
+	CHECK(tracked_finalized == 6);
+
+	// The kept cycles are collected once dropped
+	CHECK(eval_gc(ctx, "globalThis.keep = undefined;"));
+	CHECK(collect_cycles(JS_GetRuntime(ctx)));
+	CHECK(tracked_finalized == 11);
+	free_gc_context(ctx);
+}
+
+TEST_CASE("[JavaScript] Collect cycles") {
+	// Runs JS_RunGC() instead when the incremental collection is not built
+	check_collected_cycles(0);
+	check_collected_cycles(4096);
+}
+
+// The objects only referenced by the garbage of a nursery or incremental collection are freed with it
+static void check_orphans_of_cycles(int p_nursery_size) {
+	JSContext *ctx = new_gc_context(p_nursery_size);
+	JSRuntime *rt = JS_GetRuntime(ctx);
+	CHECK(eval_gc(ctx, "globalThis.olds = []; for (let i = 0; i < 52; i++) olds.push({ t: track() });"));
+	// The tracked objects are old, JS_RunGC() would free them as well
+	JS_RunGC(rt);
+	JS_SetGCThreshold(rt, SIZE_MAX);
+	CHECK(eval_gc(ctx, "for (const o of olds) { const a = {}; const b = { a }; a.b = b; a.old = o; } olds = null;"));
+	CHECK(tracked_finalized == 0);
+	if (p_nursery_size > 0) {
+		CHECK(eval_gc(ctx, vformat("for (let i = 0; i < %d; i++) { const x = {}; }", p_nursery_size).utf8().get_data()));
+		CHECK(tracked_finalized == 52);
+	} else if (JS_IsGCIncremental(rt)) {
+		CHECK(collect_cycles(rt));
+		CHECK(tracked_finalized == 52);
+	}
+	free_gc_context(ctx);
+}
+
+TEST_CASE("[JavaScript] Free the objects referenced by collected cycles") {
+	check_orphans_of_cycles(0);
+	check_orphans_of_cycles(4096);
+}
+
+// Short lived cycles, some of them kept and linked to each other for a while, with the incremental
+// steps run between the chunks. Meant to be run by a build with use_asan=yes use_ubsan=yes as well.
+static void check_gc_stress(int p_nursery_size) {
+	JSContext *ctx = new_gc_context(p_nursery_size);
+	JSRuntime *rt = JS_GetRuntime(ctx);
+	CHECK(eval_gc(ctx, "globalThis.keep = [];"));
+	const String chunk = R"({
+	let seed = SEED;
+	const r = (n) => { seed = (seed * 1103515245 + 12345) & 0x7fffffff; return seed % n; };
+	for (let i = 0; i < 10000; i++) {
+		const o = { t: r(10) === 0 ? track() : null, f: () => o };
+		o.self = o;
+		if (r(5) === 0) keep.push(o);
+		if (keep.length > 100) {
+			keep[r(keep.length)].other = keep[r(keep.length)];
+			keep.splice(r(keep.length), 1);
+		}
+	}
+	for (const o of keep) if (o.self !== o || o.f() !== o) throw new Error('a kept object was freed');
+})";
+	for (int i = 0; i < 20; i++) {
+		CHECK(eval_gc(ctx, chunk.replace("SEED", itos(i + 1)).utf8().get_data()));
+		JS_RunGCStep(rt, 5000);
+	}
+	CHECK(eval_gc(ctx, "globalThis.keep = undefined;"));
+	JS_RunGC(rt);
+	CHECK(tracked_made > 0);
+	CHECK(tracked_finalized == tracked_made);
+	free_gc_context(ctx);
+}
+
+TEST_CASE("[JavaScript] Garbage collection stress") {
+	check_gc_stress(0);
+	check_gc_stress(4096);
+}
+
+TEST_CASE("[JavaScript] Collect the cycles of bound engine objects") {
+	init_language();
+	CHECK(execute(R"((function () {
+	const ref = new godot.RefCounted();
+	ref.self = ref;
+	const res = new godot.Resource();
+	const holder = { res };
+	res.holder = () => holder;
+	const kept = new godot.RefCounted();
+	kept.self = kept;
+	// The reference held by the engine keeps the cycle alive
+	godot.Engine.set_meta('gc_kept', kept);
+	godot.Engine.set_meta('gc_ids', [ref.get_instance_id(), res.get_instance_id(), kept.get_instance_id()]);
+})();)") == OK);
+	const Array ids = Engine::get_singleton()->get_meta("gc_ids");
+	REQUIRE(ids.size() == 3);
+	QuickJSBinder *binder = static_cast<QuickJSBinder *>(JavaScriptLanguage::get_singleton()->get_main_binder());
+	CHECK(collect_cycles(binder->get_runtime()));
+	CHECK(ObjectDB::get_instance(ObjectID(uint64_t(ids[0]))) == nullptr);
+	CHECK(ObjectDB::get_instance(ObjectID(uint64_t(ids[1]))) == nullptr);
+	CHECK(ObjectDB::get_instance(ObjectID(uint64_t(ids[2]))) != nullptr);
+	CHECK(execute("if (godot.Engine.get_meta('gc_kept').self !== godot.Engine.get_meta('gc_kept')) throw new Error('the kept cycle was broken');") == OK);
+
+	Engine::get_singleton()->remove_meta("gc_kept");
+	Engine::get_singleton()->remove_meta("gc_ids");
+	CHECK(collect_cycles(binder->get_runtime()));
+	CHECK(ObjectDB::get_instance(ObjectID(uint64_t(ids[2]))) == nullptr);
+}
+
+// Converts `p_chars` to a JS string and back, the JS string must be the one built by String.fromCharCode()
+static void check_utf32_round_trip(JSContext *ctx, const Vector<char32_t> &p_chars) {
+	// Filled directly, String would replace the lone surrogates
+	String text;
+	text.resize(p_chars.size() + 1);
+	char32_t *dst = text.ptrw();
+	String units;
+	for (int i = 0; i < p_chars.size(); i++) {
+		const char32_t c = p_chars[i];
+		dst[i] = c;
+		if (c > 0xffff) {
+			units += itos(0xd800 + ((c - 0x10000) >> 10)) + "," + itos(0xdc00 + ((c - 0x10000) & 0x3ff)) + ",";
+		} else {
+			units += itos(c) + ",";
+		}
+	}
+	dst[p_chars.size()] = 0;
+	const String expected = "String.fromCharCode(" + units + ")";
+
+	JSValue value = QuickJSBinder::to_js_string(ctx, text);
+	REQUIRE(JS_IsString(value));
+	JSValue global = JS_GetGlobalObject(ctx);
+	JS_SetPropertyStr(ctx, global, "value", JS_DupValue(ctx, value));
+	JS_FreeValue(ctx, global);
+	CHECK(eval_gc(ctx, ("if (value !== " + expected + ") throw new Error('unexpected string of ' + value.length + ' code units');").utf8().get_data()));
+
+	CHECK(JS_GetStringUTF32(value, nullptr) == size_t(p_chars.size()));
+	CHECK(QuickJSBinder::js_to_string(ctx, value) == text);
+	JS_FreeValue(ctx, value);
+
+	// The strings built by the scripts are copied the same way
+	const CharString code = expected.utf8();
+	JSValue built = JS_Eval(ctx, code.get_data(), code.length(), "<utf32>", JS_EVAL_TYPE_GLOBAL);
+	REQUIRE(JS_IsString(built));
+	CHECK(QuickJSBinder::js_to_string(ctx, built) == text);
+	JS_FreeValue(ctx, built);
+}
+
+TEST_CASE("[JavaScript] Strings converted as UTF-32") {
+	JSRuntime *rt = JS_NewRuntime();
+	JSContext *ctx = JS_NewContext(rt);
+	const char32_t *ascii = U"abcdefghijklmnopqrstuvwxyz0123456789";
+
+	SUBCASE("ASCII around the 16 character blocks") {
+		for (int length : { 0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33 }) {
+			Vector<char32_t> chars;
+			for (int i = 0; i < length; i++) {
+				chars.push_back(ascii[i]);
+			}
+			check_utf32_round_trip(ctx, chars);
+		}
+	}
+
+	SUBCASE("Latin-1") {
+		check_utf32_round_trip(ctx, { 0xe9 });
+		check_utf32_round_trip(ctx, { 'c', 'a', 'f', 0xe9, 0x80, 0xff, 'x' });
+		// In the block and in the tail
+		Vector<char32_t> chars;
+		for (int i = 0; i < 17; i++) {
+			chars.push_back(ascii[i]);
+		}
+		chars.write[3] = 0xff;
+		chars.write[16] = 0xa0;
+		check_utf32_round_trip(ctx, chars);
+	}
+
+	SUBCASE("BMP") {
+		check_utf32_round_trip(ctx, { 0x4e2d, 0x6587 });
+		check_utf32_round_trip(ctx, { 0x100, 'a', 0xffff, 0xe000, 0xfffd });
+		// The 16-bit strings are widened 8 code units at a time
+		Vector<char32_t> chars;
+		for (int i = 0; i < 17; i++) {
+			chars.push_back(ascii[i]);
+		}
+		chars.write[16] = 0x4e2d;
+		check_utf32_round_trip(ctx, chars);
+		chars.write[0] = 0x3042;
+		chars.write[16] = 'q';
+		check_utf32_round_trip(ctx, chars);
+	}
+
+	SUBCASE("Astral code points take a surrogate pair") {
+		check_utf32_round_trip(ctx, { 0x1f600 });
+		check_utf32_round_trip(ctx, { 0x10000, 'a', 0x10ffff, 0xe9, 0x4e2d });
+		Vector<char32_t> chars;
+		for (int i = 0; i < 17; i++) {
+			chars.push_back(ascii[i]);
+		}
+		chars.write[7] = 0x1f600;
+		check_utf32_round_trip(ctx, chars);
+		CHECK(eval_gc(ctx, "if (String.fromCodePoint(0x1f600).length !== 2) throw new Error('not a surrogate pair');"));
+	}
+
+	SUBCASE("Lone surrogates are kept") {
+		check_utf32_round_trip(ctx, { 0xd800 });
+		check_utf32_round_trip(ctx, { 0xdfff });
+		// A low surrogate before a high one is not a pair
+		check_utf32_round_trip(ctx, { 'a', 0xdc00, 0xd800, 'b' });
+		check_utf32_round_trip(ctx, { 0x1f600, 0xd83d });
+		Vector<char32_t> chars;
+		for (int i = 0; i < 17; i++) {
+			chars.push_back(ascii[i]);
+		}
+		chars.write[5] = 0xdbff;
+		chars.write[16] = 0xdc00;
+		check_utf32_round_trip(ctx, chars);
+	}
+
+	JS_FreeContext(ctx);
+	JS_FreeRuntime(rt);
+}
+
+// A string interned in the runtime, like a string literal of a script
+static JSValue interned_string(JSContext *ctx, const char *p_text) {
+	JSAtom atom = JS_NewAtom(ctx, p_text);
+	JSValue str = JS_AtomToString(ctx, atom);
+	JS_FreeAtom(ctx, atom);
+	return str;
+}
+
+TEST_CASE("[JavaScript] Cache the names built from string literals") {
+	init_language();
+	QuickJSBinder *binder = static_cast<QuickJSBinder *>(JavaScriptLanguage::get_singleton()->get_main_binder());
+	JSContext *ctx = binder->get_context();
+
+	// Fill the cache up to its limit, the next name clears both caches
+	int filled = 0;
+	while (binder->get_string_name_cache_size() < NAME_CACHE_MAX) {
+		JSValue str = interned_string(ctx, ("name_cache_" + itos(filled++)).utf8().get_data());
+		QuickJSBinder::js_to_string_name(ctx, str);
+		JS_FreeValue(ctx, str);
+	}
+	JSValue literal = interned_string(ctx, "Child/Grand:position");
+	CHECK(JS_GetStringAtom(ctx, literal) != JS_ATOM_NULL);
+	CHECK(QuickJSBinder::js_to_string_name(ctx, literal) == StringName("Child/Grand:position"));
+	CHECK(binder->get_string_name_cache_size() == 1);
+	CHECK(binder->get_node_path_cache_size() == 0);
+
+	// The same atom is read from the cache
+	CHECK(QuickJSBinder::js_to_string_name(ctx, literal) == StringName("Child/Grand:position"));
+	CHECK(binder->get_string_name_cache_size() == 1);
+
+	// Paths are cached apart from the names built from the same string
+	const NodePath path = QuickJSBinder::js_to_node_path(ctx, literal);
+	CHECK(path == NodePath("Child/Grand:position"));
+	CHECK(path.get_name_count() == 2);
+	CHECK(path.get_subname_count() == 1);
+	CHECK(QuickJSBinder::js_to_node_path(ctx, literal) == path);
+	CHECK(binder->get_node_path_cache_size() == 1);
+	CHECK(binder->get_string_name_cache_size() == 1);
+	JS_FreeValue(ctx, literal);
+
+	// Dynamic strings have no atom and are converted every time
+	JSValue dynamic = JS_NewString(ctx, "Child/Dynamic");
+	CHECK(JS_GetStringAtom(ctx, dynamic) == JS_ATOM_NULL);
+	CHECK(QuickJSBinder::js_to_string_name(ctx, dynamic) == StringName("Child/Dynamic"));
+	CHECK(QuickJSBinder::js_to_node_path(ctx, dynamic) == NodePath("Child/Dynamic"));
+	CHECK(binder->get_string_name_cache_size() == 1);
+	CHECK(binder->get_node_path_cache_size() == 1);
+	JS_FreeValue(ctx, dynamic);
+
+	// The cache holds its atoms, so an atom freed by the script is not reused for another string
+	JSValue transient = interned_string(ctx, "transient_name");
+	const JSAtom transient_atom = JS_GetStringAtom(ctx, transient);
+	CHECK(QuickJSBinder::js_to_string_name(ctx, transient) == StringName("transient_name"));
+	JS_FreeValue(ctx, transient);
+	JSValue other = interned_string(ctx, "other_name");
+	CHECK(JS_GetStringAtom(ctx, other) != transient_atom);
+	CHECK(QuickJSBinder::js_to_string_name(ctx, other) == StringName("other_name"));
+	JS_FreeValue(ctx, other);
+	transient = interned_string(ctx, "transient_name");
+	CHECK(JS_GetStringAtom(ctx, transient) == transient_atom);
+	CHECK(QuickJSBinder::js_to_string_name(ctx, transient) == StringName("transient_name"));
+	CHECK(binder->get_string_name_cache_size() == 3);
+	JS_FreeValue(ctx, transient);
+
+	// A full path cache clears the names too
+	filled = 0;
+	while (binder->get_node_path_cache_size() < NAME_CACHE_MAX) {
+		JSValue str = interned_string(ctx, ("path_cache_" + itos(filled++)).utf8().get_data());
+		QuickJSBinder::js_to_node_path(ctx, str);
+		JS_FreeValue(ctx, str);
+	}
+	CHECK(binder->get_string_name_cache_size() == 3);
+	JSValue last = interned_string(ctx, "last/path");
+	CHECK(QuickJSBinder::js_to_node_path(ctx, last) == NodePath("last/path"));
+	CHECK(binder->get_node_path_cache_size() == 1);
+	CHECK(binder->get_string_name_cache_size() == 0);
+	JS_FreeValue(ctx, last);
+
+	// Engine methods taking a StringName or a NodePath, from literals and from dynamic strings
+	const int cached_paths = binder->get_node_path_cache_size();
+	CHECK(execute(R"((function () {
+	const check = (name, ok) => { if (!ok) throw new Error('name cache: ' + name); };
+	const parent = new godot.Node();
+	const child = new godot.Node2D();
+	child.set_name('CachedChild');
+	parent.add_child(child);
+	child.position = new godot.Vector2(3, 4);
+	for (let i = 0; i < 3; i++) {
+		check('literal path', parent.get_node('CachedChild') === child);
+		check('dynamic path', parent.get_node('Cached' + 'Child') === child);
+		check('property path', child.get_indexed('position:x') === 3);
+		check('missing path', !parent.has_node('MissingChild'));
+		check('literal name', child.has_method('get_position') && !child.has_method('get_' + 'missing'));
+		parent.set_meta('cached_meta', i);
+		check('meta', parent.get_meta('cached_' + 'meta') === i);
+	}
+	check('path returned as a string', parent.get_path_to(child) === 'CachedChild');
+	parent.free();
+})();)") == OK);
+	CHECK(binder->get_node_path_cache_size() > cached_paths);
+}
+
+#ifdef QUICKJS_WITH_DEBUGGER
+struct DebuggedScript {
+	String address;
+	Error connected = FAILED;
+	int32_t result = 0;
+};
+
+// Runs a script in its own runtime, the debugger blocks this thread while it is paused
+static void run_debugged_script(void *p_data) {
+	DebuggedScript *script = static_cast<DebuggedScript *>(p_data);
+	JSRuntime *rt = JS_NewRuntime();
+	JSContext *ctx = JS_NewContext(rt);
+	Ref<QuickJSDebugger> debugger;
+	debugger.instantiate();
+	// Returns once the client continues from the entry stop
+	script->connected = debugger->connect_debugger(ctx, script->address);
+	const char *source = "function f(a) {\n\tvar b = a + 1;\n\tvar c = a * 3;\n\treturn b * c;\n}\nf(1);\n";
+	JSValue ret = JS_Eval(ctx, source, strlen(source), "debugged.js", JS_EVAL_TYPE_GLOBAL);
+	JS_ToInt32(ctx, &script->result, ret);
+	JS_FreeValue(ctx, ret);
+	JS_FreeContext(ctx);
+	// Detaches the debugger, before the transport it writes to is freed
+	JS_FreeRuntime(rt);
+}
+
+// Messages are JSON prefixed by their length as 8 hexadecimal digits and a newline
+static void send_debugger_message(const Ref<StreamPeerTCP> &p_peer, const String &p_json) {
+	const CharString message = (p_json + "\n").utf8();
+	const CharString header = (String::num_int64(message.length(), 16).lpad(8, "0") + "\n").utf8();
+	p_peer->put_data((const uint8_t *)header.get_data(), header.length());
+	p_peer->put_data((const uint8_t *)message.get_data(), message.length());
+}
+
+static Dictionary read_debugger_message(const Ref<StreamPeerTCP> &p_peer) {
+	uint8_t header[9];
+	ERR_FAIL_COND_V(p_peer->get_data(header, 9) != OK, Dictionary());
+	const int length = String::utf8((const char *)header, 8).hex_to_int();
+	ERR_FAIL_COND_V(length <= 0, Dictionary());
+	Vector<uint8_t> message;
+	message.resize(length);
+	ERR_FAIL_COND_V(p_peer->get_data(message.ptrw(), length) != OK, Dictionary());
+	return JSON::parse_string(String::utf8((const char *)message.ptr(), length));
+}
+
+static String stopped_reason(const Dictionary &p_message) {
+	if (p_message.get("type", "") != "event") {
+		return String();
+	}
+	const Dictionary event = p_message["event"];
+	return event.get("type", "") == "StoppedEvent" ? String(event["reason"]) : String();
+}
+
+// Line of the innermost frame in the response to a stackTrace request
+static int stopped_line(const Ref<StreamPeerTCP> &p_peer, int p_seq) {
+	send_debugger_message(p_peer, vformat(R"({"type":"request","request":{"request_seq":%d,"command":"stackTrace"}})", p_seq));
+	const Dictionary response = read_debugger_message(p_peer);
+	const Array frames = response.get("body", Array());
+	ERR_FAIL_COND_V(int(response.get("request_seq", -1)) != p_seq || frames.is_empty(), -1);
+	return Dictionary(frames[0]).get("line", -1);
+}
+
+TEST_CASE("[JavaScript] Debugger protocol round trip") {
+	Ref<TCPServer> server;
+	server.instantiate();
+	REQUIRE(server->listen(0, IPAddress("127.0.0.1")) == OK);
+	DebuggedScript script;
+	script.address = vformat("127.0.0.1:%d", server->get_local_port());
+	Thread thread;
+	thread.start(run_debugged_script, &script);
+
+	const uint64_t deadline = OS::get_singleton()->get_ticks_msec() + QJS_DEBUGGER_CONNECT_TIMEOUT_MSEC;
+	while (!server->is_connection_available() && OS::get_singleton()->get_ticks_msec() < deadline) {
+		OS::get_singleton()->delay_usec(1000);
+	}
+	Ref<StreamPeerTCP> peer = server->take_connection();
+	if (peer.is_null()) {
+		thread.wait_to_finish();
+		FAIL("the debugger did not connect");
+	}
+	CHECK(stopped_reason(read_debugger_message(peer)) == "entry");
+
+	// The breakpoint is set before the script is compiled
+	send_debugger_message(peer, R"({"type":"breakpoints","breakpoints":{"path":"debugged.js","breakpoints":[{"line":2}]}})");
+	send_debugger_message(peer, R"({"type":"request","request":{"request_seq":1,"command":"continue"}})");
+	CHECK(int(read_debugger_message(peer).get("request_seq", -1)) == 1);
+	CHECK(stopped_reason(read_debugger_message(peer)) == "breakpoint");
+	CHECK(stopped_line(peer, 2) == 2);
+
+	send_debugger_message(peer, R"({"type":"request","request":{"request_seq":3,"command":"next"}})");
+	CHECK(int(read_debugger_message(peer).get("request_seq", -1)) == 3);
+	CHECK(stopped_reason(read_debugger_message(peer)) == "step");
+	CHECK(stopped_line(peer, 4) == 3);
+
+	// The paused frame sees the local assigned by the stepped line
+	send_debugger_message(peer, R"({"type":"request","request":{"request_seq":5,"command":"evaluate","args":{"frameId":0,"expression":"b"}}})");
+	const Dictionary evaluated = read_debugger_message(peer);
+	CHECK(Dictionary(evaluated.get("body", Dictionary())).get("result", "") == "2");
+
+	send_debugger_message(peer, R"({"type":"request","request":{"request_seq":6,"command":"continue"}})");
+	CHECK(int(read_debugger_message(peer).get("request_seq", -1)) == 6);
+	thread.wait_to_finish();
+	CHECK(script.connected == OK);
+	CHECK(script.result == 6);
+	server->stop();
+}
+#endif
+
+// Plain objects passed to the engine are converted to dictionaries in the order of their keys
+TEST_CASE("[JavaScript] Convert objects to dictionaries") {
+	init_language();
+	CHECK(execute(R"((function () {
+	const check = (name, ok) => { if (!ok) throw new Error('object to dictionary: ' + name); };
+	const keys = 1000;
+	const data = {};
+	for (let i = 0; i < keys; i++) data['k' + i] = { index: i, tags: ['a', 'b'] };
+	const res = new godot.Resource();
+	res.set_meta('data', data);
+	const dict = res.get_meta('data');
+	const names = Object.keys(dict);
+	check('key count ' + names.length, names.length === keys);
+	check('key order', names[0] === 'k0' && names[keys - 1] === 'k' + (keys - 1));
+	check('nested value', dict['k42'].index === 42 && dict['k42'].tags.join() === 'a,b');
+
+	// The same object reached twice is not a cycle
+	const shared = { value: 1 };
+	res.set_meta('shared', { first: shared, second: shared, list: [shared, [shared]], nested: { shared } });
+	const converted = res.get_meta('shared');
+	check('shared object', converted.first.value === 1 && converted.second.value === 1);
+	check('shared object in arrays', converted.list[0].value === 1 && converted.list[1][0].value === 1);
+	check('shared object nested', converted.nested.shared.value === 1);
+})();)") == OK);
+
+	// A property referencing one of its ancestors is left out
+	ERR_PRINT_OFF;
+	Error err = execute(R"((function () {
+	const outer = { name: 'outer' };
+	outer.inner = { parent: outer, list: [outer] };
+	const res = new godot.Resource();
+	res.set_meta('cycle', outer);
+	const converted = res.get_meta('cycle');
+	if (converted.name !== 'outer' || 'parent' in converted.inner) throw new Error('the cycle was converted');
+	if (converted.inner.list.length !== 1 || converted.inner.list[0] != null) throw new Error('the cycle through an array was converted');
+})();)");
+	ERR_PRINT_ON;
+	CHECK(err == OK);
+}
+
 } // namespace JavaScriptTests
 
 #endif // TEST_JAVASCRIPT_H
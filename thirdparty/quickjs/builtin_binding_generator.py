@@ -9,7 +9,10 @@ VariantTypes = {
     "Variant": "Variant::NIL",
     "boolean": "Variant::BOOL",
     "number": "Variant::FLOAT",
+    "int": "Variant::INT",
     "string": "Variant::STRING",
+    "StringName": "Variant::STRING",
+    "NodePath": "Variant::STRING",
     "Vector2": "Variant::VECTOR2",
     "Vector3": "Variant::VECTOR3",
     "Basis": "Variant::BASIS",
@@ -21,6 +24,12 @@ VariantTypes = {
     "Plane": "Variant::PLANE",
     "AABB": "Variant::AABB",
     "Transform3D": "Variant::TRANSFORM3D",
+    "Vector2i": "Variant::VECTOR2I",
+    "Vector3i": "Variant::VECTOR3I",
+    "Vector4": "Variant::VECTOR4",
+    "Vector4i": "Variant::VECTOR4I",
+    "Rect2i": "Variant::RECT2I",
+    "Projection": "Variant::PROJECTION",
     "PackedByteArray": "Variant::PACKED_BYTE_ARRAY",
     "PackedInt32Array": "Variant::PACKED_INT32_ARRAY",
     "PackedInt64Array": "Variant::PACKED_INT64_ARRAY",
@@ -34,7 +43,10 @@ VariantTypes = {
 
 JSToGodotTemplates = {
     "number": "QuickJSBinder::js_to_number(ctx, ${arg})",
+    "int": "QuickJSBinder::js_to_int64(ctx, ${arg})",
     "string": "QuickJSBinder::js_to_string(ctx, ${arg})",
+    "StringName": "QuickJSBinder::js_to_string_name(ctx, ${arg})",
+    "NodePath": "QuickJSBinder::js_to_node_path(ctx, ${arg})",
     "boolean": "QuickJSBinder::js_to_bool(ctx, ${arg})",
     "Vector2": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getVector2()",
     "Rect2": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getRect2()",
@@ -47,6 +59,12 @@ JSToGodotTemplates = {
     "Vector3": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getVector3()",
     "Basis": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getBasis()",
     "Transform3D": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getTransform3D()",
+    "Vector2i": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getVector2i()",
+    "Vector3i": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getVector3i()",
+    "Vector4": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getVector4()",
+    "Vector4i": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getVector4i()",
+    "Rect2i": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getRect2i()",
+    "Projection": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getProjection()",
     "PackedByteArray": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getPackedByteArray()",
     "PackedInt32Array": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getPackedInt32Array()",
     "PackedInt64Array": "*(BINDING_DATA_FROM_JS(ctx, ${arg}))->getPackedInt64Array()",
@@ -61,7 +79,10 @@ JSToGodotTemplates = {
 
 GodotTypeNames = {
     "number": "real_t",
+    "int": "int64_t",
     "string": "String",
+    "StringName": "StringName",
+    "NodePath": "NodePath",
     "boolean": "bool",
     "Vector2": "Vector2",
     "Rect2": "Rect2",
@@ -74,6 +95,12 @@ GodotTypeNames = {
     "Vector3": "Vector3",
     "Basis": "Basis",
     "Transform3D": "Transform3D",
+    "Vector2i": "Vector2i",
+    "Vector3i": "Vector3i",
+    "Vector4": "Vector4",
+    "Vector4i": "Vector4i",
+    "Rect2i": "Rect2i",
+    "Projection": "Projection",
     "PackedByteArray": "PackedByteArray",
     "PackedInt32Array": "PackedInt32Array",
     "PackedInt64Array": "PackedInt64Array",
@@ -88,7 +115,10 @@ GodotTypeNames = {
 
 GodotToJSTemplates = {
     "number": "QuickJSBinder::to_js_number(ctx, ${arg})",
+    "int": "QuickJSBinder::to_js_int64(ctx, ${arg})",
     "string": "QuickJSBinder::to_js_string(ctx, ${arg})",
+    "StringName": "QuickJSBinder::to_js_string(ctx, String(${arg}))",
+    "NodePath": "QuickJSBinder::to_js_string(ctx, String(${arg}))",
     "boolean": "QuickJSBinder::to_js_bool(ctx, ${arg})",
     "Vector2": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
     "Rect2": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
@@ -101,6 +131,12 @@ GodotToJSTemplates = {
     "Vector3": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
     "Basis": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
     "Transform3D": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
+    "Vector2i": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
+    "Vector3i": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
+    "Vector4": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
+    "Vector4i": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
+    "Rect2i": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
+    "Projection": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
     "PackedByteArray": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
     "PackedInt32Array": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
     "PackedInt64Array": "QuickJSBuiltinBinder::new_object_from(ctx, ${arg})",
@@ -120,6 +156,50 @@ def apply_pattern(template, values):
     return template
 
 
+# The integer division of Godot traps on a zero divisor, the integer vectors are checked before dividing
+IntegerDivisionTypes = ["Vector2i", "Vector3i", "Vector4i"]
+TemplateIntegerDivisionCheck = """
+			if (!QuickJSBuiltinBinder::is_integer_division_defined(${dividend}, ${divisor})) {
+				return JS_ThrowRangeError(ctx, "Integer division by zero in ${class}.${name}");
+			}"""
+
+
+def generate_division_check(class_name, op, name, dividend, divisor):
+    if class_name not in IntegerDivisionTypes or op not in ["operator/", "operator/="]:
+        return ""
+    return apply_pattern(
+        TemplateIntegerDivisionCheck,
+        {"class": class_name, "name": name, "dividend": dividend, "divisor": divisor},
+    )
+
+
+# Their divide methods also take an integer number as the divisor, the result stays an integer vector
+TemplateIntegerDivisionByNumberAssign = """
+			if (JS_IsNumber(argv[0])) {
+				${class} *self = BINDING_DATA_FROM_JS(ctx, this_val)->get${class}();
+				return QuickJSBuiltinBinder::divide_integer_vector(ctx, *self, *self, argv[0]) ? JS_DupValue(ctx, this_val) : JS_EXCEPTION;
+			}"""
+TemplateIntegerDivisionByNumberOut = """
+			if (JS_IsNumber(argv[2])) {
+#ifdef DEBUG_METHODS_ENABLED
+				ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, ${type}, argv[0]), (JS_ThrowTypeError(ctx, "${class} expected for argument 0 of ${class}.${name}")));
+				ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, ${type}, argv[1]), (JS_ThrowTypeError(ctx, "${class} expected for argument 1 of ${class}.${name}")));
+#endif
+				${class} *out = BINDING_DATA_FROM_JS(ctx, argv[0])->get${class}();
+				const ${class} *dividend = BINDING_DATA_FROM_JS(ctx, argv[1])->get${class}();
+				return QuickJSBuiltinBinder::divide_integer_vector(ctx, *out, *dividend, argv[2]) ? JS_DupValue(ctx, argv[0]) : JS_EXCEPTION;
+			}"""
+
+
+def generate_division_by_number(class_name, op, name, template):
+    if class_name not in IntegerDivisionTypes or op not in ["operator/", "operator/="]:
+        return ""
+    return apply_pattern(
+        template,
+        {"class": class_name, "name": name, "type": VariantTypes[class_name]},
+    )
+
+
 def generate_constructor(cls):
     TemplateConstructorName = "${class}_constructor"
     TemplateConstructorDeclare = (
@@ -424,6 +504,130 @@ static JSValue ${func}(JSContext *ctx, JSValueConst new_target, int argc, JSValu
 			}
 		}
 	}
+""",
+        "Vector2i": """
+	if (argc == 2) {
+		tmp.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+		tmp.y = QuickJSBinder::js_to_int(ctx, argv[1]);
+	} else if (argc == 1) {
+		if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0])) {
+			if (bind->type == Variant::VECTOR2I) {
+				tmp = *bind->getVector2i();
+			} else if (bind->type == Variant::VECTOR2) {
+				tmp = Vector2i(*bind->getVector2());
+			}
+		} else {
+			tmp.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+			tmp.y = tmp.x;
+		}
+	}
+""",
+        "Vector3i": """
+	if (argc == 3) {
+		tmp.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+		tmp.y = QuickJSBinder::js_to_int(ctx, argv[1]);
+		tmp.z = QuickJSBinder::js_to_int(ctx, argv[2]);
+	} else if (argc == 1) {
+		if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0])) {
+			if (bind->type == Variant::VECTOR3I) {
+				tmp = *bind->getVector3i();
+			} else if (bind->type == Variant::VECTOR3) {
+				tmp = Vector3i(*bind->getVector3());
+			}
+		} else {
+			tmp.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+			tmp.z = tmp.y = tmp.x;
+		}
+	}
+""",
+        "Vector4": """
+	if (argc == 4) {
+		tmp.x = QuickJSBinder::js_to_number(ctx, argv[0]);
+		tmp.y = QuickJSBinder::js_to_number(ctx, argv[1]);
+		tmp.z = QuickJSBinder::js_to_number(ctx, argv[2]);
+		tmp.w = QuickJSBinder::js_to_number(ctx, argv[3]);
+	} else if (argc == 1) {
+		if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0])) {
+			if (bind->type == Variant::VECTOR4) {
+				tmp = *bind->getVector4();
+			} else if (bind->type == Variant::VECTOR4I) {
+				tmp = Vector4(*bind->getVector4i());
+			}
+		} else {
+			tmp.x = QuickJSBinder::js_to_number(ctx, argv[0]);
+			tmp.w = tmp.z = tmp.y = tmp.x;
+		}
+	}
+""",
+        "Vector4i": """
+	if (argc == 4) {
+		tmp.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+		tmp.y = QuickJSBinder::js_to_int(ctx, argv[1]);
+		tmp.z = QuickJSBinder::js_to_int(ctx, argv[2]);
+		tmp.w = QuickJSBinder::js_to_int(ctx, argv[3]);
+	} else if (argc == 1) {
+		if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0])) {
+			if (bind->type == Variant::VECTOR4I) {
+				tmp = *bind->getVector4i();
+			} else if (bind->type == Variant::VECTOR4) {
+				tmp = Vector4i(*bind->getVector4());
+			}
+		} else {
+			tmp.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+			tmp.w = tmp.z = tmp.y = tmp.x;
+		}
+	}
+""",
+        "Rect2i": """
+	if (argc == 4) {
+		tmp.position.x = QuickJSBinder::js_to_int(ctx, argv[0]);
+		tmp.position.y = QuickJSBinder::js_to_int(ctx, argv[1]);
+		tmp.size.x = QuickJSBinder::js_to_int(ctx, argv[2]);
+		tmp.size.y = QuickJSBinder::js_to_int(ctx, argv[3]);
+	} else if (argc == 2) {
+#ifdef DEBUG_METHODS_ENABLED
+		ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR2I, argv[0]), (JS_ThrowTypeError(ctx, "Vector2i expected for argument 0 of Rect2i(position, size)")));
+		ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR2I, argv[1]), (JS_ThrowTypeError(ctx, "Vector2i expected for argument 1 of Rect2i(position, size)")));
+#endif
+		JavaScriptGCHandler *param0 = BINDING_DATA_FROM_JS(ctx, argv[0]);
+		JavaScriptGCHandler *param1 = BINDING_DATA_FROM_JS(ctx, argv[1]);
+		tmp.position = *param0->getVector2i();
+		tmp.size = *param1->getVector2i();
+	} else if (argc == 1) {
+		if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0])) {
+			if (bind->type == Variant::RECT2I) {
+				tmp = *bind->getRect2i();
+			} else if (bind->type == Variant::RECT2) {
+				tmp = Rect2i(*bind->getRect2());
+			}
+		}
+	}
+""",
+        "Projection": """
+	if (argc == 4) {
+#ifdef DEBUG_METHODS_ENABLED
+		ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR4, argv[0]), (JS_ThrowTypeError(ctx, "Vector4 expected for argument 0 of Projection(x_axis, y_axis, z_axis, w_axis)")));
+		ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR4, argv[1]), (JS_ThrowTypeError(ctx, "Vector4 expected for argument 1 of Projection(x_axis, y_axis, z_axis, w_axis)")));
+		ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR4, argv[2]), (JS_ThrowTypeError(ctx, "Vector4 expected for argument 2 of Projection(x_axis, y_axis, z_axis, w_axis)")));
+		ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR4, argv[3]), (JS_ThrowTypeError(ctx, "Vector4 expected for argument 3 of Projection(x_axis, y_axis, z_axis, w_axis)")));
+#endif
+		JavaScriptGCHandler *param0 = BINDING_DATA_FROM_JS(ctx, argv[0]);
+		JavaScriptGCHandler *param1 = BINDING_DATA_FROM_JS(ctx, argv[1]);
+		JavaScriptGCHandler *param2 = BINDING_DATA_FROM_JS(ctx, argv[2]);
+		JavaScriptGCHandler *param3 = BINDING_DATA_FROM_JS(ctx, argv[3]);
+		tmp.columns[0].operator=(*param0->getVector4());
+		tmp.columns[1].operator=(*param1->getVector4());
+		tmp.columns[2].operator=(*param2->getVector4());
+		tmp.columns[3].operator=(*param3->getVector4());
+	} else if (argc == 1) {
+		if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0])) {
+			if (bind->type == Variant::PROJECTION) {
+				tmp.operator=(*bind->getProjection());
+			} else if (bind->type == Variant::TRANSFORM3D) {
+				tmp.operator=(Projection(*bind->getTransform3D()));
+			}
+		}
+	}
 """,
         "PackedByteArray": apply_pattern(
             TemplatePackedArrays,
@@ -704,7 +908,7 @@ ${bindings}
 		JS_NewCFunction(octx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
 			JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
 			${class} *ptr = bind->get${class}();\
-${target_declare}
+${target_declare}${division_check}
 			${call}
 			return ${return};
 		},
@@ -755,6 +959,9 @@ ${target_declare}
                         "call": call,
                         "name": o["name"],
                         "target_declare": target_declare,
+                        "division_check": generate_division_check(class_name, op, o["name"], "*ptr", "*target")
+                        if argc > 1
+                        else "",
                         "return": "JS_UNDEFINED"
                         if o["return"] == "void"
                         else apply_pattern(GodotToJSTemplates[o["return"]], {"arg": "ret"}),
@@ -771,11 +978,91 @@ ${target_declare}
         )
         return bindings
 
+    def generate_operator_methods(cls):
+        # a.add_assign(b) writes into a, ${class}.add(out, a, b) writes into out, neither allocates a new value
+        TemplateAssign = """
+	binder->get_builtin_binder().register_method(
+		${type},
+		"${name}",
+		[](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {\
+${division_by_number}
+#ifdef DEBUG_METHODS_ENABLED
+			ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, ${target_type}, argv[0]), (JS_ThrowTypeError(ctx, "${target_class} expected for argument 0 of ${class}.${name}")));
+#endif
+			JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, this_val);
+			JavaScriptGCHandler *bind0 = BINDING_DATA_FROM_JS(ctx, argv[0]);\
+${division_check}
+			bind->get${class}()->${op}(*bind0->get${target_class}());
+			return JS_DupValue(ctx, this_val);
+		},
+		1);
+"""
+        TemplateOut = """
+	binder->get_builtin_binder().register_static_method(
+		${type},
+		"${name}",
+		[](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {\
+${division_by_number}
+#ifdef DEBUG_METHODS_ENABLED
+			ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, ${type}, argv[0]), (JS_ThrowTypeError(ctx, "${class} expected for argument 0 of ${class}.${name}")));
+			ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, ${type}, argv[1]), (JS_ThrowTypeError(ctx, "${class} expected for argument 1 of ${class}.${name}")));
+			ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, ${target_type}, argv[2]), (JS_ThrowTypeError(ctx, "${target_class} expected for argument 2 of ${class}.${name}")));
+#endif
+			JavaScriptGCHandler *bind0 = BINDING_DATA_FROM_JS(ctx, argv[0]);
+			JavaScriptGCHandler *bind1 = BINDING_DATA_FROM_JS(ctx, argv[1]);
+			JavaScriptGCHandler *bind2 = BINDING_DATA_FROM_JS(ctx, argv[2]);\
+${division_check}
+			*bind0->get${class}() = bind1->get${class}()->${op}(*bind2->get${target_class}());
+			return JS_DupValue(ctx, argv[0]);
+		},
+		3);
+"""
+        bindings = ""
+        for o in cls["operators"]:
+            if len(o["arguments"]) != 1:
+                continue
+            if o["return"] == "this":
+                template = TemplateAssign
+            elif o["return"] == class_name:
+                template = TemplateOut
+            else:
+                continue
+            target_class = o["arguments"][0]["type"]
+            if template == TemplateAssign:
+                division_check = generate_division_check(
+                    class_name, o["native_method"], o["name"], "*bind->get" + class_name + "()", "*bind0->get" + target_class + "()"
+                )
+                division_by_number = generate_division_by_number(
+                    class_name, o["native_method"], o["name"], TemplateIntegerDivisionByNumberAssign
+                )
+            else:
+                division_check = generate_division_check(
+                    class_name, o["native_method"], o["name"], "*bind1->get" + class_name + "()", "*bind2->get" + target_class + "()"
+                )
+                division_by_number = generate_division_by_number(
+                    class_name, o["native_method"], o["name"], TemplateIntegerDivisionByNumberOut
+                )
+            bindings += apply_pattern(
+                template,
+                {
+                    "type": VariantTypes[class_name],
+                    "class": class_name,
+                    "name": o["name"],
+                    "op": o["native_method"],
+                    "target_type": VariantTypes[target_class],
+                    "target_class": target_class,
+                    "division_check": division_check,
+                    "division_by_number": division_by_number,
+                },
+            )
+        return bindings
+
     TemplateBindDefine = """
 static void bind_${class}_properties(JSContext *octx) {
 	QuickJSBinder *binder = QuickJSBinder::get_context_binder(octx);
 ${members}
 ${operators}
+${operator_methods}
 ${constants}
 ${methods}
 }
@@ -790,6 +1077,7 @@ ${methods}
             "methods": generate_methods(cls),
             "constants": generate_constants(cls),
             "operators": genertate_operators(cls),
+            "operator_methods": generate_operator_methods(cls),
         },
     )
     property_bind = apply_pattern(TemplateBind, {"class": class_name})
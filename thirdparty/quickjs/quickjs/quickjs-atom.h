@@ -220,6 +220,8 @@ DEF(BigInt, "BigInt")
 DEF(BigFloat, "BigFloat")
 DEF(BigFloatEnv, "BigFloatEnv")
 DEF(BigDecimal, "BigDecimal")
+#endif
+#if defined(CONFIG_BIGNUM) || defined(CONFIG_OPERATORS)
 DEF(OperatorSet, "OperatorSet")
 DEF(Operators, "Operators")
 #endif
@@ -265,7 +267,7 @@ DEF(Symbol_hasInstance, "Symbol.hasInstance")
 DEF(Symbol_species, "Symbol.species")
 DEF(Symbol_unscopables, "Symbol.unscopables")
 DEF(Symbol_asyncIterator, "Symbol.asyncIterator")
-#ifdef CONFIG_BIGNUM
+#if defined(CONFIG_BIGNUM) || defined(CONFIG_OPERATORS)
 DEF(Symbol_operatorSet, "Symbol.operatorSet")
 #endif
 
@@ -233,16 +233,15 @@ static void js_process_request(JSDebuggerInfo *info, struct DebuggerSuspendedSta
     JSValue command_property = JS_GetPropertyStr(ctx, request, "command");
     const char *command = JS_ToCString(ctx, command_property);
     if (strcmp("continue", command) == 0) {
-        info->stepping = JS_DEBUGGER_STEP_CONTINUE;
-        info->step_over = js_debugger_current_location(ctx, state->cur_pc);
-        info->step_depth = js_debugger_stack_depth(ctx);
+        // breakpoints only trigger when their line starts again, no need to step over the current one.
+        info->stepping = 0;
         js_transport_send_response(info, request, JS_UNDEFINED);
         info->is_paused = 0;
     }
     if (strcmp("pause", command) == 0) {
+        // requests are read between script runs, stop at the next instruction that runs.
+        info->stepping = JS_DEBUGGER_STEP_PAUSE;
         js_transport_send_response(info, request, JS_UNDEFINED);
-        js_send_stopped_event(info, "pause");
-        info->is_paused = 1;
     }
     else if (strcmp("next", command) == 0) {
         info->stepping = JS_DEBUGGER_STEP;
@@ -404,6 +403,9 @@ static void js_process_breakpoints(JSDebuggerInfo *info, JSValue message) {
     JS_SetPropertyStr(ctx, path_data, "dirty", JS_NewInt32(ctx, info->breakpoints_dirty_counter));
 
     JS_FreeValue(ctx, message);
+
+    // patch the functions already loaded, they may be running.
+    js_debugger_update_breakpoints(ctx);
 }
 
 JSValue js_debugger_file_breakpoints(JSContext *ctx, const char* path) {
@@ -527,151 +529,129 @@ void js_debugger_free_context(JSContext *ctx) {
     js_debugger_context_event(ctx, "exited");
 }
 
-// in thread check request/response of pending commands.
-// todo: background thread that reads the socket.
-void js_debugger_check(JSContext* ctx, const uint8_t *cur_pc) {
+// checks the step in progress, only called before each instruction while stepping.
+// breakpoints do not need it, they replace the instruction they stop at.
+int js_debugger_check(JSContext* ctx, const uint8_t *cur_pc) {
     JSDebuggerInfo *info = js_debugger_info(JS_GetRuntime(ctx));
-    if (info->is_debugging)
-        return;
-    if (info->debugging_ctx == ctx)
-        return;
+    if (info->is_debugging || info->debugging_ctx == ctx)
+        return info->stepping != 0;
+    if (info->transport_close == NULL || !info->stepping)
+        return 0;
     info->is_debugging = 1;
     info->ctx = ctx;
 
-#if 0
-    if (!info->attempted_connect) {
-        info->attempted_connect = 1;
-        char *address = getenv("QUICKJS_DEBUG_ADDRESS");
-        if (address != NULL && !info->transport_close)
-            js_debugger_connect(ctx, address);
-    }
-    else if (!info->attempted_wait) {
-        info->attempted_wait = 1;
-        char *address = getenv("QUICKJS_DEBUG_LISTEN_ADDRESS");
-        if (address != NULL && !info->transport_close)
-            js_debugger_wait_connection(ctx, address);
+    if (info->stepping == JS_DEBUGGER_STEP_PAUSE) {
+        info->stepping = 0;
+        info->is_paused = 1;
+        js_send_stopped_event(info, "pause");
+        goto process;
     }
-#endif
 
-    if (info->transport_close == NULL)
+    // all step operations need to ignore their step location, as those
+    // may be on a breakpoint.
+    struct JSDebuggerLocation location = js_debugger_current_location(ctx, cur_pc);
+    int depth = js_debugger_stack_depth(ctx);
+    if (info->step_depth == depth
+        && location.filename == info->step_over.filename
+        && location.line == info->step_over.line
+        && location.column == info->step_over.column)
         goto done;
 
-    struct JSDebuggerLocation location;
-    int depth;
-
-    // perform stepping checks prior to the breakpoint check
-    // as those need to preempt breakpoint behavior to skip their last
-    // position, which may be a breakpoint.
-    if (info->stepping) {
-        // all step operations need to ignore their step location, as those
-        // may be on a breakpoint.
-        location = js_debugger_current_location(ctx, cur_pc);
-        depth = js_debugger_stack_depth(ctx);
-        if (info->step_depth == depth
-            && location.filename == info->step_over.filename
+    if (info->stepping == JS_DEBUGGER_STEP_IN) {
+        // break if the stack is deeper
+        // or
+        // break if the depth is the same, but the location has changed
+        // or
+        // break if the stack unwinds
+        info->stepping = 0;
+        info->is_paused = 1;
+        js_send_stopped_event(info, "stepIn");
+    }
+    else if (info->stepping == JS_DEBUGGER_STEP_OUT) {
+        if (depth >= info->step_depth)
+            goto done;
+        info->stepping = 0;
+        info->is_paused = 1;
+        js_send_stopped_event(info, "stepOut");
+    }
+    else if (info->stepping == JS_DEBUGGER_STEP) {
+        // to step over, need to make sure the location changes,
+        // and that the location change isn't into a function call (deeper stack).
+        if ((location.filename == info->step_over.filename
             && location.line == info->step_over.line
             && location.column == info->step_over.column)
+            || depth > info->step_depth)
             goto done;
-    }
-
-    int at_breakpoint = js_debugger_check_breakpoint(ctx, info->breakpoints_dirty_counter, cur_pc);
-    if (at_breakpoint) {
-        // reaching a breakpoint resets any existing stepping.
         info->stepping = 0;
         info->is_paused = 1;
-        js_send_stopped_event(info, "breakpoint");
-    }
-    else if (info->stepping) {
-        if (info->stepping == JS_DEBUGGER_STEP_CONTINUE) {
-            // continue needs to proceed over the existing statement (which may be multiple ops)
-            // once any change in location is detecting, turn off stepping.
-            // since reaching here after performing the check above, that is in fact the case.
-            // turn off stepping.
-            info->stepping = 0;
-        }
-        else if (info->stepping == JS_DEBUGGER_STEP_IN) {
-            int depth = js_debugger_stack_depth(ctx);
-            // break if the stack is deeper
-            // or
-            // break if the depth is the same, but the location has changed
-            // or
-            // break if the stack unwinds
-            if (info->step_depth == depth) {
-                struct JSDebuggerLocation location = js_debugger_current_location(ctx, cur_pc);
-                if (location.filename == info->step_over.filename
-                    && location.line == info->step_over.line
-                    && location.column == info->step_over.column)
-                    goto done;
-            }
-            info->stepping = 0;
-            info->is_paused = 1;
-            js_send_stopped_event(info, "stepIn");
-        }
-        else if (info->stepping == JS_DEBUGGER_STEP_OUT) {
-            int depth = js_debugger_stack_depth(ctx);
-            if (depth >= info->step_depth)
-                goto done;
-            info->stepping = 0;
-            info->is_paused = 1;
-            js_send_stopped_event(info, "stepOut");
-        }
-        else if (info->stepping == JS_DEBUGGER_STEP) {
-            struct JSDebuggerLocation location = js_debugger_current_location(ctx, cur_pc);
-            // to step over, need to make sure the location changes,
-            // and that the location change isn't into a function call (deeper stack).
-            if ((location.filename == info->step_over.filename
-                && location.line == info->step_over.line
-                && location.column == info->step_over.column)
-                || js_debugger_stack_depth(ctx) > info->step_depth)
-                goto done;
-            info->stepping = 0;
-            info->is_paused = 1;
-            js_send_stopped_event(info, "step");
-        }
-        else {
-            // ???
-            info->stepping = 0;
-        }
+        js_send_stopped_event(info, "step");
     }
-
-    // if not paused, we ought to peek at the stream
-    // and read it without blocking until all data is consumed.
-    if (!info->is_paused) {
-        // only peek at the stream every now and then.
-        if (info->peek_ticks++ < 1000 && !info->should_peek)
-            goto done;
-
-        info->peek_ticks = 0;
-        info->should_peek = 0;
-
-        // continue peek/reading until there's nothing left.
-        // breakpoints may arrive outside of a debugger pause.
-        // once paused, fall through to handle the pause.
-        while (!info->is_paused) {
-            int peek = info->transport_peek(info->transport_udata);
-            if (peek < 0)
-                goto fail;
-            if (peek == 0)
-                goto done;
-            if (!js_process_debugger_messages(info, cur_pc))
-                goto fail;
-        }
+    else {
+        // ???
+        info->stepping = 0;
     }
 
-    if (js_process_debugger_messages(info, cur_pc))
+    if (!info->is_paused)
         goto done;
 
-    fail:
-        js_debugger_free(JS_GetRuntime(ctx), info);
+    process:
+        if (!js_process_debugger_messages(info, cur_pc))
+            js_debugger_free(JS_GetRuntime(ctx), info);
     done:
         info->is_debugging = 0;
         info->ctx = NULL;
+        return info->stepping != 0;
+}
+
+void js_debugger_break(JSContext *ctx, const uint8_t *cur_pc) {
+    JSDebuggerInfo *info = js_debugger_info(JS_GetRuntime(ctx));
+    if (info->is_debugging || info->debugging_ctx == ctx || info->transport_close == NULL)
+        return;
+    info->is_debugging = 1;
+    info->ctx = ctx;
+
+    // reaching a breakpoint resets any existing stepping.
+    info->stepping = 0;
+    info->is_paused = 1;
+    js_send_stopped_event(info, "breakpoint");
+    if (!js_process_debugger_messages(info, cur_pc))
+        js_debugger_free(JS_GetRuntime(ctx), info);
+
+    info->is_debugging = 0;
+    info->ctx = NULL;
+}
+
+void js_debugger_poll(JSContext *ctx) {
+    JSDebuggerInfo *info = js_debugger_info(JS_GetRuntime(ctx));
+    if (info->transport_close == NULL || info->is_debugging)
+        return;
+    info->is_debugging = 1;
+    info->ctx = ctx;
+
+    // continue peek/reading until there's nothing left.
+    for (;;) {
+        int peek = info->transport_peek(info->transport_udata);
+        if (peek == 0)
+            break;
+        if (peek < 0 || !js_process_debugger_messages(info, NULL)) {
+            js_debugger_free(JS_GetRuntime(ctx), info);
+            break;
+        }
+    }
+
+    info->is_debugging = 0;
+    info->ctx = NULL;
 }
 
 void js_debugger_free(JSRuntime *rt, JSDebuggerInfo *info) {
     if (!info->transport_close)
         return;
 
+    // the scripts run at full speed again.
+    js_debugger_clear_breakpoints(rt);
+    info->stepping = 0;
+    info->is_paused = 0;
+
     // don't use the JSContext because it might be in a funky state during teardown.
     const char* terminated = "{\"type\":\"event\",\"event\":{\"type\":\"terminated\"}}";
     js_transport_write_message_newline(info, terminated, strlen(terminated));
@@ -731,5 +711,5 @@ int js_debugger_is_transport_connected(JSRuntime *rt) {
 }
 
 void js_debugger_cooperate(JSContext *ctx) {
-    js_debugger_info(JS_GetRuntime(ctx))->should_peek = 1;
+    js_debugger_poll(ctx);
 }
@@ -9,10 +9,9 @@ extern "C" {
 #endif
 
 typedef struct JSDebuggerFunctionInfo {
-    // same length as byte_code_buf.
+    // same length as byte_code_buf, the original opcode of each instruction replaced by a breakpoint.
     uint8_t *breakpoints;
     uint32_t dirty;
-    int last_line_num;
 } JSDebuggerFunctionInfo;
 
 typedef struct JSDebuggerLocation {
@@ -25,6 +24,8 @@ typedef struct JSDebuggerLocation {
 #define JS_DEBUGGER_STEP_IN 2
 #define JS_DEBUGGER_STEP_OUT 3
 #define JS_DEBUGGER_STEP_CONTINUE 4
+// stop at the next instruction run, set by a pause request received while no script runs.
+#define JS_DEBUGGER_STEP_PAUSE 5
 
 typedef struct JSDebuggerInfo {
     // JSContext that is used to for the JSON transport and debugger state.
@@ -33,8 +34,6 @@ typedef struct JSDebuggerInfo {
 
     int attempted_connect;
     int attempted_wait;
-    int peek_ticks;
-    int should_peek;
     char *message_buffer;
     int message_buffer_length;
     int is_debugging;
@@ -52,11 +51,17 @@ typedef struct JSDebuggerInfo {
     int stepping;
     JSDebuggerLocation step_over;
     int step_depth;
+    // one shot breakpoint where the caller of a function resumes while stepping.
+    struct JSFunctionBytecode *step_trap_function;
+    int step_trap_pos;
 } JSDebuggerInfo;
 
 void js_debugger_new_context(JSContext *ctx);
 void js_debugger_free_context(JSContext *ctx);
-void js_debugger_check(JSContext *ctx, const uint8_t *pc);
+// checks the step in progress before each instruction, returns 0 once no step is in progress.
+int js_debugger_check(JSContext *ctx, const uint8_t *pc);
+// pauses at a breakpoint.
+void js_debugger_break(JSContext *ctx, const uint8_t *pc);
 void js_debugger_exception(JSContext* ctx);
 void js_debugger_free(JSRuntime *rt, JSDebuggerInfo *info);
 
@@ -73,6 +78,8 @@ void js_debugger_wait_connection(JSContext *ctx, const char* address);
 int js_debugger_is_transport_connected(JSRuntime* rt);
 
 JSValue js_debugger_file_breakpoints(JSContext *ctx, const char *path);
+// reads the messages received by the transport without blocking, called by the embedder between script runs.
+void js_debugger_poll(JSContext *ctx);
 void js_debugger_cooperate(JSContext *ctx);
 
 // begin internal api functions
@@ -86,9 +93,11 @@ uint32_t js_debugger_stack_depth(JSContext *ctx);
 JSValue js_debugger_build_backtrace(JSContext *ctx, const uint8_t *cur_pc);
 JSDebuggerLocation js_debugger_current_location(JSContext *ctx, const uint8_t *cur_pc);
 
-// checks to see if a breakpoint exists on the current pc.
+// replaces the first instruction of the lines with a breakpoint in every loaded function.
 // calls back into js_debugger_file_breakpoints.
-int js_debugger_check_breakpoint(JSContext *ctx, uint32_t current_dirty, const uint8_t *cur_pc);
+void js_debugger_update_breakpoints(JSContext *ctx);
+// restores the instructions replaced by breakpoints.
+void js_debugger_clear_breakpoints(JSRuntime *rt);
 
 JSValue js_debugger_local_variables(JSContext *ctx, int stack_index);
 JSValue js_debugger_closure_variables(JSContext *ctx, int stack_index);
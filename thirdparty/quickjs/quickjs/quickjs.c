@@ -43,6 +43,10 @@
 #elif defined(__linux__)
 #include <malloc.h>
 #endif
+#if defined(__SSE2__) || defined(_M_X64)
+#define JS_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 #include "cutils.h"
 #include "list.h"
@@ -53,6 +57,10 @@
 #include "libregexp.h"
 #ifdef CONFIG_BIGNUM
 #include "libbf.h"
+/* the bignums always come with the operator overloading */
+#ifndef CONFIG_OPERATORS
+#define CONFIG_OPERATORS
+#endif
 #endif
 
 #define OPTIMIZE         1
@@ -163,6 +171,8 @@ enum {
     JS_CLASS_BIG_FLOAT,         /* u.object_data */
     JS_CLASS_FLOAT_ENV,         /* u.float_env */
     JS_CLASS_BIG_DECIMAL,       /* u.object_data */
+#endif
+#ifdef CONFIG_OPERATORS
     JS_CLASS_OPERATOR_SET,      /* u.operator_set */
 #endif
     JS_CLASS_MAP,               /* u.map_state */
@@ -227,6 +237,20 @@ typedef enum {
     JS_GC_PHASE_REMOVE_CYCLES,
 } JSGCPhaseEnum;
 
+/* mark of the objects freed by gc_free_cycles(). The other objects
+   reaching a zero ref_count while the cycles are removed were only
+   referenced by them, which happens when only a part of the objects
+   was collected. */
+#define JS_GC_MARK_CYCLE 10
+
+#ifdef CONFIG_INCREMENTAL_GC
+typedef enum {
+    JS_GC_INC_PHASE_NONE,
+    JS_GC_INC_PHASE_COUNT, /* count the references between the objects */
+    JS_GC_INC_PHASE_SCAN, /* keep the ones referenced from outside */
+} JSGCIncPhaseEnum;
+#endif
+
 typedef enum OPCodeEnum OPCodeEnum;
 
 #ifdef CONFIG_BIGNUM
@@ -272,8 +296,30 @@ struct JSRuntime {
     /* list of JSGCObjectHeader.link. Used during JS_FreeValueRT() */
     struct list_head gc_zero_ref_count_list;
     struct list_head tmp_obj_list; /* used during GC */
+    /* list of JSGCObjectHeader.link. GC objects allocated since the last
+       nursery collection, they are moved to gc_obj_list if they survive
+       it. Empty if there is no nursery */
+    struct list_head gc_young_list;
+    int gc_nursery_size; /* objects allocated between two nursery collections */
+    int gc_young_count;
     JSGCPhaseEnum gc_phase : 8;
     size_t malloc_gc_threshold;
+#ifdef CONFIG_INCREMENTAL_GC
+    /* cycles are collected by JS_RunGCStep() instead of JS_RunGC() */
+    BOOL gc_incremental : 8;
+    BOOL gc_inc_requested : 8;
+    size_t gc_inc_threshold;
+    /* TRUE if the objects may have marks left by a cycle */
+    BOOL gc_inc_marked : 8;
+    JSGCIncPhaseEnum gc_inc_phase : 8;
+    uint32_t gc_inc_cycle;
+    /* objects of the cycle in progress, gc_obj_list only holds the
+       objects created since it started */
+    struct list_head gc_inc_todo_list;
+    struct list_head gc_inc_done_list;
+    struct list_head gc_inc_grey_list;
+    struct list_head gc_inc_white_list;
+#endif
 #ifdef DUMP_LEAKS
     struct list_head string_list; /* list of JSString.link */
 #endif
@@ -313,6 +359,8 @@ struct JSRuntime {
     JSNumericOperations bigint_ops;
     JSNumericOperations bigfloat_ops;
     JSNumericOperations bigdecimal_ops;
+#endif
+#ifdef CONFIG_OPERATORS
     uint32_t operator_count;
 #endif
     void *user_opaque;
@@ -369,6 +417,9 @@ struct JSGCObjectHeader {
     uint8_t mark : 4; /* used by the GC */
     uint8_t dummy1; /* not used by the GC */
     uint16_t dummy2; /* not used by the GC */
+#ifdef CONFIG_INCREMENTAL_GC
+    int gc_ref; /* references from the objects of the incremental cycle */
+#endif
     struct list_head link;
 };
 
@@ -455,6 +506,8 @@ struct JSContext {
     bf_context_t *bf_ctx;   /* points to rt->bf_ctx, shared by all contexts */
     JSFloatEnv fp_env; /* global FP environment */
     BOOL bignum_ext : 8; /* enable math mode */
+#endif
+#ifdef CONFIG_OPERATORS
     BOOL allow_operator_overloading : 8;
 #endif
     /* when the counter reaches zero, JSRutime.interrupt_handler is called */
@@ -581,6 +634,43 @@ typedef enum JSFunctionKindEnum {
     JS_FUNC_ASYNC_GENERATOR = (JS_FUNC_GENERATOR | JS_FUNC_ASYNC),
 } JSFunctionKindEnum;
 
+#ifdef CONFIG_INLINE_CACHE
+/* number of shapes remembered by a property access site */
+#define JS_IC_WAYS 4
+/* maximum number of prototypes walked to reach the cached property */
+#define JS_IC_MAX_DEPTH 8
+
+/* A property found on an object of shape 'shapes[0]'. The property is
+   stored in the object reached after following 'depth' prototypes,
+   'shapes[i]' being the shape of the i-th object of the chain. Only
+   hashed shapes are cached and a reference is kept on each of them:
+   a shared hashed shape is never modified in place (it is cloned
+   first), so a shape pointer always identifies the same layout and
+   prototype. */
+typedef struct JSInlineCacheEntry {
+    uint8_t depth;
+    uint8_t is_getset : 1;
+    uint32_t prop_index;
+    JSShape *shapes[0];
+} JSInlineCacheEntry;
+
+typedef struct JSInlineCacheSite {
+    uint8_t count; /* number of used ways */
+    uint8_t next; /* way replaced on the next miss when all are used */
+    JSInlineCacheEntry *ways[JS_IC_WAYS];
+} JSInlineCacheSite;
+
+/* OP_get_field, OP_get_field2 and OP_put_field sites of a function.
+   These instructions are at least 5 bytes long, so 'site_index[pos / 4]'
+   is unique for each of them: it is the site index plus one of the
+   instruction at offset 'pos', or 0 if the instruction is not cached. */
+typedef struct JSInlineCache {
+    uint32_t site_count;
+    JSInlineCacheSite *sites;
+    uint16_t site_index[0];
+} JSInlineCache;
+#endif
+
 typedef struct JSFunctionBytecode {
     JSGCObjectHeader header; /* must come first */
     uint8_t js_mode;
@@ -611,6 +701,10 @@ typedef struct JSFunctionBytecode {
     JSValue *cpool; /* constant pool (self pointer) */
     int cpool_count;
     int closure_var_count;
+#ifdef CONFIG_INLINE_CACHE
+    /* built on the first property access, must be before 'debug' */
+    JSInlineCache *ic;
+#endif
     struct {
         /* debug info, move to separate structure to save memory? */
         JSAtom filename;
@@ -898,6 +992,8 @@ struct JSObject {
         struct JSTypedArray *typed_array; /* JS_CLASS_UINT8C_ARRAY..JS_CLASS_DATAVIEW */
 #ifdef CONFIG_BIGNUM
         struct JSFloatEnv *float_env; /* JS_CLASS_FLOAT_ENV */
+#endif
+#ifdef CONFIG_OPERATORS
         struct JSOperatorSetData *operator_set; /* JS_CLASS_OPERATOR_SET */
 #endif
         struct JSMapState *map_state;   /* JS_CLASS_MAP..JS_CLASS_WEAKSET */
@@ -997,11 +1093,31 @@ enum OPCodeEnum {
     OP_TEMP_END,
 };
 
+#ifdef QUICKJS_WITH_DEBUGGER
+/* written by the debugger over the first instruction of a line with a
+   breakpoint, the compiler never emits it */
+#define OP_breakpoint 255
+#endif
+
 static int JS_InitAtoms(JSRuntime *rt);
 static JSAtom __JS_NewAtomInit(JSRuntime *rt, const char *str, int len,
                                int atom_type);
 static void JS_FreeAtomStruct(JSRuntime *rt, JSAtomStruct *p);
 static void free_function_bytecode(JSRuntime *rt, JSFunctionBytecode *b);
+#ifdef QUICKJS_WITH_DEBUGGER
+static BOOL js_debugger_enter(JSContext *ctx, JSFunctionBytecode *b);
+static void js_debugger_leave(JSRuntime *rt, JSStackFrame *sf);
+static int js_debugger_trap(JSContext *ctx, JSFunctionBytecode *b,
+                            const uint8_t *pc);
+static void js_debugger_unpatch(JSRuntime *rt, JSFunctionBytecode *b);
+#endif
+#ifdef CONFIG_INLINE_CACHE
+static JSInlineCache *js_inline_cache_new(JSRuntime *rt, JSFunctionBytecode *b);
+static void js_inline_cache_mark(JSRuntime *rt, JSInlineCache *ic,
+                                 JS_MarkFunc *mark_func);
+static void js_inline_cache_free_entry(JSRuntime *rt, JSInlineCacheEntry *e);
+static void js_inline_cache_free(JSRuntime *rt, JSInlineCache *ic);
+#endif
 static JSValue js_call_c_function(JSContext *ctx, JSValueConst func_obj,
                                   JSValueConst this_obj,
                                   int argc, JSValueConst *argv, int flags);
@@ -1088,7 +1204,7 @@ static void js_promise_mark(JSRuntime *rt, JSValueConst val,
 static void js_promise_resolve_function_finalizer(JSRuntime *rt, JSValue val);
 static void js_promise_resolve_function_mark(JSRuntime *rt, JSValueConst val,
                                 JS_MarkFunc *mark_func);
-#ifdef CONFIG_BIGNUM
+#ifdef CONFIG_OPERATORS
 static void js_operator_set_finalizer(JSRuntime *rt, JSValue val);
 static void js_operator_set_mark(JSRuntime *rt, JSValueConst val,
                                  JS_MarkFunc *mark_func);
@@ -1103,6 +1219,11 @@ static JSValue js_compile_regexp(JSContext *ctx, JSValueConst pattern,
 static JSValue js_regexp_constructor_internal(JSContext *ctx, JSValueConst ctor,
                                               JSValue pattern, JSValue bc);
 static void gc_decref(JSRuntime *rt);
+static void gc_gather_objects(JSRuntime *rt);
+static void gc_collect_young(JSRuntime *rt);
+#ifdef CONFIG_INCREMENTAL_GC
+static void gc_inc_abort(JSRuntime *rt);
+#endif
 static int JS_NewClass1(JSRuntime *rt, JSClassID class_id,
                         const JSClassDef *class_def, JSAtom name);
 
@@ -1269,6 +1390,19 @@ static void js_trigger_gc(JSRuntime *rt, size_t size)
 #else
     force_gc = ((rt->malloc_state.malloc_size + size) >
                 rt->malloc_gc_threshold);
+#endif
+    if (rt->gc_nursery_size && rt->gc_young_count >= rt->gc_nursery_size &&
+        rt->gc_phase == JS_GC_PHASE_NONE) {
+        gc_collect_young(rt);
+    }
+#ifdef CONFIG_INCREMENTAL_GC
+    /* JS_RunGCStep() starts well before the threshold of JS_RunGC(),
+       which is only reached if the heap grows faster than the cycles
+       are collected */
+    if (rt->gc_incremental &&
+        (rt->malloc_state.malloc_size + size) > rt->gc_inc_threshold) {
+        rt->gc_inc_requested = TRUE;
+    }
 #endif
     if (force_gc) {
 #ifdef DUMP_GC
@@ -1485,6 +1619,8 @@ static JSClassShortDef const js_std_class_def[] = {
     { JS_ATOM_BigFloat, js_object_data_finalizer, js_object_data_mark },    /* JS_CLASS_BIG_FLOAT */
     { JS_ATOM_BigFloatEnv, js_float_env_finalizer, NULL },      /* JS_CLASS_FLOAT_ENV */
     { JS_ATOM_BigDecimal, js_object_data_finalizer, js_object_data_mark },    /* JS_CLASS_BIG_DECIMAL */
+#endif
+#ifdef CONFIG_OPERATORS
     { JS_ATOM_OperatorSet, js_operator_set_finalizer, js_operator_set_mark },    /* JS_CLASS_OPERATOR_SET */
 #endif
     { JS_ATOM_Map, js_map_finalizer, js_map_mark },             /* JS_CLASS_MAP */
@@ -1631,7 +1767,14 @@ JSRuntime *JS_NewRuntime2(const JSMallocFunctions *mf, void *opaque)
     init_list_head(&rt->context_list);
     init_list_head(&rt->gc_obj_list);
     init_list_head(&rt->gc_zero_ref_count_list);
+    init_list_head(&rt->gc_young_list);
     rt->gc_phase = JS_GC_PHASE_NONE;
+#ifdef CONFIG_INCREMENTAL_GC
+    init_list_head(&rt->gc_inc_todo_list);
+    init_list_head(&rt->gc_inc_done_list);
+    init_list_head(&rt->gc_inc_grey_list);
+    init_list_head(&rt->gc_inc_white_list);
+#endif
 
 #ifdef DUMP_LEAKS
     init_list_head(&rt->string_list);
@@ -3122,7 +3265,7 @@ JSValue JS_AtomToString(JSContext *ctx, JSAtom atom)
 
 /* return TRUE if the atom is an array index (i.e. 0 <= index <=
    2^32-2 and return its value */
-static BOOL JS_AtomIsArrayIndex(JSContext *ctx, uint32_t *pval, JSAtom atom)
+JS_BOOL JS_AtomIsArrayIndex(JSContext *ctx, uint32_t *pval, JSAtom atom)
 {
     if (__JS_AtomIsTaggedInt(atom)) {
         *pval = __JS_AtomToUInt32(atom);
@@ -3920,6 +4063,166 @@ JSValue JS_NewStringLen(JSContext *ctx, const char *buf, size_t buf_len)
     return JS_EXCEPTION;
 }
 
+/* copy the code points of 'src' to 'dst' truncated to 8 bits. Return
+   the OR of the code points, so the copy is valid if it is <= 0xff */
+static uint32_t utf32_to_8(uint8_t *dst, const uint32_t *src, size_t len)
+{
+    size_t i = 0;
+    uint32_t acc = 0;
+#ifdef JS_USE_SSE2
+    __m128i a, b, c, d, vacc = _mm_setzero_si128();
+    for(; i + 16 <= len; i += 16) {
+        a = _mm_loadu_si128((const __m128i *)(src + i));
+        b = _mm_loadu_si128((const __m128i *)(src + i + 4));
+        c = _mm_loadu_si128((const __m128i *)(src + i + 8));
+        d = _mm_loadu_si128((const __m128i *)(src + i + 12));
+        vacc = _mm_or_si128(vacc, _mm_or_si128(_mm_or_si128(a, b),
+                                               _mm_or_si128(c, d)));
+        /* the saturation only changes the values above 0xff */
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                          _mm_packs_epi32(c, d)));
+    }
+    vacc = _mm_or_si128(vacc, _mm_srli_si128(vacc, 8));
+    vacc = _mm_or_si128(vacc, _mm_srli_si128(vacc, 4));
+    acc = _mm_cvtsi128_si32(vacc);
+#endif
+    for(; i < len; i++) {
+        acc |= src[i];
+        dst[i] = src[i];
+    }
+    return acc;
+}
+
+/* Build a string from UTF-32 code points without going through UTF-8.
+   The invalid code points are replaced by U+FFFD. */
+JSValue JS_NewStringUTF32(JSContext *ctx, const uint32_t *buf, size_t len)
+{
+    JSString *str;
+    uint16_t *q;
+    size_t i, len16;
+    uint32_t c;
+
+    if (len == 0)
+        return JS_AtomToString(ctx, JS_ATOM_empty_string);
+    if (len > JS_STRING_LEN_MAX)
+        return JS_ThrowInternalError(ctx, "string too long");
+    /* most strings fit in 8 bits */
+    str = js_alloc_string(ctx, len, 0);
+    if (!str)
+        return JS_EXCEPTION;
+    if (utf32_to_8(str->u.str8, buf, len) <= 0xff) {
+        str->u.str8[len] = '\0';
+        return JS_MKPTR(JS_TAG_STRING, str);
+    }
+    JS_FreeValue(ctx, JS_MKPTR(JS_TAG_STRING, str));
+
+    /* the code points above 0xffff take a surrogate pair */
+    len16 = len;
+    for(i = 0; i < len; i++)
+        len16 += (buf[i] - 0x10000) <= (0x10ffff - 0x10000);
+    if (len16 > JS_STRING_LEN_MAX)
+        return JS_ThrowInternalError(ctx, "string too long");
+    str = js_alloc_string(ctx, len16, 1);
+    if (!str)
+        return JS_EXCEPTION;
+    q = str->u.str16;
+    for(i = 0; i < len; i++) {
+        c = buf[i];
+        if (c < 0x10000) {
+            *q++ = c;
+        } else if (c <= 0x10ffff) {
+            c -= 0x10000;
+            *q++ = (c >> 10) + 0xd800;
+            *q++ = (c & 0x3ff) + 0xdc00;
+        } else {
+            *q++ = 0xfffd;
+        }
+    }
+    return JS_MKPTR(JS_TAG_STRING, str);
+}
+
+/* Return the number of code points of the string 'val' and copy them
+   to 'buf' if not NULL. The surrogate pairs give one code point, the
+   unpaired surrogates are kept. */
+size_t JS_GetStringUTF32(JSValueConst val, uint32_t *buf)
+{
+    JSString *p = JS_VALUE_GET_STRING(val);
+    const uint16_t *src;
+    size_t i, j, len;
+    uint32_t c, c1;
+
+    len = p->len;
+    if (!p->is_wide_char) {
+        if (buf) {
+            const uint8_t *src8 = p->u.str8;
+            i = 0;
+#ifdef JS_USE_SSE2
+            for(; i + 16 <= len; i += 16) {
+                __m128i a, lo, hi, zero = _mm_setzero_si128();
+                a = _mm_loadu_si128((const __m128i *)(src8 + i));
+                lo = _mm_unpacklo_epi8(a, zero);
+                hi = _mm_unpackhi_epi8(a, zero);
+                _mm_storeu_si128((__m128i *)(buf + i), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128((__m128i *)(buf + i + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128((__m128i *)(buf + i + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128((__m128i *)(buf + i + 12), _mm_unpackhi_epi16(hi, zero));
+            }
+#endif
+            for(; i < len; i++)
+                buf[i] = src8[i];
+        }
+        return len;
+    }
+    src = p->u.str16;
+    i = j = 0;
+    while (i < len) {
+#ifdef JS_USE_SSE2
+        if (i + 8 <= len) {
+            __m128i a, zero = _mm_setzero_si128();
+            a = _mm_loadu_si128((const __m128i *)(src + i));
+            /* no surrogate in the next 8 code units */
+            if (!_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(a, _mm_set1_epi16(0xf800)),
+                                                   _mm_set1_epi16(0xd800)))) {
+                if (buf) {
+                    _mm_storeu_si128((__m128i *)(buf + j), _mm_unpacklo_epi16(a, zero));
+                    _mm_storeu_si128((__m128i *)(buf + j + 4), _mm_unpackhi_epi16(a, zero));
+                }
+                i += 8;
+                j += 8;
+                continue;
+            }
+        }
+#endif
+        c = src[i++];
+        if (c >= 0xd800 && c < 0xdc00 && i < len) {
+            c1 = src[i];
+            if (c1 >= 0xdc00 && c1 < 0xe000) {
+                c = (((c & 0x3ff) << 10) | (c1 & 0x3ff)) + 0x10000;
+                i++;
+            }
+        }
+        if (buf)
+            buf[j] = c;
+        j++;
+    }
+    return j;
+}
+
+/* Return the atom of 'val' if it is an interned string, like the string
+   literals, or JS_ATOM_NULL. The atom is not duplicated. */
+JSAtom JS_GetStringAtom(JSContext *ctx, JSValueConst val)
+{
+    JSString *p;
+
+    if (JS_VALUE_GET_TAG(val) != JS_TAG_STRING)
+        return JS_ATOM_NULL;
+    p = JS_VALUE_GET_STRING(val);
+    if (p->atom_type != JS_ATOM_TYPE_STRING)
+        return JS_ATOM_NULL;
+    return js_get_atom_index(ctx->rt, p);
+}
+
 static JSValue JS_ConcatString3(JSContext *ctx, const char *str1,
                                 JSValue str2, const char *str3)
 {
@@ -4451,6 +4754,7 @@ static no_inline int resize_properties(JSContext *ctx, JSShape **psh,
     JSShapeProperty *pr;
     void *sh_alloc;
     intptr_t h;
+    struct list_head *gc_link;
 
     sh = *psh;
     new_size = max_int(count, sh->prop_size * 3 / 2);
@@ -4474,11 +4778,14 @@ static no_inline int resize_properties(JSContext *ctx, JSShape **psh,
         if (!sh_alloc)
             return -1;
         sh = get_shape_from_alloc(sh_alloc, new_hash_size);
+        /* the shape keeps its place in the GC lists, they may be
+           walked by an incremental GC cycle */
+        gc_link = old_sh->header.link.prev;
         list_del(&old_sh->header.link);
         /* copy all the fields and the properties */
         memcpy(sh, old_sh,
                sizeof(JSShape) + sizeof(sh->prop[0]) * old_sh->prop_count);
-        list_add_tail(&sh->header.link, &ctx->rt->gc_obj_list);
+        list_add(&sh->header.link, gc_link);
         new_hash_mask = new_hash_size - 1;
         sh->prop_hash_mask = new_hash_mask;
         memset(prop_hash_end(sh) - new_hash_size, 0,
@@ -4493,16 +4800,18 @@ static no_inline int resize_properties(JSContext *ctx, JSShape **psh,
         js_free(ctx, get_alloc_from_shape(old_sh));
     } else {
         /* only resize the properties */
+        gc_link = sh->header.link.prev;
         list_del(&sh->header.link);
         sh_alloc = js_realloc(ctx, get_alloc_from_shape(sh),
                               get_shape_size(new_hash_size, new_size));
         if (unlikely(!sh_alloc)) {
-            /* insert again in the GC list */
+            /* insert again in the GC list. Throwing the exception may
+               have run the GC, which can have freed the neighbour */
             list_add_tail(&sh->header.link, &ctx->rt->gc_obj_list);
             return -1;
         }
         sh = get_shape_from_alloc(sh_alloc, new_hash_size);
-        list_add_tail(&sh->header.link, &ctx->rt->gc_obj_list);
+        list_add(&sh->header.link, gc_link);
     }
     *psh = sh;
     sh->prop_size = new_size;
@@ -4518,6 +4827,7 @@ static int compact_properties(JSContext *ctx, JSObject *p)
     uint32_t new_hash_size, i, j, new_hash_mask, new_size;
     JSShapeProperty *old_pr, *pr;
     JSProperty *prop, *new_prop;
+    struct list_head *gc_link;
 
     sh = p->shape;
     assert(!sh->is_hashed);
@@ -4537,9 +4847,10 @@ static int compact_properties(JSContext *ctx, JSObject *p)
     if (!sh_alloc)
         return -1;
     sh = get_shape_from_alloc(sh_alloc, new_hash_size);
+    gc_link = old_sh->header.link.prev;
     list_del(&old_sh->header.link);
     memcpy(sh, old_sh, sizeof(JSShape));
-    list_add_tail(&sh->header.link, &ctx->rt->gc_obj_list);
+    list_add(&sh->header.link, gc_link);
 
     memset(prop_hash_end(sh) - new_hash_size, 0,
            sizeof(prop_hash_end(sh)[0]) * new_hash_size);
@@ -5509,6 +5820,10 @@ void __JS_FreeValueRT(JSRuntime *rt, JSValue v)
                 if (rt->gc_phase == JS_GC_PHASE_NONE) {
                     free_zero_refcount(rt);
                 }
+            } else if (p->mark != JS_GC_MARK_CYCLE) {
+                /* freed by gc_free_cycles() once the cycles are gone */
+                list_del(&p->link);
+                list_add_tail(&p->link, &rt->gc_zero_ref_count_list);
             }
         }
         break;
@@ -5551,12 +5866,60 @@ void __JS_FreeValue(JSContext *ctx, JSValue v)
 
 /* garbage collection */
 
+/* marks of the nursery collection */
+#define JS_GC_MARK_YOUNG         8
+#define JS_GC_MARK_YOUNG_SCANNED 9
+
+#ifdef CONFIG_INCREMENTAL_GC
+/* marks of JS_RunGCStep() */
+#define JS_GC_MARK_GREY  2 /* kept, children not visited yet */
+#define JS_GC_MARK_WHITE 3 /* candidate for collection */
+#define JS_GC_MARK_BLACK 4 /* kept, 4 or 5 */
+#define JS_GC_MARK_NEW   6 /* created during the cycle, 6 or 7 */
+
+/* bytes allocated at most before the next cycle is started */
+#define JS_GC_INC_ALLOC_MAX (1024 * 1024)
+
+static inline int gc_inc_mark_black(JSRuntime *rt)
+{
+    return JS_GC_MARK_BLACK + (rt->gc_inc_cycle & 1);
+}
+
+static inline int gc_inc_mark_new(JSRuntime *rt)
+{
+    return JS_GC_MARK_NEW + (rt->gc_inc_cycle & 1);
+}
+#endif
+
+/* move the elements of 'src' at the end of 'dst' */
+static void gc_list_splice(struct list_head *dst, struct list_head *src)
+{
+    if (list_empty(src))
+        return;
+    src->next->prev = dst->prev;
+    dst->prev->next = src->next;
+    src->prev->next = dst;
+    dst->prev = src->prev;
+    init_list_head(src);
+}
+
 static void add_gc_object(JSRuntime *rt, JSGCObjectHeader *h,
                           JSGCObjectTypeEnum type)
 {
+#ifdef CONFIG_INCREMENTAL_GC
+    /* not part of the cycle in progress */
+    h->mark = rt->gc_inc_phase != JS_GC_INC_PHASE_NONE ? gc_inc_mark_new(rt) : 0;
+    h->gc_ref = 0;
+#else
     h->mark = 0;
+#endif
     h->gc_obj_type = type;
-    list_add_tail(&h->link, &rt->gc_obj_list);
+    if (rt->gc_nursery_size) {
+        list_add_tail(&h->link, &rt->gc_young_list);
+        rt->gc_young_count++;
+    } else {
+        list_add_tail(&h->link, &rt->gc_obj_list);
+    }
 }
 
 static void remove_gc_object(JSGCObjectHeader *h)
@@ -5635,6 +5998,10 @@ static void mark_children(JSRuntime *rt, JSGCObjectHeader *gp,
             }
             if (b->realm)
                 mark_func(rt, &b->realm->header);
+#ifdef CONFIG_INLINE_CACHE
+            if (b->ic)
+                js_inline_cache_mark(rt, b->ic, mark_func);
+#endif
         }
         break;
     case JS_GC_OBJ_TYPE_VAR_REF:
@@ -5745,11 +6112,16 @@ static void gc_scan(JSRuntime *rt)
 static void gc_free_cycles(JSRuntime *rt)
 {
     struct list_head *el, *el1;
+    struct list_head zero_ref_list;
     JSGCObjectHeader *p;
 #ifdef DUMP_GC_FREE
     BOOL header_done = FALSE;
 #endif
 
+    list_for_each(el, &rt->tmp_obj_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        p->mark = JS_GC_MARK_CYCLE;
+    }
     rt->gc_phase = JS_GC_PHASE_REMOVE_CYCLES;
 
     for(;;) {
@@ -5781,18 +6153,33 @@ static void gc_free_cycles(JSRuntime *rt)
     }
     rt->gc_phase = JS_GC_PHASE_NONE;
 
+    /* the objects outside of the cycles which were only referenced by
+       them, after a nursery or incremental collection */
+    init_list_head(&zero_ref_list);
     list_for_each_safe(el, el1, &rt->gc_zero_ref_count_list) {
         p = list_entry(el, JSGCObjectHeader, link);
         assert(p->gc_obj_type == JS_GC_OBJ_TYPE_JS_OBJECT ||
                p->gc_obj_type == JS_GC_OBJ_TYPE_FUNCTION_BYTECODE);
-        js_free_rt(rt, p);
+        list_del(&p->link);
+        if (p->mark != JS_GC_MARK_CYCLE)
+            list_add_tail(&p->link, &zero_ref_list);
+        else
+            js_free_rt(rt, p);
     }
 
     init_list_head(&rt->gc_zero_ref_count_list);
+    if (!list_empty(&zero_ref_list)) {
+        gc_list_splice(&rt->gc_zero_ref_count_list, &zero_ref_list);
+        free_zero_refcount(rt);
+    }
 }
 
 void JS_RunGC(JSRuntime *rt)
 {
+    gc_gather_objects(rt);
+#ifdef CONFIG_INCREMENTAL_GC
+    rt->gc_inc_requested = FALSE;
+#endif
     /* decrement the reference of the children of each object. mark =
        1 after this pass. */
     gc_decref(rt);
@@ -5804,6 +6191,360 @@ void JS_RunGC(JSRuntime *rt)
     gc_free_cycles(rt);
 }
 
+/* put all the GC objects in gc_obj_list with their marks cleared, as
+   expected by JS_RunGC() and the functions walking all the objects */
+static void gc_gather_objects(JSRuntime *rt)
+{
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_young_list);
+    rt->gc_young_count = 0;
+#ifdef CONFIG_INCREMENTAL_GC
+    /* the cycles of the incremental collection are found again by
+       JS_RunGC() */
+    gc_inc_abort(rt);
+#endif
+}
+
+/* Nursery collection.
+
+   Most cycles are made of objects which die young, like the closures
+   of a function call. The trial deletion of JS_RunGC() is run on the
+   young objects only: the references from the older objects count as
+   external references, so no write barrier is needed and the cycles
+   going through old objects are left to JS_RunGC(). Only the young
+   objects are walked, so it can run often. */
+
+static void gc_young_decref_child(JSRuntime *rt, JSGCObjectHeader *p)
+{
+    if (p->mark >= JS_GC_MARK_YOUNG) {
+        assert(p->ref_count > 0);
+        p->ref_count--;
+        if (p->ref_count == 0 && p->mark == JS_GC_MARK_YOUNG_SCANNED) {
+            list_del(&p->link);
+            list_add_tail(&p->link, &rt->tmp_obj_list);
+        }
+    }
+}
+
+static void gc_young_incref_child(JSRuntime *rt, JSGCObjectHeader *p)
+{
+    if (p->mark == JS_GC_MARK_YOUNG_SCANNED) {
+        p->ref_count++;
+        if (p->ref_count == 1) {
+            /* ref_count was 0: remove from tmp_obj_list and add at the
+               end of gc_young_list */
+            list_del(&p->link);
+            list_add_tail(&p->link, &rt->gc_young_list);
+        }
+    }
+}
+
+static void gc_young_incref_child2(JSRuntime *rt, JSGCObjectHeader *p)
+{
+    if (p->mark == JS_GC_MARK_YOUNG_SCANNED)
+        p->ref_count++;
+}
+
+static void gc_collect_young(JSRuntime *rt)
+{
+    struct list_head *el, *el1;
+    JSGCObjectHeader *p;
+    int mark;
+
+    init_list_head(&rt->tmp_obj_list);
+    list_for_each(el, &rt->gc_young_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        p->mark = JS_GC_MARK_YOUNG;
+    }
+    /* same as gc_decref() */
+    list_for_each_safe(el, el1, &rt->gc_young_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        mark_children(rt, p, gc_young_decref_child);
+        p->mark = JS_GC_MARK_YOUNG_SCANNED;
+        if (p->ref_count == 0) {
+            list_del(&p->link);
+            list_add_tail(&p->link, &rt->tmp_obj_list);
+        }
+    }
+    /* same as gc_scan() */
+    list_for_each(el, &rt->gc_young_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        mark_children(rt, p, gc_young_incref_child);
+    }
+    list_for_each(el, &rt->tmp_obj_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        mark_children(rt, p, gc_young_incref_child2);
+    }
+
+    /* the survivors are promoted */
+#ifdef CONFIG_INCREMENTAL_GC
+    mark = rt->gc_inc_phase != JS_GC_INC_PHASE_NONE ? gc_inc_mark_new(rt) : 0;
+#else
+    mark = 0;
+#endif
+    list_for_each(el, &rt->gc_young_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        p->mark = mark;
+    }
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_young_list);
+    rt->gc_young_count = 0;
+
+    gc_free_cycles(rt);
+}
+
+void JS_SetGCNurserySize(JSRuntime *rt, int size)
+{
+    if (size <= 0) {
+        gc_list_splice(&rt->gc_obj_list, &rt->gc_young_list);
+        rt->gc_young_count = 0;
+        size = 0;
+    }
+    rt->gc_nursery_size = size;
+}
+
+#ifdef CONFIG_INCREMENTAL_GC
+
+/* Incremental cycle collection.
+
+   The objects of gc_obj_list are taken out at the start of a cycle and
+   visited a few at a time by JS_RunGCStep(), so the mutator runs
+   between two steps:
+   - COUNT counts in gc_ref the references between the objects of the
+     cycle. ref_count is left untouched since the mutator still uses
+     it. The objects created during the cycle stay in gc_obj_list or the
+     nursery, they are marked as new and are not part of the cycle.
+   - SCAN keeps the objects with more references than gc_ref and all
+     the objects reachable from them (grey list). The other ones are
+     put in the white list.
+   The counts go stale when the mutator changes the references between
+   two steps, so the white list is only a set of candidates. It is
+   checked without interruption in gc_inc_collect() by running the same
+   trial deletion on the candidates alone, which only takes time in
+   proportion to the garbage. This makes write barriers unnecessary: a
+   reference stored after its source was visited is always seen by the
+   final check.
+
+   The kept and new objects keep their mark at the end of a cycle, the
+   marks of the next cycle are told apart by the parity of gc_inc_cycle. */
+
+static void gc_inc_reset_list(struct list_head *head)
+{
+    struct list_head *el;
+    JSGCObjectHeader *p;
+
+    list_for_each(el, head) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        p->mark = 0;
+        p->gc_ref = 0;
+    }
+}
+
+/* give all the objects back to gc_obj_list with their marks cleared,
+   as expected by JS_RunGC() */
+static void gc_inc_abort(JSRuntime *rt)
+{
+    if (!rt->gc_inc_marked)
+        return;
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_inc_todo_list);
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_inc_done_list);
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_inc_grey_list);
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_inc_white_list);
+    gc_inc_reset_list(&rt->gc_obj_list);
+    rt->gc_inc_phase = JS_GC_INC_PHASE_NONE;
+    rt->gc_inc_marked = FALSE;
+}
+
+static void gc_inc_count_child(JSRuntime *rt, JSGCObjectHeader *p)
+{
+    if (p->mark != gc_inc_mark_new(rt))
+        p->gc_ref++;
+}
+
+static void gc_inc_count_white_child(JSRuntime *rt, JSGCObjectHeader *p)
+{
+    if (p->mark == JS_GC_MARK_WHITE)
+        p->gc_ref++;
+}
+
+static void gc_inc_grey_child(JSRuntime *rt, JSGCObjectHeader *p)
+{
+    if (p->mark != JS_GC_MARK_GREY && p->mark != gc_inc_mark_black(rt) &&
+        p->mark != gc_inc_mark_new(rt)) {
+        p->mark = JS_GC_MARK_GREY;
+        list_del(&p->link);
+        list_add_tail(&p->link, &rt->gc_inc_grey_list);
+    }
+}
+
+/* visit the children of the grey objects, returns the remaining budget */
+static int gc_inc_drain_grey(JSRuntime *rt, int budget)
+{
+    struct list_head *el;
+    JSGCObjectHeader *p;
+
+    while (budget > 0) {
+        el = rt->gc_inc_grey_list.next;
+        if (el == &rt->gc_inc_grey_list)
+            break;
+        p = list_entry(el, JSGCObjectHeader, link);
+        p->mark = gc_inc_mark_black(rt);
+        p->gc_ref = 0;
+        list_del(&p->link);
+        list_add_tail(&p->link, &rt->gc_inc_done_list);
+        mark_children(rt, p, gc_inc_grey_child);
+        budget--;
+    }
+    return budget;
+}
+
+/* the cycles are started often since the pause of the final check
+   grows with the garbage found by a cycle */
+static void gc_inc_set_thresholds(JSRuntime *rt)
+{
+    size_t size = rt->malloc_state.malloc_size;
+    size_t growth = size >> 3;
+    if (growth > JS_GC_INC_ALLOC_MAX)
+        growth = JS_GC_INC_ALLOC_MAX;
+    rt->gc_inc_threshold = size + growth;
+    rt->malloc_gc_threshold = size * 2;
+}
+
+/* check the white objects with up to date counts and free the ones
+   which are only referenced by each other */
+static void gc_inc_collect(JSRuntime *rt)
+{
+    struct list_head *el, *el1;
+    JSGCObjectHeader *p;
+
+    /* gc_ref was cleared when they were put in the white list */
+    list_for_each(el, &rt->gc_inc_white_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        mark_children(rt, p, gc_inc_count_white_child);
+    }
+    list_for_each_safe(el, el1, &rt->gc_inc_white_list) {
+        p = list_entry(el, JSGCObjectHeader, link);
+        if (p->ref_count > p->gc_ref) {
+            p->mark = JS_GC_MARK_GREY;
+            list_del(&p->link);
+            list_add_tail(&p->link, &rt->gc_inc_grey_list);
+        }
+    }
+    gc_inc_drain_grey(rt, INT32_MAX);
+
+    gc_list_splice(&rt->gc_obj_list, &rt->gc_inc_done_list);
+    rt->gc_inc_phase = JS_GC_INC_PHASE_NONE;
+    /* the requests made during the cycle are satisfied */
+    rt->gc_inc_requested = FALSE;
+
+    /* the remaining white objects are garbage, their marks do not
+       matter anymore */
+    init_list_head(&rt->tmp_obj_list);
+    gc_list_splice(&rt->tmp_obj_list, &rt->gc_inc_white_list);
+    gc_free_cycles(rt);
+
+    gc_inc_set_thresholds(rt);
+}
+
+void JS_SetGCIncremental(JSRuntime *rt, BOOL enabled)
+{
+    if (enabled)
+        gc_inc_set_thresholds(rt);
+    else
+        gc_inc_abort(rt);
+    rt->gc_incremental = enabled;
+}
+
+BOOL JS_IsGCIncremental(JSRuntime *rt)
+{
+    return rt->gc_incremental;
+}
+
+void JS_RequestGCStep(JSRuntime *rt)
+{
+    if (rt->gc_incremental)
+        rt->gc_inc_requested = TRUE;
+}
+
+BOOL JS_RunGCStep(JSRuntime *rt, int budget)
+{
+    struct list_head *el;
+    JSGCObjectHeader *p;
+
+    if (rt->gc_phase != JS_GC_PHASE_NONE)
+        return TRUE;
+    if (rt->gc_inc_phase == JS_GC_INC_PHASE_NONE) {
+        if (!rt->gc_inc_requested)
+            return TRUE;
+        rt->gc_inc_requested = FALSE;
+        rt->gc_inc_cycle++;
+        rt->gc_inc_marked = TRUE;
+        gc_list_splice(&rt->gc_inc_todo_list, &rt->gc_obj_list);
+        /* the objects of the nursery must not be left out of the
+           cycle, their marks would be taken for members */
+        gc_list_splice(&rt->gc_inc_todo_list, &rt->gc_young_list);
+        rt->gc_young_count = 0;
+        rt->gc_inc_phase = JS_GC_INC_PHASE_COUNT;
+    }
+
+    while (budget > 0) {
+        if (rt->gc_inc_phase == JS_GC_INC_PHASE_COUNT) {
+            el = rt->gc_inc_todo_list.next;
+            if (el == &rt->gc_inc_todo_list) {
+                gc_list_splice(&rt->gc_inc_todo_list, &rt->gc_inc_done_list);
+                rt->gc_inc_phase = JS_GC_INC_PHASE_SCAN;
+                continue;
+            }
+            p = list_entry(el, JSGCObjectHeader, link);
+            mark_children(rt, p, gc_inc_count_child);
+            list_del(&p->link);
+            list_add_tail(&p->link, &rt->gc_inc_done_list);
+            budget--;
+        } else {
+            budget = gc_inc_drain_grey(rt, budget);
+            if (budget <= 0)
+                break;
+            el = rt->gc_inc_todo_list.next;
+            if (el == &rt->gc_inc_todo_list) {
+                gc_inc_collect(rt);
+                return TRUE;
+            }
+            p = list_entry(el, JSGCObjectHeader, link);
+            list_del(&p->link);
+            if (p->ref_count > p->gc_ref) {
+                p->mark = JS_GC_MARK_GREY;
+                list_add_tail(&p->link, &rt->gc_inc_grey_list);
+            } else {
+                p->mark = JS_GC_MARK_WHITE;
+                p->gc_ref = 0;
+                list_add_tail(&p->link, &rt->gc_inc_white_list);
+                budget--;
+            }
+        }
+    }
+    return FALSE;
+}
+
+#else
+
+void JS_SetGCIncremental(JSRuntime *rt, BOOL enabled)
+{
+}
+
+BOOL JS_IsGCIncremental(JSRuntime *rt)
+{
+    return FALSE;
+}
+
+void JS_RequestGCStep(JSRuntime *rt)
+{
+}
+
+BOOL JS_RunGCStep(JSRuntime *rt, int budget)
+{
+    return TRUE;
+}
+
+#endif /* CONFIG_INCREMENTAL_GC */
+
 /* Return false if not an object or if the object has already been
    freed (zombie objects are visible in finalizers when freeing
    cycles). */
@@ -5907,6 +6648,8 @@ void JS_ComputeMemoryUsage(JSRuntime *rt, JSMemoryUsage *s)
     s->malloc_size = rt->malloc_state.malloc_size;
     s->malloc_limit = rt->malloc_state.malloc_limit;
 
+    /* all the objects must be in gc_obj_list */
+    gc_gather_objects(rt);
     s->memory_used_count = 2; /* rt + rt->class_array */
     s->memory_used_size = sizeof(JSRuntime) + sizeof(JSValue) * rt->class_count;
 
@@ -12297,6 +13040,10 @@ static JSValue JS_CompactBigInt(JSContext *ctx, JSValue val)
     return JS_CompactBigInt1(ctx, val, is_math_mode(ctx));
 }
 
+#endif /* CONFIG_BIGNUM */
+
+#ifdef CONFIG_OPERATORS
+
 /* must be kept in sync with JSOverloadableOperatorEnum */
 /* XXX: use atoms ? */
 static const char js_overloadable_operator_names[JS_OVOP_COUNT][4] = {
@@ -12333,7 +13080,9 @@ static int get_ovop_from_opcode(OPCodeEnum op)
     case OP_div:
         return JS_OVOP_DIV;
     case OP_mod:
+#ifdef CONFIG_BIGNUM
     case OP_math_mod:
+#endif
         return JS_OVOP_MOD;
     case OP_pow:
         return JS_OVOP_POW;
@@ -12365,6 +13114,8 @@ static int get_ovop_from_opcode(OPCodeEnum op)
         return JS_OVOP_INC;
     case OP_dec:
         return JS_OVOP_DEC;
+    case OP_not:
+        return JS_OVOP_NOT;
     default:
         abort();
     }
@@ -12514,22 +13265,22 @@ static __exception int js_call_binary_op_fallback(JSContext *ctx,
     return -1;
 }
 
-/* try to call the operation on the operatorSet field of 'obj'. Only
-   used for "/" and "**" on the BigInt prototype in math mode */
-static __exception int js_call_binary_op_simple(JSContext *ctx,
-                                                JSValue *pret,
-                                                JSValueConst obj,
-                                                JSValueConst op1,
-                                                JSValueConst op2,
-                                                OPCodeEnum op)
+/* return -1 if exception, 0 if no operator overloading, 1 if
+   overloaded operator called */
+static __exception int js_call_unary_op_fallback(JSContext *ctx,
+                                                 JSValue *pret,
+                                                 JSValueConst op1,
+                                                 OPCodeEnum op)
 {
-    JSValue opset1_obj, method, ret, new_op1, new_op2;
+    JSValue opset1_obj, method, ret;
     JSOperatorSetData *opset1;
     JSOverloadableOperatorEnum ovop;
     JSObject *p;
-    JSValueConst args[2];
 
-    opset1_obj = JS_GetProperty(ctx, obj, JS_ATOM_Symbol_operatorSet);
+    if (!ctx->allow_operator_overloading)
+        return 0;
+
+    opset1_obj = JS_GetProperty(ctx, op1, JS_ATOM_Symbol_operatorSet);
     if (JS_IsException(opset1_obj))
         goto exception;
     if (JS_IsUndefined(opset1_obj))
@@ -12537,29 +13288,21 @@ static __exception int js_call_binary_op_simple(JSContext *ctx,
     opset1 = JS_GetOpaque2(ctx, opset1_obj, JS_CLASS_OPERATOR_SET);
     if (!opset1)
         goto exception;
-    ovop = get_ovop_from_opcode(op);
-
-    p = opset1->self_ops[ovop];
-    if (!p) {
+    if (opset1->is_primitive) {
         JS_FreeValue(ctx, opset1_obj);
         return 0;
     }
 
-    new_op1 = JS_ToNumeric(ctx, op1);
-    if (JS_IsException(new_op1))
-        goto exception;
-    new_op2 = JS_ToNumeric(ctx, op2);
-    if (JS_IsException(new_op2)) {
-        JS_FreeValue(ctx, new_op1);
+    ovop = get_ovop_from_opcode(op);
+
+    p = opset1->self_ops[ovop];
+    if (!p) {
+        JS_ThrowTypeError(ctx, "no overloaded operator %s",
+                          js_overloadable_operator_names[ovop]);
         goto exception;
     }
-
     method = JS_DupValue(ctx, JS_MKPTR(JS_TAG_OBJECT, p));
-    args[0] = new_op1;
-    args[1] = new_op2;
-    ret = JS_CallFree(ctx, method, JS_UNDEFINED, 2, args);
-    JS_FreeValue(ctx, new_op1);
-    JS_FreeValue(ctx, new_op2);
+    ret = JS_CallFree(ctx, method, JS_UNDEFINED, 1, &op1);
     if (JS_IsException(ret))
         goto exception;
     JS_FreeValue(ctx, opset1_obj);
@@ -12571,22 +13314,26 @@ static __exception int js_call_binary_op_simple(JSContext *ctx,
     return -1;
 }
 
-/* return -1 if exception, 0 if no operator overloading, 1 if
-   overloaded operator called */
-static __exception int js_call_unary_op_fallback(JSContext *ctx,
-                                                 JSValue *pret,
-                                                 JSValueConst op1,
-                                                 OPCodeEnum op)
+#endif /* CONFIG_OPERATORS */
+
+#ifdef CONFIG_BIGNUM
+
+/* try to call the operation on the operatorSet field of 'obj'. Only
+   used for "/" and "**" on the BigInt prototype in math mode */
+static __exception int js_call_binary_op_simple(JSContext *ctx,
+                                                JSValue *pret,
+                                                JSValueConst obj,
+                                                JSValueConst op1,
+                                                JSValueConst op2,
+                                                OPCodeEnum op)
 {
-    JSValue opset1_obj, method, ret;
+    JSValue opset1_obj, method, ret, new_op1, new_op2;
     JSOperatorSetData *opset1;
     JSOverloadableOperatorEnum ovop;
     JSObject *p;
+    JSValueConst args[2];
 
-    if (!ctx->allow_operator_overloading)
-        return 0;
-
-    opset1_obj = JS_GetProperty(ctx, op1, JS_ATOM_Symbol_operatorSet);
+    opset1_obj = JS_GetProperty(ctx, obj, JS_ATOM_Symbol_operatorSet);
     if (JS_IsException(opset1_obj))
         goto exception;
     if (JS_IsUndefined(opset1_obj))
@@ -12594,21 +13341,29 @@ static __exception int js_call_unary_op_fallback(JSContext *ctx,
     opset1 = JS_GetOpaque2(ctx, opset1_obj, JS_CLASS_OPERATOR_SET);
     if (!opset1)
         goto exception;
-    if (opset1->is_primitive) {
-        JS_FreeValue(ctx, opset1_obj);
-        return 0;
-    }
-
     ovop = get_ovop_from_opcode(op);
 
     p = opset1->self_ops[ovop];
     if (!p) {
-        JS_ThrowTypeError(ctx, "no overloaded operator %s",
-                          js_overloadable_operator_names[ovop]);
+        JS_FreeValue(ctx, opset1_obj);
+        return 0;
+    }
+
+    new_op1 = JS_ToNumeric(ctx, op1);
+    if (JS_IsException(new_op1))
+        goto exception;
+    new_op2 = JS_ToNumeric(ctx, op2);
+    if (JS_IsException(new_op2)) {
+        JS_FreeValue(ctx, new_op1);
         goto exception;
     }
+
     method = JS_DupValue(ctx, JS_MKPTR(JS_TAG_OBJECT, p));
-    ret = JS_CallFree(ctx, method, JS_UNDEFINED, 1, &op1);
+    args[0] = new_op1;
+    args[1] = new_op2;
+    ret = JS_CallFree(ctx, method, JS_UNDEFINED, 2, args);
+    JS_FreeValue(ctx, new_op1);
+    JS_FreeValue(ctx, new_op2);
     if (JS_IsException(ret))
         goto exception;
     JS_FreeValue(ctx, opset1_obj);
@@ -14148,6 +14903,19 @@ static no_inline __exception int js_unary_arith_slow(JSContext *ctx,
     double d;
 
     op1 = sp[-1];
+#ifdef CONFIG_OPERATORS
+    if (JS_IsObject(op1)) {
+        JSValue val;
+        int ret = js_call_unary_op_fallback(ctx, &val, op1, op);
+        if (ret < 0)
+            return -1;
+        if (ret) {
+            JS_FreeValue(ctx, op1);
+            sp[-1] = val;
+            return 0;
+        }
+    }
+#endif
     if (unlikely(JS_ToFloat64Free(ctx, &d, op1))) {
         sp[-1] = JS_UNDEFINED;
         return -1;
@@ -14197,6 +14965,25 @@ static no_inline __exception int js_binary_arith_slow(JSContext *ctx, JSValue *s
 
     op1 = sp[-2];
     op2 = sp[-1];
+#ifdef CONFIG_OPERATORS
+    /* try to call an overloaded operator */
+    if ((JS_VALUE_GET_TAG(op1) == JS_TAG_OBJECT &&
+         !JS_IsNull(op2) && !JS_IsUndefined(op2)) ||
+        (JS_VALUE_GET_TAG(op2) == JS_TAG_OBJECT &&
+         !JS_IsNull(op1) && !JS_IsUndefined(op1))) {
+        JSValue res;
+        int ret = js_call_binary_op_fallback(ctx, &res, op1, op2, op,
+                                             TRUE, 0);
+        if (ret != 0) {
+            JS_FreeValue(ctx, op1);
+            JS_FreeValue(ctx, op2);
+            if (ret < 0)
+                goto exception;
+            sp[-2] = res;
+            return 0;
+        }
+    }
+#endif
     if (unlikely(JS_ToFloat64Free(ctx, &d1, op1))) {
         JS_FreeValue(ctx, op2);
         goto exception;
@@ -14244,6 +15031,27 @@ static no_inline __exception int js_add_slow(JSContext *ctx, JSValue *sp)
         (tag2 == JS_TAG_INT || JS_TAG_IS_FLOAT64(tag2))) {
         goto add_numbers;
     } else {
+#ifdef CONFIG_OPERATORS
+        /* try to call an overloaded operator */
+        if ((JS_VALUE_GET_TAG(op1) == JS_TAG_OBJECT &&
+             !JS_IsNull(op2) && !JS_IsUndefined(op2) &&
+             JS_VALUE_GET_TAG(op2) != JS_TAG_STRING) ||
+            (JS_VALUE_GET_TAG(op2) == JS_TAG_OBJECT &&
+             !JS_IsNull(op1) && !JS_IsUndefined(op1) &&
+             JS_VALUE_GET_TAG(op1) != JS_TAG_STRING)) {
+            JSValue res;
+            int ret = js_call_binary_op_fallback(ctx, &res, op1, op2, OP_add,
+                                                 FALSE, HINT_NONE);
+            if (ret != 0) {
+                JS_FreeValue(ctx, op1);
+                JS_FreeValue(ctx, op2);
+                if (ret < 0)
+                    goto exception;
+                sp[-2] = res;
+                return 0;
+            }
+        }
+#endif
         op1 = JS_ToPrimitiveFree(ctx, op1, HINT_NONE);
         if (JS_IsException(op1)) {
             JS_FreeValue(ctx, op2);
@@ -14288,6 +15096,25 @@ static no_inline __exception int js_binary_logic_slow(JSContext *ctx,
 
     op1 = sp[-2];
     op2 = sp[-1];
+#ifdef CONFIG_OPERATORS
+    /* try to call an overloaded operator */
+    if ((JS_VALUE_GET_TAG(op1) == JS_TAG_OBJECT &&
+         !JS_IsNull(op2) && !JS_IsUndefined(op2)) ||
+        (JS_VALUE_GET_TAG(op2) == JS_TAG_OBJECT &&
+         !JS_IsNull(op1) && !JS_IsUndefined(op1))) {
+        JSValue res;
+        int ret = js_call_binary_op_fallback(ctx, &res, op1, op2, op,
+                                             TRUE, 0);
+        if (ret != 0) {
+            JS_FreeValue(ctx, op1);
+            JS_FreeValue(ctx, op2);
+            if (ret < 0)
+                goto exception;
+            sp[-2] = res;
+            return 0;
+        }
+    }
+#endif
     if (unlikely(JS_ToInt32Free(ctx, (int32_t *)&v1, op1))) {
         JS_FreeValue(ctx, op2);
         goto exception;
@@ -14323,9 +15150,24 @@ static no_inline __exception int js_binary_logic_slow(JSContext *ctx,
 
 static no_inline int js_not_slow(JSContext *ctx, JSValue *sp)
 {
+    JSValue op1;
     int32_t v1;
 
-    if (unlikely(JS_ToInt32Free(ctx, &v1, sp[-1]))) {
+    op1 = sp[-1];
+#ifdef CONFIG_OPERATORS
+    if (JS_IsObject(op1)) {
+        JSValue val;
+        int ret = js_call_unary_op_fallback(ctx, &val, op1, OP_not);
+        if (ret < 0)
+            return -1;
+        if (ret) {
+            JS_FreeValue(ctx, op1);
+            sp[-1] = val;
+            return 0;
+        }
+    }
+#endif
+    if (unlikely(JS_ToInt32Free(ctx, &v1, op1))) {
         sp[-1] = JS_UNDEFINED;
         return -1;
     }
@@ -14341,6 +15183,25 @@ static no_inline int js_relational_slow(JSContext *ctx, JSValue *sp,
 
     op1 = sp[-2];
     op2 = sp[-1];
+#ifdef CONFIG_OPERATORS
+    /* try to call an overloaded operator */
+    if ((JS_VALUE_GET_TAG(op1) == JS_TAG_OBJECT &&
+         !JS_IsNull(op2) && !JS_IsUndefined(op2)) ||
+        (JS_VALUE_GET_TAG(op2) == JS_TAG_OBJECT &&
+         !JS_IsNull(op1) && !JS_IsUndefined(op1))) {
+        JSValue res;
+        int ret = js_call_binary_op_fallback(ctx, &res, op1, op2, op,
+                                             FALSE, HINT_NUMBER);
+        if (ret != 0) {
+            JS_FreeValue(ctx, op1);
+            JS_FreeValue(ctx, op2);
+            if (ret < 0)
+                goto exception;
+            sp[-2] = res;
+            return 0;
+        }
+    }
+#endif
     op1 = JS_ToPrimitiveFree(ctx, op1, HINT_NUMBER);
     if (JS_IsException(op1)) {
         JS_FreeValue(ctx, op2);
@@ -14410,6 +15271,9 @@ static no_inline __exception int js_eq_slow(JSContext *ctx, JSValue *sp,
                                             BOOL is_neq)
 {
     JSValue op1, op2;
+#ifdef CONFIG_OPERATORS
+    JSValue ret;
+#endif
     int tag1, tag2;
     BOOL res;
 
@@ -14421,6 +15285,22 @@ static no_inline __exception int js_eq_slow(JSContext *ctx, JSValue *sp,
     if (tag1 == tag2 ||
         (tag1 == JS_TAG_INT && tag2 == JS_TAG_FLOAT64) ||
         (tag2 == JS_TAG_INT && tag1 == JS_TAG_FLOAT64)) {
+#ifdef CONFIG_OPERATORS
+        if (tag1 == JS_TAG_OBJECT) {
+            /* try the fallback operator */
+            res = js_call_binary_op_fallback(ctx, &ret, op1, op2,
+                                             is_neq ? OP_neq : OP_eq,
+                                             FALSE, HINT_NONE);
+            if (res != 0) {
+                JS_FreeValue(ctx, op1);
+                JS_FreeValue(ctx, op2);
+                if (res < 0)
+                    goto exception;
+                sp[-2] = ret;
+                return 0;
+            }
+        }
+#endif
         res = js_strict_eq(ctx, op1, op2);
     } else if ((tag1 == JS_TAG_NULL && tag2 == JS_TAG_UNDEFINED) ||
                (tag2 == JS_TAG_NULL && tag1 == JS_TAG_UNDEFINED)) {
@@ -14446,6 +15326,20 @@ static no_inline __exception int js_eq_slow(JSContext *ctx, JSValue *sp,
         goto redo;
     } else if (tag1 == JS_TAG_OBJECT &&
                (tag2 == JS_TAG_INT || tag2 == JS_TAG_FLOAT64 || tag2 == JS_TAG_STRING || tag2 == JS_TAG_SYMBOL)) {
+#ifdef CONFIG_OPERATORS
+        /* try the fallback operator */
+        res = js_call_binary_op_fallback(ctx, &ret, op1, op2,
+                                         is_neq ? OP_neq : OP_eq,
+                                         FALSE, HINT_NONE);
+        if (res != 0) {
+            JS_FreeValue(ctx, op1);
+            JS_FreeValue(ctx, op2);
+            if (res < 0)
+                goto exception;
+            sp[-2] = ret;
+            return 0;
+        }
+#endif
         op1 = JS_ToPrimitiveFree(ctx, op1, HINT_NONE);
         if (JS_IsException(op1)) {
             JS_FreeValue(ctx, op2);
@@ -14454,6 +15348,20 @@ static no_inline __exception int js_eq_slow(JSContext *ctx, JSValue *sp,
         goto redo;
     } else if (tag2 == JS_TAG_OBJECT &&
                (tag1 == JS_TAG_INT || tag1 == JS_TAG_FLOAT64 || tag1 == JS_TAG_STRING || tag1 == JS_TAG_SYMBOL)) {
+#ifdef CONFIG_OPERATORS
+        /* try the fallback operator */
+        res = js_call_binary_op_fallback(ctx, &ret, op1, op2,
+                                         is_neq ? OP_neq : OP_eq,
+                                         FALSE, HINT_NONE);
+        if (res != 0) {
+            JS_FreeValue(ctx, op1);
+            JS_FreeValue(ctx, op2);
+            if (res < 0)
+                goto exception;
+            sp[-2] = ret;
+            return 0;
+        }
+#endif
         op2 = JS_ToPrimitiveFree(ctx, op2, HINT_NONE);
         if (JS_IsException(op2)) {
             JS_FreeValue(ctx, op1);
@@ -16110,6 +17018,179 @@ typedef enum {
 #define FUNC_RET_YIELD      1
 #define FUNC_RET_YIELD_STAR 2
 
+#ifdef CONFIG_INLINE_CACHE
+/* return the cache site of the instruction at 'op_pc' or NULL if the
+   cache could not be allocated */
+static force_inline JSInlineCacheSite *js_inline_cache_find(JSRuntime *rt,
+                                                            JSFunctionBytecode *b,
+                                                            const uint8_t *op_pc)
+{
+    JSInlineCache *ic;
+    int idx;
+
+    ic = b->ic;
+    if (unlikely(!ic)) {
+        ic = js_inline_cache_new(rt, b);
+        if (!ic)
+            return NULL;
+        b->ic = ic;
+    }
+    idx = ic->site_index[(op_pc - b->byte_code_buf) >> 2];
+    if (unlikely(idx == 0))
+        return NULL;
+    return &ic->sites[idx - 1];
+}
+
+/* return the object holding the property cached by 'e' if 'p' matches
+   its shapes, NULL otherwise */
+static force_inline JSObject *js_inline_cache_match(JSInlineCacheEntry *e,
+                                                   JSObject *p)
+{
+    int i;
+
+    if (e->shapes[0] != p->shape)
+        return NULL;
+    for(i = 1; i <= e->depth; i++) {
+        /* same shape, hence same prototype as when the entry was added */
+        p = e->shapes[i - 1]->proto;
+        if (p->shape != e->shapes[i])
+            return NULL;
+    }
+    return p;
+}
+
+/* return TRUE and set '*pval' if the property read at 'site' is cached
+   for 'obj' */
+static force_inline BOOL js_inline_cache_get(JSContext *ctx,
+                                             JSInlineCacheSite *site,
+                                             JSValueConst obj, JSValue *pval)
+{
+    JSObject *p, *p1;
+    JSInlineCacheEntry *e;
+    JSProperty *pr;
+    int i;
+
+    if (JS_VALUE_GET_TAG(obj) != JS_TAG_OBJECT)
+        return FALSE;
+    p = JS_VALUE_GET_OBJ(obj);
+    if (p->is_exotic)
+        return FALSE;
+    for(i = 0; i < site->count; i++) {
+        e = site->ways[i];
+        p1 = js_inline_cache_match(e, p);
+        if (p1) {
+            pr = &p1->prop[e->prop_index];
+            if (!e->is_getset) {
+                *pval = JS_DupValue(ctx, pr->u.value);
+            } else if (!pr->u.getset.getter) {
+                *pval = JS_UNDEFINED;
+            } else {
+                JSValue func = JS_MKPTR(JS_TAG_OBJECT, pr->u.getset.getter);
+                /* Note: the field could be removed in the getter */
+                func = JS_DupValue(ctx, func);
+                *pval = JS_CallFree(ctx, func, obj, 0, NULL);
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* return TRUE and set '*pret' as JS_SetPropertyInternal() if the
+   property write at 'site' is cached for 'obj'. 'val' is freed only
+   in this case. */
+static force_inline BOOL js_inline_cache_put(JSContext *ctx,
+                                             JSInlineCacheSite *site,
+                                             JSValueConst obj, JSValue val,
+                                             int flags, int *pret)
+{
+    JSObject *p, *p1;
+    JSInlineCacheEntry *e;
+    JSProperty *pr;
+    int i;
+
+    if (JS_VALUE_GET_TAG(obj) != JS_TAG_OBJECT)
+        return FALSE;
+    p = JS_VALUE_GET_OBJ(obj);
+    if (p->is_exotic)
+        return FALSE;
+    for(i = 0; i < site->count; i++) {
+        e = site->ways[i];
+        p1 = js_inline_cache_match(e, p);
+        if (p1) {
+            pr = &p1->prop[e->prop_index];
+            if (!e->is_getset) {
+                set_value(ctx, &pr->u.value, val);
+                *pret = TRUE;
+            } else {
+                *pret = call_setter(ctx, pr->u.getset.setter, obj, val, flags);
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* remember where the property 'atom' of 'obj' is found, called before
+   the uncached access */
+static no_inline void js_inline_cache_update(JSContext *ctx,
+                                             JSInlineCacheSite *site,
+                                             JSValueConst obj, JSAtom atom,
+                                             BOOL is_put)
+{
+    JSShape *shapes[JS_IC_MAX_DEPTH + 1];
+    JSInlineCacheEntry *e;
+    JSShapeProperty *prs;
+    JSProperty *pr;
+    JSObject *p;
+    int depth, i;
+
+    if (JS_VALUE_GET_TAG(obj) != JS_TAG_OBJECT)
+        return;
+    p = JS_VALUE_GET_OBJ(obj);
+    for(depth = 0;; depth++) {
+        /* exotic objects may have properties outside of their shape */
+        if (depth > JS_IC_MAX_DEPTH || p->is_exotic || !p->shape->is_hashed)
+            return;
+        shapes[depth] = p->shape;
+        prs = find_own_property(&pr, p, atom);
+        if (prs)
+            break;
+        p = p->shape->proto;
+        if (!p)
+            return;
+    }
+    switch(prs->flags & JS_PROP_TMASK) {
+    case JS_PROP_NORMAL:
+        if (prs->flags & JS_PROP_LENGTH)
+            return;
+        /* a write to an inherited field adds an own property */
+        if (is_put && (depth != 0 || !(prs->flags & JS_PROP_WRITABLE)))
+            return;
+        break;
+    case JS_PROP_GETSET:
+        break;
+    default:
+        return;
+    }
+    e = js_malloc_rt(ctx->rt, sizeof(*e) + (depth + 1) * sizeof(e->shapes[0]));
+    if (!e)
+        return;
+    e->depth = depth;
+    e->is_getset = (prs->flags & JS_PROP_TMASK) == JS_PROP_GETSET;
+    e->prop_index = pr - p->prop;
+    for(i = 0; i <= depth; i++)
+        e->shapes[i] = js_dup_shape(shapes[i]);
+    if (site->count < JS_IC_WAYS) {
+        site->ways[site->count++] = e;
+    } else {
+        js_inline_cache_free_entry(ctx->rt, site->ways[site->next]);
+        site->ways[site->next] = e;
+        site->next = (site->next + 1) % JS_IC_WAYS;
+    }
+}
+#endif
+
 /* argv[] is modified if (flags & JS_CALL_FLAG_COPY_ARGV) = 0. */
 static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
                                JSValueConst this_obj, JSValueConst new_target,
@@ -16144,7 +17225,10 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
  This will only work  with a GNU extension
  https://stackoverflow.com/questions/56598905/three-dots-operator-for-initializing-an-array
 */
-        [ OP_COUNT ... 255 ] = &&case_default
+        [ OP_COUNT ... 255 ] = &&case_default,
+#ifdef QUICKJS_WITH_DEBUGGER
+        [ OP_breakpoint ] = &&case_OP_breakpoint,
+#endif
     };
 #ifdef QUICKJS_WITH_DEBUGGER
     static const void * const debugger_dispatch_table[256] = {
@@ -16159,10 +17243,15 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
  This will only work  with a GNU extension
  https://stackoverflow.com/questions/56598905/three-dots-operator-for-initializing-an-array
 */
-        [ OP_COUNT ... 255 ] = &&case_default
+        [ OP_COUNT ... 255 ] = &&case_default,
+        [ OP_breakpoint ] = &&case_OP_breakpoint,
     };
 #define SWITCH(pc)      goto *active_dispatch_table[opcode = *pc++];
-#define CASE(op)        case_debugger_ ## op: js_debugger_check(ctx, pc); case_ ## op
+/* the checks stop once no step is in progress */
+#define CASE(op)        case_debugger_ ## op:                            \
+                            if (!js_debugger_check(ctx, pc))             \
+                                active_dispatch_table = dispatch_table;  \
+                        case_ ## op
 #else
 #define SWITCH(pc)      goto *dispatch_table[opcode = *pc++];
 #define CASE(op)        case_ ## op
@@ -16172,8 +17261,8 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
 #endif
 
 #ifdef QUICKJS_WITH_DEBUGGER
-    const void * const * active_dispatch_table = caller_ctx->rt->debugger_info.transport_close
-        ? debugger_dispatch_table : dispatch_table;
+    /* only switched to the checking table while a client is stepping */
+    const void * const * active_dispatch_table = dispatch_table;
 #endif
 
     if (js_poll_interrupts(caller_ctx))
@@ -16260,13 +17349,16 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
     ctx = b->realm; /* set the current realm */
 
  restart:
+#ifdef QUICKJS_WITH_DEBUGGER
+    if (unlikely(rt->debugger_info.transport_close)) {
+        active_dispatch_table = js_debugger_enter(ctx, b) ?
+            debugger_dispatch_table : dispatch_table;
+    }
+#endif
     for(;;) {
         int call_argc;
         JSValue *call_argv;
 
-#ifdef QUICKJS_WITH_DEBUGGER
-        js_debugger_check(ctx, NULL);
-#endif
         SWITCH(pc) {
         CASE(OP_push_i32):
             *sp++ = JS_NewInt32(ctx, get_u32(pc));
@@ -17504,10 +18596,23 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
             {
                 JSValue val;
                 JSAtom atom;
+#ifdef CONFIG_INLINE_CACHE
+                JSInlineCacheSite *site;
+                site = js_inline_cache_find(rt, b, pc - 1);
+#endif
                 atom = get_u32(pc);
                 pc += 4;
 
+#ifdef CONFIG_INLINE_CACHE
+                if (!site) {
+                    val = JS_GetProperty(ctx, sp[-1], atom);
+                } else if (!js_inline_cache_get(ctx, site, sp[-1], &val)) {
+                    js_inline_cache_update(ctx, site, sp[-1], atom, FALSE);
+                    val = JS_GetProperty(ctx, sp[-1], atom);
+                }
+#else
                 val = JS_GetProperty(ctx, sp[-1], atom);
+#endif
                 if (unlikely(JS_IsException(val)))
                     goto exception;
                 JS_FreeValue(ctx, sp[-1]);
@@ -17519,10 +18624,23 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
             {
                 JSValue val;
                 JSAtom atom;
+#ifdef CONFIG_INLINE_CACHE
+                JSInlineCacheSite *site;
+                site = js_inline_cache_find(rt, b, pc - 1);
+#endif
                 atom = get_u32(pc);
                 pc += 4;
 
+#ifdef CONFIG_INLINE_CACHE
+                if (!site) {
+                    val = JS_GetProperty(ctx, sp[-1], atom);
+                } else if (!js_inline_cache_get(ctx, site, sp[-1], &val)) {
+                    js_inline_cache_update(ctx, site, sp[-1], atom, FALSE);
+                    val = JS_GetProperty(ctx, sp[-1], atom);
+                }
+#else
                 val = JS_GetProperty(ctx, sp[-1], atom);
+#endif
                 if (unlikely(JS_IsException(val)))
                     goto exception;
                 *sp++ = val;
@@ -17533,11 +18651,27 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
             {
                 int ret;
                 JSAtom atom;
+#ifdef CONFIG_INLINE_CACHE
+                JSInlineCacheSite *site;
+                site = js_inline_cache_find(rt, b, pc - 1);
+#endif
                 atom = get_u32(pc);
                 pc += 4;
 
+#ifdef CONFIG_INLINE_CACHE
+                if (!site) {
+                    ret = JS_SetPropertyInternal(ctx, sp[-2], atom, sp[-1],
+                                                 JS_PROP_THROW_STRICT);
+                } else if (!js_inline_cache_put(ctx, site, sp[-2], sp[-1],
+                                                JS_PROP_THROW_STRICT, &ret)) {
+                    js_inline_cache_update(ctx, site, sp[-2], atom, TRUE);
+                    ret = JS_SetPropertyInternal(ctx, sp[-2], atom, sp[-1],
+                                                 JS_PROP_THROW_STRICT);
+                }
+#else
                 ret = JS_SetPropertyInternal(ctx, sp[-2], atom, sp[-1],
                                              JS_PROP_THROW_STRICT);
+#endif
                 JS_FreeValue(ctx, sp[-2]);
                 sp -= 2;
                 if (unlikely(ret < 0))
@@ -18609,6 +19743,16 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
             JS_FreeValue(ctx, sp[-1]);
             sp[-1] = JS_FALSE;
             BREAK;
+#ifdef QUICKJS_WITH_DEBUGGER
+        /* both tables jump here, the step check is done by the trap */
+        case_OP_breakpoint:
+            sf->cur_pc = pc;
+            /* run the replaced instruction once the debugger resumes */
+            opcode = js_debugger_trap(ctx, b, pc);
+            if (rt->debugger_info.stepping)
+                active_dispatch_table = debugger_dispatch_table;
+            goto *dispatch_table[opcode];
+#endif
         CASE(OP_invalid):
         DEFAULT:
             JS_ThrowInternalError(ctx, "invalid opcode: pc=%u opcode=0x%02x",
@@ -18664,6 +19808,10 @@ static JSValue JS_CallInternal(JSContext *caller_ctx, JSValueConst func_obj,
         }
     }
     rt->current_stack_frame = sf->prev_frame;
+#ifdef QUICKJS_WITH_DEBUGGER
+    if (unlikely(rt->debugger_info.stepping))
+        js_debugger_leave(rt, sf->prev_frame);
+#endif
     return ret_val;
 }
 
@@ -28699,6 +29847,89 @@ static void free_bytecode_atoms(JSRuntime *rt,
     }
 }
 
+#ifdef CONFIG_INLINE_CACHE
+/* opcode at 'pos' as compiled, even if the debugger replaced it */
+static inline int js_bytecode_get_opcode(const JSFunctionBytecode *b, int pos)
+{
+#ifdef QUICKJS_WITH_DEBUGGER
+    if (b->debugger.breakpoints && b->debugger.breakpoints[pos])
+        return b->debugger.breakpoints[pos];
+#endif
+    return b->byte_code_buf[pos];
+}
+
+static no_inline JSInlineCache *js_inline_cache_new(JSRuntime *rt, JSFunctionBytecode *b)
+{
+    JSInlineCache *ic;
+    int pos, op, count, index_size;
+    size_t index_len;
+
+    count = 0;
+    for(pos = 0; pos < b->byte_code_len; pos += short_opcode_info(op).size) {
+        op = js_bytecode_get_opcode(b, pos);
+        if (op == OP_get_field || op == OP_get_field2 || op == OP_put_field)
+            count++;
+    }
+    /* the sites after the first 65535 ones are not cached */
+    count = min_int(count, UINT16_MAX);
+    index_size = (b->byte_code_len >> 2) + 1;
+    index_len = sizeof(*ic) + index_size * sizeof(ic->site_index[0]);
+    /* align the sites after the index */
+    index_len = (index_len + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    ic = js_mallocz_rt(rt, index_len + count * sizeof(ic->sites[0]));
+    if (!ic)
+        return NULL;
+    ic->sites = (JSInlineCacheSite *)((uint8_t *)ic + index_len);
+    for(pos = 0; pos < b->byte_code_len && ic->site_count < count;
+        pos += short_opcode_info(op).size) {
+        op = js_bytecode_get_opcode(b, pos);
+        if (op == OP_get_field || op == OP_get_field2 || op == OP_put_field)
+            ic->site_index[pos >> 2] = ++ic->site_count;
+    }
+    return ic;
+}
+
+static void js_inline_cache_free_entry(JSRuntime *rt, JSInlineCacheEntry *e)
+{
+    int i;
+    for(i = 0; i <= e->depth; i++)
+        js_free_shape(rt, e->shapes[i]);
+    js_free_rt(rt, e);
+}
+
+static void js_inline_cache_mark(JSRuntime *rt, JSInlineCache *ic,
+                                 JS_MarkFunc *mark_func)
+{
+    JSInlineCacheSite *site;
+    JSInlineCacheEntry *e;
+    uint32_t i;
+    int j, k;
+
+    for(i = 0; i < ic->site_count; i++) {
+        site = &ic->sites[i];
+        for(j = 0; j < site->count; j++) {
+            e = site->ways[j];
+            for(k = 0; k <= e->depth; k++)
+                mark_func(rt, &e->shapes[k]->header);
+        }
+    }
+}
+
+static void js_inline_cache_free(JSRuntime *rt, JSInlineCache *ic)
+{
+    JSInlineCacheSite *site;
+    uint32_t i;
+    int j;
+
+    for(i = 0; i < ic->site_count; i++) {
+        site = &ic->sites[i];
+        for(j = 0; j < site->count; j++)
+            js_inline_cache_free_entry(rt, site->ways[j]);
+    }
+    js_free_rt(rt, ic);
+}
+#endif
+
 static void js_free_function_def(JSContext *ctx, JSFunctionDef *fd)
 {
     int i;
@@ -32381,8 +33612,10 @@ static JSValue js_create_function(JSContext *ctx, JSFunctionDef *fd)
             }
         } else {
             b->vardefs = (void *)((uint8_t*)b + vardefs_offset);
-            memcpy(b->vardefs, fd->args, fd->arg_count * sizeof(fd->args[0]));
-            memcpy(b->vardefs + fd->arg_count, fd->vars, fd->var_count * sizeof(fd->vars[0]));
+            if (fd->arg_count)
+                memcpy(b->vardefs, fd->args, fd->arg_count * sizeof(fd->args[0]));
+            if (fd->var_count)
+                memcpy(b->vardefs + fd->arg_count, fd->vars, fd->var_count * sizeof(fd->vars[0]));
         }
         b->var_count = fd->var_count;
         b->arg_count = fd->arg_count;
@@ -32476,6 +33709,10 @@ static void free_function_bytecode(JSRuntime *rt, JSFunctionBytecode *b)
         printf("freeing %s\n",
                JS_AtomGetStrRT(rt, buf, sizeof(buf), b->func_name));
     }
+#endif
+#ifdef QUICKJS_WITH_DEBUGGER
+    if (b->debugger.breakpoints)
+        js_debugger_unpatch(rt, b);
 #endif
     free_bytecode_atoms(rt, b->byte_code_buf, b->byte_code_len, TRUE);
 
@@ -32493,16 +33730,16 @@ static void free_function_bytecode(JSRuntime *rt, JSFunctionBytecode *b)
     }
     if (b->realm)
         JS_FreeContext(b->realm);
+#ifdef CONFIG_INLINE_CACHE
+    if (b->ic)
+        js_inline_cache_free(rt, b->ic);
+#endif
 
     JS_FreeAtomRT(rt, b->func_name);
     if (b->has_debug) {
         JS_FreeAtomRT(rt, b->debug.filename);
         js_free_rt(rt, b->debug.pc2line_buf);
         js_free_rt(rt, b->debug.source);
-#ifdef QUICKJS_WITH_DEBUGGER
-        if (b->debugger.breakpoints)
-            js_free_rt(rt, b->debugger.breakpoints);
-#endif
     }
 
     remove_gc_object(&b->header);
@@ -33600,6 +34837,9 @@ typedef enum BCTagEnum {
     BC_TAG_DATE,
     BC_TAG_OBJECT_VALUE,
     BC_TAG_OBJECT_REFERENCE,
+    BC_TAG_MAP,
+    BC_TAG_SET,
+    BC_TAG_ARRAY_BUFFER_TRANSFER,
 } BCTagEnum;
 
 #ifdef CONFIG_BIGNUM
@@ -33632,6 +34872,9 @@ typedef struct BCWriterState {
     int sab_tab_size;
     /* list of referenced objects (used if allow_reference = TRUE) */
     JSObjectList object_list;
+    /* ArrayBuffers written by reference */
+    JSValueConst *transfer_tab;
+    int transfer_tab_len;
 } BCWriterState;
 
 #ifdef DUMP_READ_OBJECT
@@ -33658,6 +34901,9 @@ static const char * const bc_tag_str[] = {
     "Date",
     "ObjectValue",
     "ObjectReference",
+    "Map",
+    "Set",
+    "ArrayBufferTransfer",
 };
 #endif
 
@@ -33819,17 +35065,26 @@ static void bc_byte_swap(uint8_t *bc_buf, int bc_len)
 }
 
 static int JS_WriteFunctionBytecode(BCWriterState *s,
-                                    const uint8_t *bc_buf1, int bc_len)
+                                    const JSFunctionBytecode *b)
 {
-    int pos, len, op;
+    int pos, len, op, bc_len;
     JSAtom atom;
     uint8_t *bc_buf;
     uint32_t val;
 
+    bc_len = b->byte_code_len;
     bc_buf = js_malloc(s->ctx, bc_len);
     if (!bc_buf)
         return -1;
-    memcpy(bc_buf, bc_buf1, bc_len);
+    memcpy(bc_buf, b->byte_code_buf, bc_len);
+#ifdef QUICKJS_WITH_DEBUGGER
+    if (b->debugger.breakpoints) {
+        for(pos = 0; pos < bc_len; pos++) {
+            if (b->debugger.breakpoints[pos])
+                bc_buf[pos] = b->debugger.breakpoints[pos];
+        }
+    }
+#endif
 
     pos = 0;
     while (pos < bc_len) {
@@ -34014,6 +35269,7 @@ static int JS_WriteBigNum(BCWriterState *s, JSValueConst obj)
 #endif /* CONFIG_BIGNUM */
 
 static int JS_WriteObjectRec(BCWriterState *s, JSValueConst obj);
+static int JS_WriteMap(BCWriterState *s, JSValueConst obj);
 
 static int JS_WriteFunctionTag(BCWriterState *s, JSValueConst obj)
 {
@@ -34080,7 +35336,7 @@ static int JS_WriteFunctionTag(BCWriterState *s, JSValueConst obj)
         bc_put_u8(s, flags);
     }
 
-    if (JS_WriteFunctionBytecode(s, b->byte_code_buf, b->byte_code_len))
+    if (JS_WriteFunctionBytecode(s, b))
         goto fail;
 
     if (b->has_debug) {
@@ -34247,6 +35503,14 @@ static int JS_WriteArrayBuffer(BCWriterState *s, JSValueConst obj)
 {
     JSObject *p = JS_VALUE_GET_OBJ(obj);
     JSArrayBuffer *abuf = p->u.array_buffer;
+    int i;
+    for(i = 0; i < s->transfer_tab_len; i++) {
+        if (JS_VALUE_GET_PTR(s->transfer_tab[i]) == p) {
+            bc_put_u8(s, BC_TAG_ARRAY_BUFFER_TRANSFER);
+            bc_put_leb128(s, i);
+            return 0;
+        }
+    }
     if (abuf->detached) {
         JS_ThrowTypeErrorDetachedArrayBuffer(s->ctx);
         return -1;
@@ -34365,6 +35629,10 @@ static int JS_WriteObjectRec(BCWriterState *s, JSValueConst obj)
                 bc_put_u8(s, BC_TAG_DATE);
                 ret = JS_WriteObjectRec(s, p->u.object_data);
                 break;
+            case JS_CLASS_MAP:
+            case JS_CLASS_SET:
+                ret = JS_WriteMap(s, obj);
+                break;
             case JS_CLASS_NUMBER:
             case JS_CLASS_STRING:
             case JS_CLASS_BOOLEAN:
@@ -34450,13 +35718,16 @@ static int JS_WriteObjectAtoms(BCWriterState *s)
     return -1;
 }
 
-uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
-                         int flags, uint8_t ***psab_tab, size_t *psab_tab_len)
+uint8_t *JS_WriteObject3(JSContext *ctx, size_t *psize, JSValueConst obj,
+                         int flags, uint8_t ***psab_tab, size_t *psab_tab_len,
+                         JSValueConst *transfer_tab, int transfer_tab_len)
 {
     BCWriterState ss, *s = &ss;
 
     memset(s, 0, sizeof(*s));
     s->ctx = ctx;
+    s->transfer_tab = transfer_tab;
+    s->transfer_tab_len = transfer_tab_len;
     /* XXX: byte swapped output is untested */
     s->byte_swap = ((flags & JS_WRITE_OBJ_BSWAP) != 0);
     s->allow_bytecode = ((flags & JS_WRITE_OBJ_BYTECODE) != 0);
@@ -34480,6 +35751,8 @@ uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
     *psize = s->dbuf.size;
     if (psab_tab)
         *psab_tab = s->sab_tab;
+    else
+        js_free(ctx, s->sab_tab);
     if (psab_tab_len)
         *psab_tab_len = s->sab_tab_len;
     return s->dbuf.buf;
@@ -34488,6 +35761,7 @@ uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
     js_free(ctx, s->atom_to_idx);
     js_free(ctx, s->idx_to_atom);
     dbuf_free(&s->dbuf);
+    js_free(ctx, s->sab_tab);
     *psize = 0;
     if (psab_tab)
         *psab_tab = NULL;
@@ -34496,6 +35770,13 @@ uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
     return NULL;
 }
 
+uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
+                         int flags, uint8_t ***psab_tab, size_t *psab_tab_len)
+{
+    return JS_WriteObject3(ctx, psize, obj, flags, psab_tab, psab_tab_len,
+                           NULL, 0);
+}
+
 uint8_t *JS_WriteObject(JSContext *ctx, size_t *psize, JSValueConst obj,
                         int flags)
 {
@@ -34517,6 +35798,9 @@ typedef struct BCReaderState {
     JSObject **objects;
     int objects_count;
     int objects_size;
+    /* values of the transferred ArrayBuffers */
+    JSValueConst *transfer_tab;
+    int transfer_tab_len;
 
 #ifdef DUMP_READ_OBJECT
     const uint8_t *ptr_last;
@@ -34925,6 +36209,7 @@ static JSValue JS_ReadBigNum(BCReaderState *s, int tag)
 #endif /* CONFIG_BIGNUM */
 
 static JSValue JS_ReadObjectRec(BCReaderState *s);
+static JSValue JS_ReadMap(BCReaderState *s, int tag);
 
 static int BC_add_object_ref1(BCReaderState *s, JSObject *p)
 {
@@ -35541,6 +36826,26 @@ static JSValue JS_ReadObjectRec(BCReaderState *s)
     case BC_TAG_OBJECT_VALUE:
         obj = JS_ReadObjectValue(s);
         break;
+    case BC_TAG_MAP:
+    case BC_TAG_SET:
+        obj = JS_ReadMap(s, tag);
+        break;
+    case BC_TAG_ARRAY_BUFFER_TRANSFER:
+        {
+            uint32_t val;
+            if (bc_get_leb128(s, &val))
+                return JS_EXCEPTION;
+            if (val >= s->transfer_tab_len) {
+                return JS_ThrowSyntaxError(ctx, "invalid transferred ArrayBuffer (%u >= %u)",
+                                           val, s->transfer_tab_len);
+            }
+            obj = JS_DupValue(ctx, s->transfer_tab[val]);
+            if (BC_add_object_ref(s, obj)) {
+                JS_FreeValue(ctx, obj);
+                return JS_EXCEPTION;
+            }
+        }
+        break;
 #ifdef CONFIG_BIGNUM
     case BC_TAG_BIG_INT:
     case BC_TAG_BIG_FLOAT:
@@ -35625,8 +36930,8 @@ static void bc_reader_free(BCReaderState *s)
     js_free(s->ctx, s->objects);
 }
 
-JSValue JS_ReadObject(JSContext *ctx, const uint8_t *buf, size_t buf_len,
-                       int flags)
+JSValue JS_ReadObject2(JSContext *ctx, const uint8_t *buf, size_t buf_len,
+                       int flags, JSValueConst *transfer_tab, int transfer_tab_len)
 {
     BCReaderState ss, *s = &ss;
     JSValue obj;
@@ -35636,6 +36941,8 @@ JSValue JS_ReadObject(JSContext *ctx, const uint8_t *buf, size_t buf_len,
 
     memset(s, 0, sizeof(*s));
     s->ctx = ctx;
+    s->transfer_tab = transfer_tab;
+    s->transfer_tab_len = transfer_tab_len;
     s->buf_start = buf;
     s->buf_end = buf + buf_len;
     s->ptr = buf;
@@ -35656,6 +36963,12 @@ JSValue JS_ReadObject(JSContext *ctx, const uint8_t *buf, size_t buf_len,
     return obj;
 }
 
+JSValue JS_ReadObject(JSContext *ctx, const uint8_t *buf, size_t buf_len,
+                       int flags)
+{
+    return JS_ReadObject2(ctx, buf, buf_len, flags, NULL, 0);
+}
+
 /*******************************************************************/
 /* runtime functions & objects */
 
@@ -45528,6 +46841,75 @@ static JSValue js_map_set(JSContext *ctx, JSValueConst this_val,
     return JS_DupValue(ctx, this_val);
 }
 
+static int JS_WriteMap(BCWriterState *s, JSValueConst obj)
+{
+    JSObject *p = JS_VALUE_GET_OBJ(obj);
+    JSMapState *ms = p->u.map_state;
+    BOOL is_set = (p->class_id == JS_CLASS_SET);
+    struct list_head *el;
+    JSMapRecord *mr;
+    uint32_t count;
+
+    bc_put_u8(s, is_set ? BC_TAG_SET : BC_TAG_MAP);
+    count = 0;
+    list_for_each(el, &ms->records) {
+        mr = list_entry(el, JSMapRecord, link);
+        if (!mr->empty)
+            count++;
+    }
+    bc_put_leb128(s, count);
+    list_for_each(el, &ms->records) {
+        mr = list_entry(el, JSMapRecord, link);
+        if (mr->empty)
+            continue;
+        if (JS_WriteObjectRec(s, mr->key))
+            return -1;
+        if (!is_set && JS_WriteObjectRec(s, mr->value))
+            return -1;
+    }
+    return 0;
+}
+
+static JSValue JS_ReadMap(BCReaderState *s, int tag)
+{
+    JSContext *ctx = s->ctx;
+    int magic = (tag == BC_TAG_SET) ? MAGIC_SET : 0;
+    JSValue obj, ret;
+    JSValue args[2];
+    uint32_t count, i;
+
+    obj = js_map_constructor(ctx, JS_UNDEFINED, 0, NULL, magic);
+    if (JS_IsException(obj))
+        return JS_EXCEPTION;
+    if (BC_add_object_ref(s, obj))
+        goto fail;
+    if (bc_get_leb128(s, &count))
+        goto fail;
+    for(i = 0; i < count; i++) {
+        args[0] = JS_ReadObjectRec(s);
+        if (JS_IsException(args[0]))
+            goto fail;
+        args[1] = JS_UNDEFINED;
+        if (!magic) {
+            args[1] = JS_ReadObjectRec(s);
+            if (JS_IsException(args[1])) {
+                JS_FreeValue(ctx, args[0]);
+                goto fail;
+            }
+        }
+        ret = js_map_set(ctx, obj, 2, (JSValueConst *)args, magic);
+        JS_FreeValue(ctx, args[0]);
+        JS_FreeValue(ctx, args[1]);
+        if (JS_IsException(ret))
+            goto fail;
+        JS_FreeValue(ctx, ret);
+    }
+    return obj;
+ fail:
+    JS_FreeValue(ctx, obj);
+    return JS_EXCEPTION;
+}
+
 static JSValue js_map_get(JSContext *ctx, JSValueConst this_val,
                           int argc, JSValueConst *argv, int magic)
 {
@@ -48440,7 +49822,7 @@ void JS_AddIntrinsicEval(JSContext *ctx)
     ctx->eval_internal = __JS_EvalInternal;
 }
 
-#ifdef CONFIG_BIGNUM
+#ifdef CONFIG_OPERATORS
 
 /* Operators */
 
@@ -48621,6 +50003,7 @@ static JSValue js_operators_create(JSContext *ctx, JSValueConst this_val,
     return js_operators_create_internal(ctx, argc, argv, FALSE);
 }
 
+#ifdef CONFIG_BIGNUM
 static JSValue js_operators_updateBigIntOperators(JSContext *ctx, JSValueConst this_val,
                                                   int argc, JSValueConst *argv)
 {
@@ -48663,6 +50046,7 @@ static JSValue js_operators_updateBigIntOperators(JSContext *ctx, JSValueConst t
     JS_FreeValue(ctx, opset_obj);
     return JS_EXCEPTION;
 }
+#endif
 
 static int js_operators_set_default(JSContext *ctx, JSValueConst obj)
 {
@@ -48715,7 +50099,9 @@ static JSValue js_global_operators(JSContext *ctx, JSValueConst this_val,
 
 static const JSCFunctionListEntry js_operators_funcs[] = {
     JS_CFUNC_DEF("create", 1, js_operators_create ),
+#ifdef CONFIG_BIGNUM
     JS_CFUNC_DEF("updateBigIntOperators", 2, js_operators_updateBigIntOperators ),
+#endif
 };
 
 /* must be called after all overloadable base types are initialized */
@@ -48735,11 +50121,17 @@ void JS_AddIntrinsicOperators(JSContext *ctx)
     js_operators_set_default(ctx, ctx->class_proto[JS_CLASS_BOOLEAN]);
     js_operators_set_default(ctx, ctx->class_proto[JS_CLASS_NUMBER]);
     js_operators_set_default(ctx, ctx->class_proto[JS_CLASS_STRING]);
+#ifdef CONFIG_BIGNUM
     js_operators_set_default(ctx, ctx->class_proto[JS_CLASS_BIG_INT]);
     js_operators_set_default(ctx, ctx->class_proto[JS_CLASS_BIG_FLOAT]);
     js_operators_set_default(ctx, ctx->class_proto[JS_CLASS_BIG_DECIMAL]);
+#endif
 }
 
+#endif /* CONFIG_OPERATORS */
+
+#ifdef CONFIG_BIGNUM
+
 /* BigInt */
 
 static JSValue JS_ToBigIntCtorFree(JSContext *ctx, JSValue val)
@@ -50949,6 +52341,80 @@ void JS_DetachArrayBuffer(JSContext *ctx, JSValueConst obj)
     }
 }
 
+/* move the accounting of a transferred ArrayBuffer data allocated with
+   the default malloc functions in or out of 'rt' */
+static void js_array_buffer_account(JSRuntime *rt, void *ptr, int sign)
+{
+    if (rt->mf.js_malloc == js_def_malloc) {
+        rt->malloc_state.malloc_count += sign;
+        rt->malloc_state.malloc_size += sign * (int64_t)(js_def_malloc_usable_size(ptr) + MALLOC_OVERHEAD);
+    }
+}
+
+int JS_TransferArrayBuffer(JSContext *ctx, JSTransferredArrayBuffer *ptab,
+                           JSValueConst obj)
+{
+    JSArrayBuffer *abuf = JS_GetOpaque(obj, JS_CLASS_ARRAY_BUFFER);
+
+    if (!abuf) {
+        JS_ThrowTypeErrorInvalidClass(ctx, JS_CLASS_ARRAY_BUFFER);
+        return -1;
+    }
+    if (abuf->detached) {
+        JS_ThrowTypeErrorDetachedArrayBuffer(ctx);
+        return -1;
+    }
+    if (!ptab)
+        return 0;
+    ptab->data = abuf->data;
+    ptab->byte_length = abuf->byte_length;
+    ptab->opaque = abuf->opaque;
+    if (abuf->free_func == js_array_buffer_free) {
+        ptab->free_func = NULL;
+        js_array_buffer_account(ctx->rt, abuf->data, -1);
+    } else {
+        ptab->free_func = abuf->free_func;
+    }
+    /* detach without freeing the data */
+    abuf->free_func = NULL;
+    JS_DetachArrayBuffer(ctx, obj);
+    return 0;
+}
+
+JSValue JS_NewTransferredArrayBuffer(JSContext *ctx,
+                                     const JSTransferredArrayBuffer *tab)
+{
+    JSValue obj;
+
+    if (tab->free_func) {
+        obj = js_array_buffer_constructor3(ctx, JS_UNDEFINED, tab->byte_length,
+                                           JS_CLASS_ARRAY_BUFFER, tab->data,
+                                           tab->free_func, tab->opaque, FALSE);
+        /* the data belongs to nobody else */
+        if (JS_IsException(obj))
+            tab->free_func(ctx->rt, tab->opaque, tab->data);
+        return obj;
+    }
+    js_array_buffer_account(ctx->rt, tab->data, 1);
+    obj = js_array_buffer_constructor3(ctx, JS_UNDEFINED, tab->byte_length,
+                                       JS_CLASS_ARRAY_BUFFER, tab->data,
+                                       js_array_buffer_free, NULL, FALSE);
+    if (JS_IsException(obj))
+        js_free_rt(ctx->rt, tab->data);
+    return obj;
+}
+
+void JS_FreeTransferredArrayBuffer(JSRuntime *rt,
+                                   const JSTransferredArrayBuffer *tab)
+{
+    if (tab->free_func) {
+        tab->free_func(rt, tab->opaque, tab->data);
+    } else {
+        js_array_buffer_account(rt, tab->data, 1);
+        js_free_rt(rt, tab->data);
+    }
+}
+
 /* get an ArrayBuffer or SharedArrayBuffer */
 static JSArrayBuffer *js_get_array_buffer(JSContext *ctx, JSValueConst obj)
 {
@@ -53421,6 +54887,7 @@ typedef struct JSAtomicsWaiter {
     BOOL linked;
     pthread_cond_t cond;
     int32_t *ptr;
+    JSRuntime *rt;
 } JSAtomicsWaiter;
 
 static pthread_mutex_t js_atomics_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -53438,6 +54905,7 @@ static JSValue js_atomics_wait(JSContext *ctx,
     struct timespec ts;
     JSAtomicsWaiter waiter_s, *waiter;
     int ret, size_log2, res;
+    BOOL interrupted;
     double d;
 
     ptr = js_atomics_get_ptr(ctx, NULL, &size_log2, NULL,
@@ -53482,14 +54950,12 @@ static JSValue js_atomics_wait(JSContext *ctx,
 
     waiter = &waiter_s;
     waiter->ptr = ptr;
+    waiter->rt = ctx->rt;
     pthread_cond_init(&waiter->cond, NULL);
     waiter->linked = TRUE;
     list_add_tail(&waiter->link, &js_atomics_waiter_list);
 
-    if (timeout == INT64_MAX) {
-        pthread_cond_wait(&waiter->cond, &js_atomics_mutex);
-        ret = 0;
-    } else {
+    if (timeout != INT64_MAX) {
         /* XXX: use clock monotonic */
         clock_gettime(CLOCK_REALTIME, &ts);
         ts.tv_sec += timeout / 1000;
@@ -53498,14 +54964,36 @@ static JSValue js_atomics_wait(JSContext *ctx,
             ts.tv_nsec -= 1000000000;
             ts.tv_sec++;
         }
-        ret = pthread_cond_timedwait(&waiter->cond, &js_atomics_mutex,
-                                     &ts);
+    }
+    /* the interrupt handler is checked with the mutex held, so a
+       JS_InterruptAtomicsWait() call cannot be missed */
+    ret = 0;
+    interrupted = FALSE;
+    for(;;) {
+        if (ctx->rt->interrupt_handler &&
+            ctx->rt->interrupt_handler(ctx->rt, ctx->rt->interrupt_opaque)) {
+            interrupted = TRUE;
+            break;
+        }
+        if (timeout == INT64_MAX) {
+            pthread_cond_wait(&waiter->cond, &js_atomics_mutex);
+        } else {
+            ret = pthread_cond_timedwait(&waiter->cond, &js_atomics_mutex,
+                                         &ts);
+        }
+        /* still linked if woken by JS_InterruptAtomicsWait() */
+        if (!waiter->linked || ret == ETIMEDOUT)
+            break;
     }
     if (waiter->linked)
         list_del(&waiter->link);
     pthread_mutex_unlock(&js_atomics_mutex);
     pthread_cond_destroy(&waiter->cond);
-    if (ret == ETIMEDOUT) {
+    if (interrupted) {
+        JS_ThrowInternalError(ctx, "interrupted");
+        JS_SetUncatchableError(ctx, ctx->rt->current_exception, TRUE);
+        return JS_EXCEPTION;
+    } else if (ret == ETIMEDOUT) {
         return JS_AtomToString(ctx, JS_ATOM_timed_out);
     } else {
         return JS_AtomToString(ctx, JS_ATOM_ok);
@@ -53559,6 +55047,20 @@ static JSValue js_atomics_notify(JSContext *ctx,
     return JS_NewInt32(ctx, n);
 }
 
+void JS_InterruptAtomicsWait(JSRuntime *rt)
+{
+    struct list_head *el;
+    JSAtomicsWaiter *waiter;
+
+    pthread_mutex_lock(&js_atomics_mutex);
+    list_for_each(el, &js_atomics_waiter_list) {
+        waiter = list_entry(el, JSAtomicsWaiter, link);
+        if (waiter->rt == rt)
+            pthread_cond_signal(&waiter->cond);
+    }
+    pthread_mutex_unlock(&js_atomics_mutex);
+}
+
 static const JSCFunctionListEntry js_atomics_funcs[] = {
     JS_CFUNC_MAGIC_DEF("add", 3, js_atomics_op, ATOMICS_OP_ADD ),
     JS_CFUNC_MAGIC_DEF("and", 3, js_atomics_op, ATOMICS_OP_AND ),
@@ -53585,6 +55087,12 @@ void JS_AddIntrinsicAtomics(JSContext *ctx)
     JS_SetPropertyFunctionList(ctx, ctx->global_obj, js_atomics_obj, countof(js_atomics_obj));
 }
 
+#else
+
+void JS_InterruptAtomicsWait(JSRuntime *rt)
+{
+}
+
 #endif /* CONFIG_ATOMICS */
 
 void JS_AddIntrinsicTypedArrays(JSContext *ctx)
@@ -53698,6 +55206,44 @@ JS_BOOL JS_IsPureCFunction(JSContext *ctx, JSValue val) {
     return p->class_id == JS_CLASS_C_FUNCTION;
 }
 
+/* Give 'obj', which must have no own property, the shape of 'tmpl' and
+   a copy of its property values. The shape of 'tmpl' must be hashed
+   so that it can be shared, and 'tmpl' must only have data
+   properties. Return -1 and leave 'obj' unchanged otherwise. */
+int JS_SetObjectTemplate(JSContext *ctx, JSValueConst obj, JSValueConst tmpl)
+{
+    JSObject *p, *t;
+    JSShape *sh;
+    JSShapeProperty *prs;
+    JSProperty *pr;
+    int i;
+
+    if (JS_VALUE_GET_TAG(obj) != JS_TAG_OBJECT ||
+        JS_VALUE_GET_TAG(tmpl) != JS_TAG_OBJECT)
+        return -1;
+    p = JS_VALUE_GET_OBJ(obj);
+    t = JS_VALUE_GET_OBJ(tmpl);
+    if (p->shape->prop_count != 0 || p->is_exotic || !p->extensible)
+        return -1;
+    sh = t->shape;
+    if (!sh->is_hashed)
+        return -1;
+    for(i = 0, prs = get_shape_prop(sh); i < sh->prop_count; i++, prs++) {
+        if ((prs->flags & JS_PROP_TMASK) != JS_PROP_NORMAL)
+            return -1;
+    }
+    pr = js_malloc(ctx, sizeof(JSProperty) * sh->prop_size);
+    if (unlikely(!pr))
+        return -1;
+    for(i = 0; i < sh->prop_count; i++)
+        pr[i].u.value = JS_DupValue(ctx, t->prop[i].u.value);
+    js_free(ctx, p->prop);
+    js_free_shape(ctx->rt, p->shape);
+    p->shape = js_dup_shape(sh);
+    p->prop = pr;
+    return 0;
+}
+
 const JSMallocState* JS_GetMollocState(JSRuntime *rt) {
     return &rt->malloc_state;
 }
@@ -53827,135 +55373,235 @@ JSValue js_debugger_build_backtrace(JSContext *ctx, const uint8_t *cur_pc)
     return ret;
 }
 
-int js_debugger_check_breakpoint(JSContext *ctx, uint32_t current_dirty, const uint8_t *cur_pc) {
-    JSValue path_data = JS_UNDEFINED;
-    if (!ctx->rt->current_stack_frame)
-        return 0;
-    JSObject *f = JS_VALUE_GET_OBJ(ctx->rt->current_stack_frame->cur_func);
-    if (!f || !js_class_has_bytecode(f->class_id))
-        return 0;
-    JSFunctionBytecode *b = f->u.func.function_bytecode;
-    if (!b->has_debug || !b->debug.filename)
+// returns 1 if the instruction at 'pos' was replaced, 0 if it already was
+static int js_debugger_patch(JSRuntime *rt, JSFunctionBytecode *b, int pos) {
+    if (b->byte_code_buf[pos] == OP_breakpoint)
         return 0;
+    if (!b->debugger.breakpoints) {
+        // original opcode of each replaced instruction, 0 elsewhere
+        b->debugger.breakpoints = js_mallocz_rt(rt, b->byte_code_len);
+        if (!b->debugger.breakpoints)
+            return -1;
+    }
+    b->debugger.breakpoints[pos] = b->byte_code_buf[pos];
+    b->byte_code_buf[pos] = OP_breakpoint;
+    return 1;
+}
 
-    // check if up to date
-    if (b->debugger.dirty == current_dirty)
-        goto done;
+static void js_debugger_unpatch(JSRuntime *rt, JSFunctionBytecode *b) {
+    JSDebuggerInfo *info = &rt->debugger_info;
+    for (int pos = 0; pos < b->byte_code_len; pos++) {
+        if (b->debugger.breakpoints[pos])
+            b->byte_code_buf[pos] = b->debugger.breakpoints[pos];
+    }
+    js_free_rt(rt, b->debugger.breakpoints);
+    b->debugger.breakpoints = NULL;
+    if (info->step_trap_function == b)
+        info->step_trap_function = NULL;
+}
 
-    // note the dirty value and mark as up to date
-    uint32_t dirty = b->debugger.dirty;
-    b->debugger.dirty = current_dirty;
+static void js_debugger_clear_step_trap(JSRuntime *rt) {
+    JSDebuggerInfo *info = &rt->debugger_info;
+    JSFunctionBytecode *b = info->step_trap_function;
+    if (!b)
+        return;
+    b->byte_code_buf[info->step_trap_pos] = b->debugger.breakpoints[info->step_trap_pos];
+    b->debugger.breakpoints[info->step_trap_pos] = 0;
+    info->step_trap_function = NULL;
+}
+
+// replaces the first instruction of each line of 'b' having a breakpoint.
+static void js_debugger_sync_breakpoints(JSContext *ctx, JSFunctionBytecode *b) {
+    JSDebuggerInfo *info = &ctx->rt->debugger_info;
+    JSValue path_data, breakpoints = JS_UNDEFINED;
+    uint32_t dirty, path_dirty, breakpoints_length = 0;
+    int *lines = NULL;
+
+    dirty = b->debugger.dirty;
+    b->debugger.dirty = info->breakpoints_dirty_counter;
+    if (!b->has_debug || !b->debug.filename || b->read_only_bytecode)
+        return;
 
     const char *filename = JS_AtomToCString(ctx, b->debug.filename);
+    if (!filename)
+        return;
     path_data = js_debugger_file_breakpoints(ctx, filename);
     JS_FreeCString(ctx, filename);
     if (JS_IsUndefined(path_data))
-        goto done;
+        return;
 
+    // skip the files whose breakpoints did not change since the last update
     JSValue path_dirty_value = JS_GetPropertyStr(ctx, path_data, "dirty");
-    uint32_t path_dirty;
     JS_ToUint32(ctx, &path_dirty, path_dirty_value);
     JS_FreeValue(ctx, path_dirty_value);
-    // check the dirty value on this source file specifically
-    if (path_dirty == dirty)
+    if (path_dirty <= dirty)
         goto done;
 
-    // todo: bit field?
-    // clear/alloc breakpoints
-    if (!b->debugger.breakpoints)
-        b->debugger.breakpoints = js_malloc_rt(ctx->rt, b->byte_code_len);
-    memset(b->debugger.breakpoints, 0, b->byte_code_len);
-
-    JSValue breakpoints = JS_GetPropertyStr(ctx, path_data, "breakpoints");
+    // the step trap is dropped as well, the step goes on with the checks of the callee
+    if (b->debugger.breakpoints)
+        js_debugger_unpatch(ctx->rt, b);
 
+    breakpoints = JS_GetPropertyStr(ctx, path_data, "breakpoints");
     JSValue breakpoints_length_property = JS_GetPropertyStr(ctx, breakpoints, "length");
-    uint32_t breakpoints_length;
     JS_ToUint32(ctx, &breakpoints_length, breakpoints_length_property);
     JS_FreeValue(ctx, breakpoints_length_property);
+    if (breakpoints_length == 0)
+        goto done;
 
-    const uint8_t *p_end, *p;
-    int new_line_num, line_num, pc, v, ret;
-    unsigned int op;
-
-    p = b->debug.pc2line_buf;
-    p_end = p + b->debug.pc2line_len;
-    pc = 0;
-    line_num = b->debug.line_num;
-
+    lines = js_malloc(ctx, sizeof(lines[0]) * breakpoints_length);
+    if (!lines)
+        goto done;
     for (uint32_t i = 0; i < breakpoints_length; i++) {
         JSValue breakpoint = JS_GetPropertyUint32(ctx, breakpoints, i);
         JSValue breakpoint_line_prop = JS_GetPropertyStr(ctx, breakpoint, "line");
-        uint32_t breakpoint_line;
-        JS_ToUint32(ctx, &breakpoint_line, breakpoint_line_prop);
+        JS_ToInt32(ctx, &lines[i], breakpoint_line_prop);
         JS_FreeValue(ctx, breakpoint_line_prop);
         JS_FreeValue(ctx, breakpoint);
+    }
 
-        // breakpoint is before the current line.
-        // todo: this may be an invalid breakpoint if it's inside the function, but got
-        // skipped over.
-        if (breakpoint_line < line_num)
-            continue;
-        // breakpoint is after function end. can stop, as breakpoints are in sorted order.
-        if (b->debugger.last_line_num && breakpoint_line > b->debugger.last_line_num)
-            break;
-
-        int last_line_num = line_num;
-        int line_pc = pc;
-
-        // scan until we find the start pc for the breakpoint
-        while (p < p_end && line_num <= breakpoint_line) {
+    const uint8_t *p, *p_end;
+    int line_num, last_line_num, pc, v, ret;
+    unsigned int op;
 
-            // scan line by line
-            while (p < p_end && line_num == last_line_num) {
-                op = *p++;
-                if (op == 0) {
-                    uint32_t val;
-                    ret = get_leb128(&val, p, p_end);
-                    if (ret < 0)
-                        goto fail;
-                    pc += val;
-                    p += ret;
-                    ret = get_sleb128(&v, p, p_end);
-                    if (ret < 0)
-                        goto fail;
-                    p += ret;
-                    new_line_num = line_num + v;
-                } else {
-                    op -= PC2LINE_OP_FIRST;
-                    pc += (op / PC2LINE_RANGE);
-                    new_line_num = line_num + (op % PC2LINE_RANGE) + PC2LINE_BASE;
+    p = b->debug.pc2line_buf;
+    p_end = p + b->debug.pc2line_len;
+    pc = 0;
+    line_num = b->debug.line_num;
+    last_line_num = -1;
+    for (;;) {
+        // a new line starts at 'pc'
+        if (line_num != last_line_num && pc < b->byte_code_len) {
+            for (uint32_t i = 0; i < breakpoints_length; i++) {
+                if (lines[i] == line_num) {
+                    if (js_debugger_patch(ctx->rt, b, pc) < 0)
+                        goto done;
+                    break;
                 }
-                line_num = new_line_num;
             }
+        }
+        last_line_num = line_num;
+        if (p >= p_end)
+            break;
+        op = *p++;
+        if (op == 0) {
+            uint32_t val;
+            ret = get_leb128(&val, p, p_end);
+            if (ret < 0)
+                break;
+            pc += val;
+            p += ret;
+            ret = get_sleb128(&v, p, p_end);
+            if (ret < 0)
+                break;
+            p += ret;
+            line_num += v;
+        } else {
+            op -= PC2LINE_OP_FIRST;
+            pc += (op / PC2LINE_RANGE);
+            line_num += (op % PC2LINE_RANGE) + PC2LINE_BASE;
+        }
+    }
 
-            if (line_num != last_line_num) {
-                // new line found, check if it is the one with breakpoint.
-                if (last_line_num == breakpoint_line && line_num > last_line_num)
-                    memset(b->debugger.breakpoints + line_pc, 1, pc - line_pc);
+done:
+    js_free(ctx, lines);
+    JS_FreeValue(ctx, breakpoints);
+    JS_FreeValue(ctx, path_data);
+}
 
-                // update the line trackers
-                line_pc = pc;
-                last_line_num = line_num;
-            }
+void js_debugger_update_breakpoints(JSContext *ctx) {
+    JSRuntime *rt = ctx->rt;
+    struct list_head *el;
+    JSGCObjectHeader *gp;
+    JSFunctionBytecode **tab;
+    int count = 0, i;
+
+    gc_gather_objects(rt);
+    // collected first, updating the breakpoints of a function may run the GC
+    list_for_each(el, &rt->gc_obj_list) {
+        gp = list_entry(el, JSGCObjectHeader, link);
+        if (gp->gc_obj_type == JS_GC_OBJ_TYPE_FUNCTION_BYTECODE)
+            count++;
+    }
+    tab = js_malloc(ctx, sizeof(tab[0]) * max_int(count, 1));
+    if (!tab)
+        return;
+    count = 0;
+    list_for_each(el, &rt->gc_obj_list) {
+        gp = list_entry(el, JSGCObjectHeader, link);
+        if (gp->gc_obj_type == JS_GC_OBJ_TYPE_FUNCTION_BYTECODE) {
+            gp->ref_count++;
+            tab[count++] = (JSFunctionBytecode *)gp;
         }
+    }
+    for (i = 0; i < count; i++) {
+        js_debugger_sync_breakpoints(ctx, tab[i]);
+        JS_FreeValueRT(rt, JS_MKPTR(JS_TAG_FUNCTION_BYTECODE, tab[i]));
+    }
+    js_free(ctx, tab);
+}
 
-        if (p >= p_end)
-            b->debugger.last_line_num = line_num;
+void js_debugger_clear_breakpoints(JSRuntime *rt) {
+    struct list_head *el;
+    JSGCObjectHeader *gp;
+    JSFunctionBytecode *b;
+
+    gc_gather_objects(rt);
+    list_for_each(el, &rt->gc_obj_list) {
+        gp = list_entry(el, JSGCObjectHeader, link);
+        if (gp->gc_obj_type == JS_GC_OBJ_TYPE_FUNCTION_BYTECODE) {
+            b = (JSFunctionBytecode *)gp;
+            if (b->debugger.breakpoints)
+                js_debugger_unpatch(rt, b);
+            b->debugger.dirty = 0;
+        }
     }
+    rt->debugger_info.step_trap_function = NULL;
+}
 
-fail:
-    JS_FreeValue(ctx, breakpoints);
+// called when a client is connected each time 'b' starts or resumes, returns TRUE if a step is in progress.
+static BOOL js_debugger_enter(JSContext *ctx, JSFunctionBytecode *b) {
+    JSDebuggerInfo *info = &ctx->rt->debugger_info;
+    if (b->debugger.dirty != info->breakpoints_dirty_counter)
+        js_debugger_sync_breakpoints(ctx, b);
+    return info->stepping != 0;
+}
 
-done:
-    JS_FreeValue(ctx, path_data);
+// a step in progress may stop in the caller 'sf' once it resumes: trap its next instruction.
+static void js_debugger_leave(JSRuntime *rt, JSStackFrame *sf) {
+    JSDebuggerInfo *info = &rt->debugger_info;
+    JSFunctionBytecode *b;
+    JSObject *p;
+    int pos;
 
-    if (!b->debugger.breakpoints)
-        return 0;
+    if (!sf || !sf->cur_pc || JS_VALUE_GET_TAG(sf->cur_func) != JS_TAG_OBJECT)
+        return;
+    p = JS_VALUE_GET_OBJ(sf->cur_func);
+    if (!js_class_has_bytecode(p->class_id))
+        return;
+    b = p->u.func.function_bytecode;
+    pos = sf->cur_pc - b->byte_code_buf;
+    if (b->read_only_bytecode || pos < 0 || pos >= b->byte_code_len)
+        return;
+    js_debugger_clear_step_trap(rt);
+    if (js_debugger_patch(rt, b, pos) > 0) {
+        info->step_trap_function = b;
+        info->step_trap_pos = pos;
+    }
+}
 
-    pc = (cur_pc ? cur_pc : ctx->rt->current_stack_frame->cur_pc) - b->byte_code_buf - 1;
-    if (pc < 0 || pc > b->byte_code_len)
-        return 0;
-    return b->debugger.breakpoints[pc];
+// runs the debugger for the replaced instruction ending before 'pc' and returns its opcode.
+static int js_debugger_trap(JSContext *ctx, JSFunctionBytecode *b, const uint8_t *pc) {
+    JSDebuggerInfo *info = &ctx->rt->debugger_info;
+    int pos = pc - 1 - b->byte_code_buf;
+    int op = b->debugger.breakpoints[pos];
+
+    if (info->step_trap_function == b && info->step_trap_pos == pos) {
+        js_debugger_clear_step_trap(ctx->rt);
+        js_debugger_check(ctx, pc);
+    } else {
+        js_debugger_break(ctx, pc);
+    }
+    return op;
 }
 
 JSValue js_debugger_local_variables(JSContext *ctx, int stack_index) {
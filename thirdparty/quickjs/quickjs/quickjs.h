@@ -367,6 +367,20 @@ void JS_SetRuntimeOpaque(JSRuntime *rt, void *opaque);
 typedef void JS_MarkFunc(JSRuntime *rt, JSGCObjectHeader *gp);
 void JS_MarkValue(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_func);
 void JS_RunGC(JSRuntime *rt);
+/* collect the cycles with JS_RunGCStep() instead of pausing in JS_RunGC()
+   when the GC threshold is reached */
+void JS_SetGCIncremental(JSRuntime *rt, JS_BOOL enabled);
+/* FALSE if disabled or if QuickJS is built without CONFIG_INCREMENTAL_GC */
+JS_BOOL JS_IsGCIncremental(JSRuntime *rt);
+/* start a cycle at the next JS_RunGCStep() even if the heap did not grow */
+void JS_RequestGCStep(JSRuntime *rt);
+/* run at most 'budget' object visits of the incremental cycle collection.
+   Return TRUE if there is nothing left to do for now. */
+JS_BOOL JS_RunGCStep(JSRuntime *rt, int budget);
+/* collect the cycles of the last 'size' GC objects allocated, which are
+   only referenced by each other, before they are kept for JS_RunGC().
+   0 disables it. */
+void JS_SetGCNurserySize(JSRuntime *rt, int size);
 JS_BOOL JS_IsLiveObject(JSRuntime *rt, JSValueConst obj);
 
 JSContext *JS_NewContext(JSRuntime *rt);
@@ -447,6 +461,8 @@ JSAtom JS_DupAtom(JSContext *ctx, JSAtom v);
 void JS_FreeAtom(JSContext *ctx, JSAtom v);
 void JS_FreeAtomRT(JSRuntime *rt, JSAtom v);
 JSValue JS_AtomToValue(JSContext *ctx, JSAtom atom);
+/* TRUE and the index in '*pval' if 'atom' is an array index */
+JS_BOOL JS_AtomIsArrayIndex(JSContext *ctx, uint32_t *pval, JSAtom atom);
 JSValue JS_AtomToString(JSContext *ctx, JSAtom atom);
 const char *JS_AtomToCString(JSContext *ctx, JSAtom atom);
 JSAtom JS_ValueToAtom(JSContext *ctx, JSValueConst val);
@@ -715,6 +731,12 @@ int JS_ToBigInt64(JSContext *ctx, int64_t *pres, JSValueConst val);
 int JS_ToInt64Ext(JSContext *ctx, int64_t *pres, JSValueConst val);
 
 JSValue JS_NewStringLen(JSContext *ctx, const char *str1, size_t len1);
+JSValue JS_NewStringUTF32(JSContext *ctx, const uint32_t *buf, size_t len);
+/* 'val' must be a string. Return its length in code points and copy them
+   to 'buf' if not NULL */
+size_t JS_GetStringUTF32(JSValueConst val, uint32_t *buf);
+/* atom of an interned string or JS_ATOM_NULL, not duplicated */
+JSAtom JS_GetStringAtom(JSContext *ctx, JSValueConst val);
 JSValue JS_NewString(JSContext *ctx, const char *str);
 JSValue JS_NewAtomString(JSContext *ctx, const char *str);
 JSValue JS_ToString(JSContext *ctx, JSValueConst val);
@@ -844,6 +866,26 @@ JSValue JS_NewArrayBuffer(JSContext *ctx, uint8_t *buf, size_t len,
 JSValue JS_NewArrayBufferCopy(JSContext *ctx, const uint8_t *buf, size_t len);
 void JS_DetachArrayBuffer(JSContext *ctx, JSValueConst obj);
 uint8_t *JS_GetArrayBuffer(JSContext *ctx, size_t *psize, JSValueConst obj);
+
+/* Data of an ArrayBuffer moved out of its runtime. The runtimes
+   exchanging it must use the same malloc functions. */
+typedef struct JSTransferredArrayBuffer {
+    uint8_t *data;
+    size_t byte_length;
+    /* NULL if 'data' was allocated with the runtime malloc functions */
+    JSFreeArrayBufferDataFunc *free_func;
+    void *opaque;
+} JSTransferredArrayBuffer;
+
+/* detach the ArrayBuffer 'obj' without freeing its data, which now
+   belongs to 'ptab'. If 'ptab' is NULL, only check that 'obj' can be
+   transferred. */
+int JS_TransferArrayBuffer(JSContext *ctx, JSTransferredArrayBuffer *ptab, JSValueConst obj);
+/* create an ArrayBuffer owning the data of 'tab'. The data is freed
+   if the ArrayBuffer cannot be created. */
+JSValue JS_NewTransferredArrayBuffer(JSContext *ctx, const JSTransferredArrayBuffer *tab);
+/* free the data of 'tab' if it was never adopted */
+void JS_FreeTransferredArrayBuffer(JSRuntime *rt, const JSTransferredArrayBuffer *tab);
 JSValue JS_GetTypedArrayBuffer(JSContext *ctx, JSValueConst obj,
                                size_t *pbyte_offset,
                                size_t *pbyte_length,
@@ -870,6 +912,9 @@ typedef int JSInterruptHandler(JSRuntime *rt, void *opaque);
 void JS_SetInterruptHandler(JSRuntime *rt, JSInterruptHandler *cb, void *opaque);
 /* if can_block is TRUE, Atomics.wait() can be used */
 void JS_SetCanBlock(JSRuntime *rt, JS_BOOL can_block);
+/* wake the Atomics.wait() calls of 'rt' so they check the interrupt
+   handler again. Can be called from any thread. */
+void JS_InterruptAtomicsWait(JSRuntime *rt);
 /* set the [IsHTMLDDA] internal slot */
 void JS_SetIsHTMLDDA(JSContext *ctx, JSValueConst obj);
 
@@ -911,6 +956,11 @@ uint8_t *JS_WriteObject(JSContext *ctx, size_t *psize, JSValueConst obj,
                         int flags);
 uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
                          int flags, uint8_t ***psab_tab, size_t *psab_tab_len);
+/* the ArrayBuffers of 'transfer_tab' are written as references to
+   their index in the table instead of being copied */
+uint8_t *JS_WriteObject3(JSContext *ctx, size_t *psize, JSValueConst obj,
+                         int flags, uint8_t ***psab_tab, size_t *psab_tab_len,
+                         JSValueConst *transfer_tab, int transfer_tab_len);
 
 #define JS_READ_OBJ_BYTECODE  (1 << 0) /* allow function/module */
 #define JS_READ_OBJ_ROM_DATA  (1 << 1) /* avoid duplicating 'buf' data */
@@ -918,6 +968,10 @@ uint8_t *JS_WriteObject2(JSContext *ctx, size_t *psize, JSValueConst obj,
 #define JS_READ_OBJ_REFERENCE (1 << 3) /* allow object references */
 JSValue JS_ReadObject(JSContext *ctx, const uint8_t *buf, size_t buf_len,
                       int flags);
+/* 'transfer_tab' gives the values of the references written by
+   JS_WriteObject3() */
+JSValue JS_ReadObject2(JSContext *ctx, const uint8_t *buf, size_t buf_len,
+                       int flags, JSValueConst *transfer_tab, int transfer_tab_len);
 
 /* load the dependencies of the module 'obj'. Useful when JS_ReadObject()
    returns a module. */
@@ -1068,6 +1122,7 @@ JSValue JS_GetModuleExportEntry(JSContext *ctx, JSModuleDef *m, int idx);
 JSAtom JS_GetModuleExportEntryName(JSContext *ctx, JSModuleDef *m, int idx);
 JSValue JS_GetStackFunction(JSContext *ctx, int back_level);
 JS_BOOL JS_IsPureCFunction(JSContext *ctx, JSValue val);
+int JS_SetObjectTemplate(JSContext *ctx, JSValueConst obj, JSValueConst tmpl);
 const JSMallocState *JS_GetMollocState(JSRuntime *rt);
 int JS_GetRefCount(JSValue val);
 JS_BOOL JS_IsArrayBuffer(JSValueConst val);
@@ -15,14 +15,14 @@
 #include "../../src/language/javascript_language.h"
 #include "quickjs_binder.h"
 #include "quickjs_callable.h"
+#include "quickjs_task_pool.h"
 #include "quickjs_worker.h"
 
 #include <cstring>
 
 SafeNumeric<uint32_t> QuickJSBinder::global_context_id;
-SafeNumeric<uint64_t> QuickJSBinder::global_transfer_id;
 
-HashMap<uint64_t, Variant> QuickJSBinder::transfer_deopot;
+QuickJSTransferDepot QuickJSBinder::transfer_depot;
 HashMap<String, const char *> QuickJSBinder::class_remap;
 List<String> compiling_modules;
 
@@ -86,10 +86,7 @@ JSValue QuickJSBinder::console_functions(JSContext *ctx, JSValue this_val, int a
 			args.write[i] = js_to_string(ctx, str);
 			JS_FreeValue(ctx, str);
 		} else {
-			size_t size;
-			const char *utf8 = JS_ToCStringLen(ctx, &size, argv[i]);
-			args.write[i].parse_utf8(utf8, size);
-			JS_FreeCString(ctx, utf8);
+			args.write[i] = js_to_string(ctx, argv[i]);
 		}
 	}
 
@@ -164,7 +161,20 @@ JSValue QuickJSBinder::object_method(JSContext *ctx, JSValueConst this_val, int
 	}
 
 	GodotMethodArguments args(argc);
+	const int typed_argc = MIN(argc, mb->get_argument_count());
 	for (int i = 0; i < argc; ++i) {
+		if (i < typed_argc && JS_IsString(argv[i])) {
+			switch (mb->get_argument_type(i)) {
+				case Variant::STRING_NAME:
+					args.arguments[i] = js_to_string_name(ctx, argv[i]);
+					continue;
+				case Variant::NODE_PATH:
+					args.arguments[i] = js_to_node_path(ctx, argv[i]);
+					continue;
+				default:
+					break;
+			}
+		}
 		args.arguments[i] = var_to_variant(ctx, argv[i]);
 	}
 
@@ -261,7 +271,12 @@ JSValue QuickJSBinder::variant_to_var(JSContext *ctx, const Variant p_var) {
 			Object *obj = p_var;
 			if (obj == NULL)
 				return JS_NULL;
-			JavaScriptGCHandler *data = BINDING_DATA_FROM_GD(ctx, obj);
+			JavaScriptGCHandler *data = BINDING_DATA_FROM_GD(obj);
+			if (data && data->context && data->context != ctx) {
+				// Bound to another context, accessed through the context that owns it
+				return QuickJSObjectProxy::new_proxy(ctx, obj, data->context);
+			}
+			data = BINDING_DATA_FROM_GD(ctx, obj);
 			ERR_FAIL_NULL_V(data, JS_UNDEFINED);
 			ERR_FAIL_NULL_V(data->javascript_object, JS_UNDEFINED);
 			ERR_FAIL_COND_V(data->context != ctx, (JS_UNDEFINED));
@@ -271,6 +286,9 @@ JSValue QuickJSBinder::variant_to_var(JSContext *ctx, const Variant p_var) {
 			return js_obj;
 		}
 		case Variant::ARRAY: {
+			if (get_context_binder(ctx)->live_collections) {
+				return QuickJSCollectionProxy::new_array(ctx, p_var);
+			}
 			Array arr = p_var;
 			JSValue js_arr = JS_NewArray(ctx);
 			for (int i = 0; i < arr.size(); i++) {
@@ -279,6 +297,9 @@ JSValue QuickJSBinder::variant_to_var(JSContext *ctx, const Variant p_var) {
 			return js_arr;
 		}
 		case Variant::DICTIONARY: {
+			if (get_context_binder(ctx)->live_collections) {
+				return QuickJSCollectionProxy::new_dictionary(ctx, p_var);
+			}
 			Dictionary dict = static_cast<Dictionary>(p_var);
 			JSValue obj = JS_NewObject(ctx);
 			Array keys = dict.keys();
@@ -297,7 +318,7 @@ JSValue QuickJSBinder::variant_to_var(JSContext *ctx, const Variant p_var) {
 	}
 }
 
-Variant QuickJSBinder::var_to_variant(JSContext *ctx, JSValue p_val) {
+Variant QuickJSBinder::var_to_variant(JSContext *ctx, JSValue p_val, HashSet<void *> *p_ancestors) {
 	int64_t tag = JS_VALUE_GET_TAG(p_val);
 	switch (tag) {
 		case JS_TAG_INT:
@@ -312,28 +333,45 @@ Variant QuickJSBinder::var_to_variant(JSContext *ctx, JSValue p_val) {
 			if (JS_VALUE_GET_PTR(p_val) == NULL) {
 				return Variant();
 			}
+			if (const Variant *collection = QuickJSCollectionProxy::get_collection(ctx, p_val)) { // Array or Dictionary shared with the engine
+				return *collection;
+			}
 			int length = get_js_array_length(ctx, p_val);
 			if (length != -1) { // Array
+				HashSet<void *> ancestors;
+				if (p_ancestors == NULL) {
+					p_ancestors = &ancestors;
+				}
+				void *ptr = JS_VALUE_GET_PTR(p_val);
+				ERR_FAIL_COND_V_MSG(p_ancestors->has(ptr), Variant(), "Array contains a circular reference to itself.");
+				p_ancestors->insert(ptr);
 				Array arr;
 				arr.resize(length);
 				for (int i = 0; i < length; i++) {
 					JSValue val = JS_GetPropertyUint32(ctx, p_val, i);
-					arr[int(i)] = var_to_variant(ctx, val);
+					arr[int(i)] = var_to_variant(ctx, val, p_ancestors);
 					JS_FreeValue(ctx, val);
 				}
+				p_ancestors->erase(ptr);
 				return arr;
 			} else if (JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, p_val)) { // Binding object
 				ERR_FAIL_NULL_V(bind, Variant());
 				ERR_FAIL_NULL_V(bind->godot_object, Variant());
 				return bind->get_value();
+			} else if (Object *proxy_object = QuickJSObjectProxy::get_proxy_object(ctx, p_val)) { // Object of another context
+				return proxy_object;
 			} else if (JS_IsFunction(ctx, p_val)) {
 				JSValue function = JS_FunctionToString(ctx, p_val);
 				String ret = js_to_string(ctx, function);
 				JS_FreeValue(ctx, function);
 				return ret;
 			} else { // Plain Object as Dictionary
-				List<void *> stack;
-				return js_to_dictionary(ctx, p_val, stack);
+				if (p_ancestors) {
+					ERR_FAIL_COND_V_MSG(p_ancestors->has(JS_VALUE_GET_PTR(p_val)), Variant(), "Object contains a circular reference to itself.");
+					return js_to_dictionary(ctx, p_val, *p_ancestors);
+				}
+				HashSet<void *> ancestors;
+				return js_to_dictionary(ctx, p_val, ancestors);
 			}
 		} break;
 		case JS_TAG_NULL:
@@ -350,6 +388,51 @@ Variant QuickJSBinder::var_to_variant(JSContext *ctx, JSValue p_val) {
 	}
 }
 
+StringName QuickJSBinder::js_to_string_name(JSContext *ctx, const JSValueConst &p_val) {
+	JSAtom atom = JS_GetStringAtom(ctx, p_val);
+	if (atom == JS_ATOM_NULL) {
+		return StringName(js_to_string(ctx, p_val));
+	}
+	QuickJSBinder *binder = get_context_binder(ctx);
+	if (const StringName *name = binder->string_name_cache.getptr(atom)) {
+		return *name;
+	}
+	if (binder->string_name_cache.size() >= NAME_CACHE_MAX) {
+		binder->clear_name_caches();
+	}
+	StringName name = js_to_string(ctx, p_val);
+	binder->string_name_cache.insert(JS_DupAtom(ctx, atom), name);
+	return name;
+}
+
+NodePath QuickJSBinder::js_to_node_path(JSContext *ctx, const JSValueConst &p_val) {
+	JSAtom atom = JS_GetStringAtom(ctx, p_val);
+	if (atom == JS_ATOM_NULL) {
+		return NodePath(js_to_string(ctx, p_val));
+	}
+	QuickJSBinder *binder = get_context_binder(ctx);
+	if (const NodePath *path = binder->node_path_cache.getptr(atom)) {
+		return *path;
+	}
+	if (binder->node_path_cache.size() >= NAME_CACHE_MAX) {
+		binder->clear_name_caches();
+	}
+	NodePath path = js_to_string(ctx, p_val);
+	binder->node_path_cache.insert(JS_DupAtom(ctx, atom), path);
+	return path;
+}
+
+void QuickJSBinder::clear_name_caches() {
+	for (const KeyValue<JSAtom, StringName> &E : string_name_cache) {
+		JS_FreeAtom(ctx, E.key);
+	}
+	string_name_cache.clear();
+	for (const KeyValue<JSAtom, NodePath> &E : node_path_cache) {
+		JS_FreeAtom(ctx, E.key);
+	}
+	node_path_cache.clear();
+}
+
 JSValue QuickJSBinder::godot_builtin_function(JSContext *ctx, JSValue this_val, int argc, JSValue *argv, int magic) {
 	Variant ret;
 	String err_msg;
@@ -414,6 +497,9 @@ bool QuickJSBinder::validate_type(JSContext *ctx, Variant::Type p_type, JSValueC
 		case Variant::DICTIONARY:
 			return JS_IsObject(p_val);
 		case Variant::ARRAY:
+			if (const Variant *collection = QuickJSCollectionProxy::get_collection(ctx, p_val)) {
+				return collection->get_type() == Variant::ARRAY;
+			}
 			return JS_IsArray(ctx, p_val);
 		default: {
 			JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, p_val);
@@ -488,37 +574,38 @@ String QuickJSBinder::get_backtrace_message(const List<JavaScriptStackInfo> &sta
 	return message;
 }
 
-Dictionary QuickJSBinder::js_to_dictionary(JSContext *ctx, const JSValue &p_val, List<void *> &stack) {
+Dictionary QuickJSBinder::js_to_dictionary(JSContext *ctx, const JSValue &p_val, HashSet<void *> &ancestors) {
 	Dictionary dict;
-	HashSet<String> keys;
-	get_own_property_names(ctx, p_val, &keys);
-	stack.push_back(JS_VALUE_GET_PTR(p_val));
-	for (const String &key : keys) {
-		JSValue v = JS_GetPropertyStr(ctx, p_val, key.utf8().get_data());
-		Variant val;
-		if (JS_IsObject(v)) {
-			void *ptr = JS_VALUE_GET_PTR(v);
-			if (stack.find(ptr)) {
-				union {
-					const void *p;
-					uint64_t i;
-				} u;
-				u.p = ptr;
-				ERR_PRINT(vformat("Property '%s' circular reference to 0x%X", key, u.i));
-				JS_FreeValue(ctx, v);
-				continue;
-			} else {
-				stack.push_back(ptr);
-				val = var_to_variant(ctx, v);
-				stack.pop_back();
-			}
+	JSPropertyEnum *props = NULL;
+	uint32_t prop_count = 0;
+	if (JS_GetOwnPropertyNames(ctx, &props, &prop_count, p_val, JS_GPN_STRING_MASK | JS_GPN_SYMBOL_MASK) < 0) {
+		JS_FreeValue(ctx, JS_GetException(ctx));
+		return dict;
+	}
+	void *self = JS_VALUE_GET_PTR(p_val);
+	ancestors.insert(self);
+	// Own property names come in the order the properties were defined, which the dictionary keeps
+	for (uint32_t i = 0; i < prop_count; i++) {
+		JSAtom atom = props[i].atom;
+		JSValue key_val = JS_AtomToString(ctx, atom);
+		String key = js_to_string(ctx, key_val);
+		JS_FreeValue(ctx, key_val);
+		JSValue v = JS_GetProperty(ctx, p_val, atom);
+		JS_FreeAtom(ctx, atom);
+		if (JS_IsObject(v) && ancestors.has(JS_VALUE_GET_PTR(v))) {
+			union {
+				const void *p;
+				uint64_t i;
+			} u;
+			u.p = JS_VALUE_GET_PTR(v);
+			ERR_PRINT(vformat("Property '%s' circular reference to 0x%X", key, u.i));
 		} else {
-			val = var_to_variant(ctx, v);
+			dict[key] = var_to_variant(ctx, v, &ancestors);
 		}
-		dict[key] = val;
 		JS_FreeValue(ctx, v);
 	}
-	stack.pop_back();
+	ancestors.erase(self);
+	js_free_rt(JS_GetRuntime(ctx), props);
 	return dict;
 }
 
@@ -1012,11 +1099,25 @@ void QuickJSBinder::add_godot_origin() {
 
 void QuickJSBinder::add_godot_classes() {
 	HashMap<const ClassDB::ClassInfo *, JSClassID> gdclass_jsmap;
-	// register classes
-	for (const KeyValue<StringName, ClassDB::ClassInfo> &pair : ClassDB::classes) {
-		const ClassDB::ClassInfo &cls = pair.value;
-		if (JSClassID id = register_class(&cls)) {
-			gdclass_jsmap.insert(&cls, id);
+	if (profile == PROFILE_COMPUTE) {
+		// register the allowed classes and their base classes
+		HashSet<StringName> class_names = class_allow_list;
+		class_names.insert("Object");
+		class_names.insert("RefCounted");
+		for (const StringName &name : class_names) {
+			for (const ClassDB::ClassInfo *cls = ClassDB::classes.getptr(name); cls && !gdclass_jsmap.has(cls); cls = cls->inherits_ptr) {
+				if (JSClassID id = register_class(cls)) {
+					gdclass_jsmap.insert(cls, id);
+				}
+			}
+		}
+	} else {
+		// register classes
+		for (const KeyValue<StringName, ClassDB::ClassInfo> &pair : ClassDB::classes) {
+			const ClassDB::ClassInfo &cls = pair.value;
+			if (JSClassID id = register_class(&cls)) {
+				gdclass_jsmap.insert(&cls, id);
+			}
 		}
 	}
 
@@ -1051,6 +1152,40 @@ void QuickJSBinder::add_godot_classes() {
 	godot_reference_class = *classname_bindings.getptr("RefCounted");
 }
 
+void QuickJSBinder::flatten_class_prototypes() {
+	for (const KeyValue<JSClassID, ClassBindData> &pair : class_bindings) {
+		const ClassBindData &data = pair.value;
+		for (const ClassBindData *base = data.base_class; base; base = base->base_class) {
+			JSPropertyEnum *props = NULL;
+			uint32_t count = 0;
+			if (JS_GetOwnPropertyNames(ctx, &props, &count, base->prototype, JS_GPN_STRING_MASK) < 0) {
+				continue;
+			}
+			for (uint32_t i = 0; i < count; i++) {
+				const JSAtom atom = props[i].atom;
+				JSPropertyDescriptor desc;
+				// The nearest definition is kept, as found by a lookup through the chain
+				if (atom == JS_ATOM_constructor || JS_GetOwnProperty(ctx, NULL, data.prototype, atom) != 0) {
+					JS_FreeAtom(ctx, atom);
+					continue;
+				}
+				if (JS_GetOwnProperty(ctx, &desc, base->prototype, atom) > 0) {
+					if (desc.flags & JS_PROP_GETSET) {
+						JS_DefinePropertyGetSet(ctx, data.prototype, atom, JS_DupValue(ctx, desc.getter), JS_DupValue(ctx, desc.setter), desc.flags & (JS_PROP_CONFIGURABLE | JS_PROP_ENUMERABLE));
+					} else if (JS_IsFunction(ctx, desc.value)) {
+						JS_DefinePropertyValue(ctx, data.prototype, atom, JS_DupValue(ctx, desc.value), desc.flags & JS_PROP_C_W_E);
+					}
+					JS_FreeValue(ctx, desc.value);
+					JS_FreeValue(ctx, desc.getter);
+					JS_FreeValue(ctx, desc.setter);
+				}
+				JS_FreeAtom(ctx, atom);
+			}
+			js_free_rt(JS_GetRuntime(ctx), props);
+		}
+	}
+}
+
 void QuickJSBinder::add_godot_globals() {
 	// Singletons
 	List<Engine::Singleton> singletons;
@@ -1061,6 +1196,9 @@ void QuickJSBinder::add_godot_globals() {
 		ERR_CONTINUE(s.ptr == NULL);
 
 		const ClassBindData **cls_ptr = classname_bindings.getptr(s.ptr->get_class_name());
+		if (cls_ptr == NULL && profile == PROFILE_COMPUTE) {
+			continue;
+		}
 		ERR_CONTINUE(cls_ptr == NULL);
 		const ClassBindData *cls = *cls_ptr;
 
@@ -1109,25 +1247,6 @@ void QuickJSBinder::add_godot_globals() {
 		}
 	}
 
-	// global constants
-	HashMap<StringName, HashMap<StringName, int64_t>> global_constants;
-	for (int i = 0; i < CoreConstants::get_global_constant_count(); ++i) {
-		StringName enum_name = CoreConstants::get_global_constant_enum(i);
-		const char *const_name = CoreConstants::get_global_constant_name(i);
-		const int value = CoreConstants::get_global_constant_value(i);
-
-		JSAtom js_const_name = JS_NewAtom(ctx, const_name);
-		JS_DefinePropertyValue(ctx, godot_object, js_const_name, JS_NewInt64(ctx, value), QuickJSBinder::PROP_DEF_DEFAULT);
-		JS_FreeAtom(ctx, js_const_name);
-
-		if (HashMap<StringName, int64_t> *consts = global_constants.getptr(enum_name)) {
-			consts->insert(const_name, value);
-		} else {
-			HashMap<StringName, int64_t> enum_;
-			enum_.insert(const_name, value);
-			global_constants.insert(enum_name, enum_);
-		}
-	}
 	// global numbers
 	GlobalNumberConstant consts[] = {
 		{ "PI", Math_PI },
@@ -1146,22 +1265,46 @@ void QuickJSBinder::add_godot_globals() {
 		JS_FreeAtom(ctx, js_const_name);
 	}
 
-	// global enums
-	for (const KeyValue<StringName, HashMap<StringName, int64_t>> &pair : global_constants) {
-		String enum_name_str = pair.key;
-		if (enum_name_str.is_empty())
-			continue;
-		enum_name_str = enum_name_str.replace(".", "");
 
-		JSAtom atom_enum_name = get_atom(ctx, enum_name_str);
-		JSValue enum_object = JS_NewObject(ctx);
-		JS_DefinePropertyValue(ctx, godot_object, atom_enum_name, enum_object, QuickJSBinder::PROP_DEF_DEFAULT);
-		JS_FreeAtom(ctx, atom_enum_name);
+	// Compute contexts only get the number constants
+	if (profile == PROFILE_FULL) {
+		// global constants
+		HashMap<StringName, HashMap<StringName, int64_t>> global_constants;
+		for (int i = 0; i < CoreConstants::get_global_constant_count(); ++i) {
+			StringName enum_name = CoreConstants::get_global_constant_enum(i);
+			const char *const_name = CoreConstants::get_global_constant_name(i);
+			const int value = CoreConstants::get_global_constant_value(i);
 
-		for (const KeyValue<StringName, int64_t> &c : pair.value) {
-			JSAtom js_const_name = get_atom(ctx, c.key);
-			JS_DefinePropertyValue(ctx, enum_object, js_const_name, JS_NewInt64(ctx, c.value), QuickJSBinder::PROP_DEF_DEFAULT);
+			JSAtom js_const_name = JS_NewAtom(ctx, const_name);
+			JS_DefinePropertyValue(ctx, godot_object, js_const_name, JS_NewInt64(ctx, value), QuickJSBinder::PROP_DEF_DEFAULT);
 			JS_FreeAtom(ctx, js_const_name);
+
+			if (HashMap<StringName, int64_t> *consts = global_constants.getptr(enum_name)) {
+				consts->insert(const_name, value);
+			} else {
+				HashMap<StringName, int64_t> enum_;
+				enum_.insert(const_name, value);
+				global_constants.insert(enum_name, enum_);
+			}
+		}
+
+		// global enums
+		for (const KeyValue<StringName, HashMap<StringName, int64_t>> &pair : global_constants) {
+			String enum_name_str = pair.key;
+			if (enum_name_str.is_empty())
+				continue;
+			enum_name_str = enum_name_str.replace(".", "");
+
+			JSAtom atom_enum_name = get_atom(ctx, enum_name_str);
+			JSValue enum_object = JS_NewObject(ctx);
+			JS_DefinePropertyValue(ctx, godot_object, atom_enum_name, enum_object, QuickJSBinder::PROP_DEF_DEFAULT);
+			JS_FreeAtom(ctx, atom_enum_name);
+
+			for (const KeyValue<StringName, int64_t> &c : pair.value) {
+				JSAtom js_const_name = get_atom(ctx, c.key);
+				JS_DefinePropertyValue(ctx, enum_object, js_const_name, JS_NewInt64(ctx, c.value), QuickJSBinder::PROP_DEF_DEFAULT);
+				JS_FreeAtom(ctx, js_const_name);
+			}
 		}
 	}
 
@@ -1192,6 +1335,12 @@ void QuickJSBinder::add_godot_globals() {
 	// godot.set_script_icon
 	JSValue js_set_script_icon = JS_NewCFunctionMagic(ctx, godot_set_script_meta, "set_script_icon", 2, JS_CFUNC_generic_magic, QuickJSBinder::SCRIPT_META_ICON);
 	JS_DefinePropertyValueStr(ctx, godot_object, "set_script_icon", js_set_script_icon, PROP_DEF_DEFAULT);
+	// godot.set_script_pooled
+	JSValue js_set_script_pooled = JS_NewCFunctionMagic(ctx, godot_set_script_meta, "set_script_pooled", 2, JS_CFUNC_generic_magic, QuickJSBinder::SCRIPT_META_POOLED);
+	JS_DefinePropertyValueStr(ctx, godot_object, "set_script_pooled", js_set_script_pooled, PROP_DEF_DEFAULT);
+	// godot.get_script_pool_info
+	JSValue js_get_script_pool_info = JS_NewCFunction(ctx, godot_get_script_pool_info, "get_script_pool_info", 1);
+	JS_DefinePropertyValueStr(ctx, godot_object, "get_script_pool_info", js_get_script_pool_info, PROP_DEF_DEFAULT);
 	// godot.get_type
 	JSValue js_get_type = JS_NewCFunction(ctx, godot_get_type, "get_type", 1);
 	JS_DefinePropertyValueStr(ctx, godot_object, "get_type", js_get_type, PROP_DEF_DEFAULT);
@@ -1209,6 +1358,16 @@ void QuickJSBinder::add_godot_globals() {
 	JSValue adopt_value_func = JS_NewCFunction(ctx, godot_adopt_value, "adopt_value", 1);
 	JS_DefinePropertyValueStr(ctx, godot_object, "adopt_value", adopt_value_func, PROP_DEF_DEFAULT);
 
+	{
+		// godot.parallel
+		JSValue parallel_object = JS_NewObject(ctx);
+		JSValue parallel_for_func = JS_NewCFunction(ctx, QuickJSTaskPool::parallel_for, "parallelFor", 3);
+		JS_DefinePropertyValueStr(ctx, parallel_object, "parallelFor", parallel_for_func, PROP_DEF_DEFAULT);
+		JSValue parallel_map_func = JS_NewCFunction(ctx, QuickJSTaskPool::parallel_map, "map", 2);
+		JS_DefinePropertyValueStr(ctx, parallel_object, "map", parallel_map_func, PROP_DEF_DEFAULT);
+		JS_DefinePropertyValueStr(ctx, godot_object, "parallel", parallel_object, PROP_DEF_DEFAULT);
+	}
+
 	{
 		// godot.DEBUG_ENABLED
 #ifdef DEBUG_ENABLED
@@ -1225,12 +1384,38 @@ void QuickJSBinder::add_godot_globals() {
 	}
 }
 
+// The reference count is stored in front of the buffer, padded to keep the data 16 bytes aligned for Atomics
+#define SAB_HEADER_SIZE ((sizeof(SafeRefCount) + 15) & ~(size_t)15)
+
+void *QuickJSBinder::js_binder_sab_alloc(void *opaque, size_t size) {
+	uint8_t *mem = static_cast<uint8_t *>(memalloc(SAB_HEADER_SIZE + size));
+	ERR_FAIL_NULL_V(mem, NULL);
+	SafeRefCount *refcount = memnew_placement(mem, SafeRefCount);
+	refcount->init();
+	return mem + SAB_HEADER_SIZE;
+}
+
+void QuickJSBinder::js_binder_sab_free(void *opaque, void *ptr) {
+	uint8_t *mem = static_cast<uint8_t *>(ptr) - SAB_HEADER_SIZE;
+	SafeRefCount *refcount = reinterpret_cast<SafeRefCount *>(mem);
+	if (refcount->unref()) {
+		refcount->~SafeRefCount();
+		memfree(mem);
+	}
+}
+
+void QuickJSBinder::js_binder_sab_dup(void *opaque, void *ptr) {
+	uint8_t *mem = static_cast<uint8_t *>(ptr) - SAB_HEADER_SIZE;
+	reinterpret_cast<SafeRefCount *>(mem)->ref();
+}
+
 void QuickJSBinder::initialize() {
 	thread_id = Thread::get_caller_id();
 	{
 		GLOBAL_LOCK_FUNCTION
 		JavaScriptLanguage::get_singleton()->thread_binder_map.insert(thread_id, this);
 	}
+	JavaScriptLanguage::thread_binder = this;
 
 	// create runtime and context for the binder
 	runtime = JS_NewRuntime2(&godot_allocator, this);
@@ -1240,6 +1425,24 @@ void QuickJSBinder::initialize() {
 	JS_SetModuleLoaderFunc(runtime, /*js_module_resolve*/ NULL, js_module_loader, this);
 	JS_SetContextOpaque(ctx, this);
 
+	JSSharedArrayBufferFunctions sab_functions;
+	sab_functions.sab_alloc = js_binder_sab_alloc;
+	sab_functions.sab_free = js_binder_sab_free;
+	sab_functions.sab_dup = js_binder_sab_dup;
+	sab_functions.sab_opaque = NULL;
+	JS_SetSharedArrayBufferFunctions(runtime, &sab_functions);
+	// Atomics.wait must never block the main thread
+	JS_SetCanBlock(runtime, false);
+
+	gc_step_usec = MAX(int(GLOBAL_GET("JavaScript/gc/incremental_step_usec")), 0);
+	JS_SetGCIncremental(runtime, gc_step_usec > 0);
+	live_collections = GLOBAL_GET("JavaScript/bindings/live_collections");
+	JS_SetGCNurserySize(runtime, MAX(int(GLOBAL_GET("JavaScript/gc/nursery_size")), 0));
+
+	if (JavaScriptLanguage::get_singleton()->get_main_binder() == this) {
+		transfer_depot.set_timeout(uint64_t(GLOBAL_GET("JavaScript/worker/transfer_timeout")) * 1000);
+	}
+
 	empty_function = JS_NewCFunction(ctx, js_empty_func, "virtual_fuction", 0);
 	// global = globalThis
 	global_object = JS_GetGlobalObject(ctx);
@@ -1254,6 +1457,7 @@ void QuickJSBinder::initialize() {
 	js_key_godot_signals = JS_NewAtom(ctx, JS_HIDDEN_SYMBOL("signals"));
 	js_key_godot_tooled = JS_NewAtom(ctx, JS_HIDDEN_SYMBOL("tool"));
 	js_key_godot_icon_path = JS_NewAtom(ctx, JS_HIDDEN_SYMBOL("icon"));
+	js_key_godot_pooled = JS_NewAtom(ctx, JS_HIDDEN_SYMBOL("pooled"));
 	JS_DefinePropertyValueStr(ctx, global_object, GODOT_OBJECT_NAME, godot_object, PROP_DEF_DEFAULT);
 	// godot.GodotOrigin
 	add_godot_origin();
@@ -1265,78 +1469,97 @@ void QuickJSBinder::initialize() {
 	add_godot_globals();
 	// globalThis.Worker
 	add_global_worker();
+	// godot.ObjectProxy
+	QuickJSObjectProxy::add_proxy_class(this);
+	// godot.ArrayProxy godot.DictionaryProxy
+	QuickJSCollectionProxy::add_proxy_classes(this);
 	// Other global properties
 	add_global_properties();
 	// globalThis.console
 	add_global_console();
-	// binding script
-	String script_binding_error;
-	JavaScriptGCHandler eval_ret;
-	if (OK == safe_eval_text(BINDING_SCRIPT_CONTENT, EVAL_TYPE_GLOBAL, "<internal: binding_script.js>", script_binding_error, eval_ret)) {
+	// binding script, compute contexts do not need its extensions of the engine classes
+	if (profile == PROFILE_FULL) {
+		String script_binding_error;
+		JavaScriptGCHandler eval_ret;
+		if (OK == safe_eval_text(BINDING_SCRIPT_CONTENT, EVAL_TYPE_GLOBAL, "<internal: binding_script.js>", script_binding_error, eval_ret)) {
 #ifdef TOOLS_ENABLED
-		if (eval_ret.javascript_object) {
-			JSValue ret = JS_MKPTR(JS_TAG_OBJECT, eval_ret.javascript_object);
-			modified_api = var_to_variant(ctx, ret);
-			JS_FreeValue(ctx, ret);
-		}
+			if (eval_ret.javascript_object) {
+				JSValue ret = JS_MKPTR(JS_TAG_OBJECT, eval_ret.javascript_object);
+				modified_api = var_to_variant(ctx, ret);
+				JS_FreeValue(ctx, ret);
+			}
 #endif
-	} else {
-		CRASH_NOW_MSG("Execute script binding failed:" ENDL + script_binding_error);
+		} else {
+			CRASH_NOW_MSG("Execute script binding failed:" ENDL + script_binding_error);
+		}
 	}
+	// after the binding script, it extends the prototypes of the engine classes
+	if (GLOBAL_GET("JavaScript/bindings/flatten_prototypes")) {
+		flatten_class_prototypes();
+	}
+	// Other contexts can send commands to the objects of this context from now on
+	QuickJSObjectProxy::register_context(this);
 
 #ifdef QUICKJS_WITH_DEBUGGER
-	debugger.instantiate();
-	bool is_editor_hint = false;
-	bool default_server_enabled = GLOBAL_DEF("JavaScript/debugger/enabled", false);
-	int default_port = GLOBAL_DEF("JavaScript/debugger/port", 5556);
+	// Workers and task runners would compete for the same port, only the main context can be debugged
+	if (JavaScriptLanguage::get_singleton()->get_main_binder() == this) {
+		debugger.instantiate();
+		bool is_editor_hint = false;
+		bool default_server_enabled = GLOBAL_DEF("JavaScript/debugger/enabled", false);
+		int default_port = GLOBAL_DEF("JavaScript/debugger/port", 5556);
 #ifdef TOOLS_ENABLED
-	is_editor_hint = Engine::get_singleton()->is_editor_hint();
+		is_editor_hint = Engine::get_singleton()->is_editor_hint();
 #endif
-	if (!is_editor_hint) {
-		List<String> args = OS::get_singleton()->get_cmdline_args();
-		if (List<String>::Element *E = args.find("--js-debugger-connect")) {
-			if (E->next() && E->next()->get().find(":") != -1) {
-				String address = E->next()->get();
-				Error err = debugger->connect_debugger(ctx, address);
-				if (err != OK) {
-					ERR_PRINT(vformat("Failed to connect to JavaScript debugger at %s", address));
+		if (!is_editor_hint) {
+			List<String> args = OS::get_singleton()->get_cmdline_args();
+			if (List<String>::Element *E = args.find("--js-debugger-connect")) {
+				if (E->next() && E->next()->get().find(":") != -1) {
+					String address = E->next()->get();
+					Error err = debugger->connect_debugger(ctx, address);
+					if (err != OK) {
+						ERR_PRINT(vformat("Failed to connect to JavaScript debugger at %s", address));
+					}
+				} else {
+					ERR_PRINT("Invalid debugger address");
 				}
-			} else {
-				ERR_PRINT("Invalid debugger address");
-			}
-		} else if (List<String>::Element *E2 = args.find("--js-debugger-listen")) {
-			if (E2->next() && E2->next()->get().find(":") != -1) {
-				String address = E2->next()->get();
+			} else if (List<String>::Element *E2 = args.find("--js-debugger-listen")) {
+				if (E2->next() && E2->next()->get().find(":") != -1) {
+					String address = E2->next()->get();
+					Error err = debugger->listen(ctx, address);
+					if (err == OK) {
+						print_line(vformat("JavaScript debugger started at %s", address));
+					} else {
+						ERR_PRINT(vformat("Failed to start JavaScript debugger at %s", address));
+					}
+				} else {
+					ERR_PRINT("Invalid debugger address");
+				}
+			} else if (default_server_enabled) {
+				String address = vformat("0.0.0.0:%d", default_port);
 				Error err = debugger->listen(ctx, address);
 				if (err == OK) {
 					print_line(vformat("JavaScript debugger started at %s", address));
 				} else {
 					ERR_PRINT(vformat("Failed to start JavaScript debugger at %s", address));
 				}
-			} else {
-				ERR_PRINT("Invalid debugger address");
-			}
-		} else if (default_server_enabled) {
-			String address = vformat("0.0.0.0:%d", default_port);
-			Error err = debugger->listen(ctx, address);
-			if (err == OK) {
-				print_line(vformat("JavaScript debugger started at %s", address));
-			} else {
-				ERR_PRINT(vformat("Failed to start JavaScript debugger at %s", address));
 			}
-		}
-	} else {
+		} else {
 #ifdef TOOLS_ENABLED
-		// TODO: debug editor plugin support
+			// TODO: debug editor plugin support
 #endif
+		}
 	}
 #endif
 }
 
 void QuickJSBinder::uninitialize() {
+	QuickJSTaskPool::cancel_batches(this);
+	QuickJSObjectProxy::unregister_context(this);
+
 	godot_object_class = NULL;
 	godot_reference_class = NULL;
 	builtin_binder.uninitialize();
+	clear_name_caches();
 
 	// Free singletons
 	for (int i = 0; i < godot_singletons.size(); i++) {
@@ -1354,6 +1577,10 @@ void QuickJSBinder::uninitialize() {
 		free_javascript_class(js_class);
 	}
 	javascript_classes.clear();
+	for (KeyValue<void *, InstancePool> &E : instance_pools) {
+		free_instance_pool(E.value);
+	}
+	instance_pools.clear();
 
 	// Free frame callbacks
 	for (const KeyValue<int64_t, JavaScriptGCHandler> &pair : frame_callbacks) {
@@ -1393,6 +1620,7 @@ void QuickJSBinder::uninitialize() {
 	JS_FreeAtom(ctx, js_key_godot_classname);
 	JS_FreeAtom(ctx, js_key_godot_tooled);
 	JS_FreeAtom(ctx, js_key_godot_icon_path);
+	JS_FreeAtom(ctx, js_key_godot_pooled);
 	JS_FreeAtom(ctx, js_key_godot_exports);
 	JS_FreeAtom(ctx, js_key_godot_signals);
 	JS_FreeValue(ctx, js_operators);
@@ -1420,11 +1648,14 @@ void QuickJSBinder::uninitialize() {
 		GLOBAL_LOCK_FUNCTION
 		JavaScriptLanguage::get_singleton()->thread_binder_map.erase(thread_id);
 	}
+	JavaScriptLanguage::thread_binder = nullptr;
 }
 
 void QuickJSBinder::language_finalize() {
-	GLOBAL_LOCK_FUNCTION
-	transfer_deopot.clear();
+	QuickJSTaskPool::finalize();
+	LocalVector<Variant> values;
+	transfer_depot.clear(values);
+	free_abandoned_values(values);
 }
 
 void QuickJSBinder::frame() {
@@ -1443,6 +1674,21 @@ void QuickJSBinder::frame() {
 		}
 	}
 
+	if (pending_task_batches.size()) {
+		QuickJSTaskPool::process_completions(this);
+	}
+
+	QuickJSObjectProxy::flush(this);
+
+	if (JavaScriptLanguage::get_singleton()->get_main_binder() == this) {
+		LocalVector<Variant> expired;
+		transfer_depot.sweep(expired);
+		if (expired.size()) {
+			WARN_PRINT(vformat("%d abandoned values were never adopted and have expired", expired.size()));
+			free_abandoned_values(expired);
+		}
+	}
+
 	for (List<JavaScriptGCHandler *>::Element *E = workers.front(); E; E = E->next()) {
 		JavaScriptGCHandler *bind = E->get();
 		QuickJSWorker *worker = static_cast<QuickJSWorker *>(bind->native_ptr);
@@ -1450,6 +1696,13 @@ void QuickJSBinder::frame() {
 		worker->frame_of_host(this, object);
 	}
 
+	if (gc_step_usec) {
+		// The steps are small enough to check the clock between them
+		const uint64_t deadline = OS::get_singleton()->get_ticks_usec() + gc_step_usec;
+		while (!JS_RunGCStep(runtime, GC_STEP_VISITS) && OS::get_singleton()->get_ticks_usec() < deadline) {
+		}
+	}
+
 	for (const KeyValue<int64_t, JavaScriptGCHandler> &pair : frame_callbacks) {
 		if (canceled_frame_callbacks.has(pair.key))
 			continue;
@@ -1476,7 +1729,9 @@ void QuickJSBinder::frame() {
 	canceled_frame_callbacks.clear();
 
 #ifdef QUICKJS_WITH_DEBUGGER
-	debugger->poll();
+	if (debugger.is_valid()) {
+		debugger->poll();
+	}
 #endif
 }
 
@@ -1575,7 +1830,11 @@ JavaScriptGCHandler *QuickJSBinder::alloc_object_binding_data(Object *p_object)
 
 void QuickJSBinder::free_object_binding_data(JavaScriptGCHandler *p_gc_handle) {
 	JavaScriptGCHandler *bind = (JavaScriptGCHandler *)p_gc_handle;
-	if (!bind->is_ref_counted()) {
+	// Abandoned objects have no JavaScript object left
+	if (!bind->is_ref_counted() && bind->context) {
+		if (get_context_binder((JSContext *)bind->context)->pool_binding(bind)) {
+			return;
+		}
 		JSValue js_obj = JS_MKPTR(JS_TAG_OBJECT, bind->javascript_object);
 		JS_SetOpaque(js_obj, NULL);
 		JS_FreeValue((JSContext *)bind->context, js_obj);
@@ -1583,11 +1842,110 @@ void QuickJSBinder::free_object_binding_data(JavaScriptGCHandler *p_gc_handle) {
 	memdelete(bind);
 }
 
+bool QuickJSBinder::pool_binding(JavaScriptGCHandler *p_bind) {
+	// The pools and the runtime of the context are only touched by its own thread
+	if (instance_pools.is_empty() || JavaScriptLanguage::get_current_thread_binder() != this || !p_bind->is_valid_javascript_object()) {
+		return false;
+	}
+	JSValue js_obj = JS_MKPTR(JS_TAG_OBJECT, p_bind->javascript_object);
+	// Objects still referenced by scripts cannot be given to another godot object
+	if (JS_GetRefCount(js_obj) != 1) {
+		return false;
+	}
+	JSValue prototype = JS_GetPrototype(ctx, js_obj);
+	InstancePool *pool = instance_pools.getptr(JS_VALUE_GET_PTR(prototype));
+	JS_FreeValue(ctx, prototype);
+	if (pool == NULL || pool->bindings.size() >= pool->capacity) {
+		return false;
+	}
+	JS_SetOpaque(js_obj, NULL);
+	p_bind->godot_object = NULL;
+	p_bind->flags |= JavaScriptGCHandler::FLAG_POOLED;
+	pool->bindings.push_back(p_bind);
+	return true;
+}
+
+JavaScriptGCHandler *QuickJSBinder::reuse_pooled_binding(const JavaScriptClassInfo *p_class, Object *p_object) {
+	InstancePool *pool = instance_pools.getptr(p_class->prototype.javascript_object);
+	if (pool == NULL) {
+		return NULL;
+	}
+	JavaScriptLanguage *lang = JavaScriptLanguage::get_singleton();
+	// The object is already bound when it was created by a script
+	if (pool->bindings.is_empty() || p_object->is_ref_counted() || p_object->has_instance_binding(lang)) {
+		pool->misses++;
+		return NULL;
+	}
+	pool->hits++;
+
+	JavaScriptGCHandler *bind = pool->bindings[pool->bindings.size() - 1];
+	pool->bindings.resize(pool->bindings.size() - 1);
+	bind->godot_object = p_object;
+	bind->flags &= ~JavaScriptGCHandler::FLAG_POOLED;
+	JSValue js_obj = JS_MKPTR(JS_TAG_OBJECT, bind->javascript_object);
+	JS_SetOpaque(js_obj, bind);
+	p_object->set_instance_binding(lang, bind, lang->get_instance_binding_callbacks());
+
+	// Nothing set by the previous object is kept, `_reset` initializes the fields that are not exported
+	clear_own_fields(ctx, js_obj);
+	initialize_properties(ctx, p_class, js_obj);
+	JSValue reset = JS_GetPropertyStr(ctx, js_obj, "_reset");
+	if (JS_IsFunction(ctx, reset)) {
+		JSValue ret = JS_Call(ctx, reset, js_obj, 0, NULL);
+		if (JS_IsException(ret)) {
+			JSValue e = JS_GetException(ctx);
+			JavaScriptError error;
+			dump_exception(ctx, e, &error);
+			JS_FreeValue(ctx, e);
+			ERR_PRINT(vformat("Cannot reset pooled instance of class '%s'\n%s", p_class->class_name, error_to_string(error)));
+		}
+		JS_FreeValue(ctx, ret);
+	}
+	JS_FreeValue(ctx, reset);
+	return bind;
+}
+
+void QuickJSBinder::clear_own_fields(JSContext *ctx, JSValueConst p_object) {
+	JSPropertyEnum *props = NULL;
+	uint32_t tab_atom_count = 0;
+	if (JS_GetOwnPropertyNames(ctx, &props, &tab_atom_count, p_object, JS_GPN_STRING_MASK | JS_GPN_SYMBOL_MASK) < 0) {
+		JS_FreeValue(ctx, JS_GetException(ctx));
+		return;
+	}
+	for (uint32_t i = 0; i < tab_atom_count; i++) {
+		JSPropertyDescriptor desc;
+		if (JS_GetOwnProperty(ctx, &desc, p_object, props[i].atom) > 0) {
+			if (!(desc.flags & JS_PROP_GETSET) && (desc.flags & JS_PROP_WRITABLE)) {
+				JS_DefinePropertyValue(ctx, p_object, props[i].atom, JS_UNDEFINED, desc.flags & JS_PROP_C_W_E);
+			}
+			JS_FreeValue(ctx, desc.value);
+			JS_FreeValue(ctx, desc.getter);
+			JS_FreeValue(ctx, desc.setter);
+		}
+		JS_FreeAtom(ctx, props[i].atom);
+	}
+	js_free_rt(JS_GetRuntime(ctx), props);
+}
+
+void QuickJSBinder::free_instance_pool(InstancePool &p_pool) {
+	for (uint32_t i = 0; i < p_pool.bindings.size(); i++) {
+		JS_FreeValue(ctx, JS_MKPTR(JS_TAG_OBJECT, p_pool.bindings[i]->javascript_object));
+		memdelete(p_pool.bindings[i]);
+	}
+	p_pool.bindings.clear();
+}
+
 Error QuickJSBinder::bind_gc_object(JSContext *ctx, JavaScriptGCHandler *data, Object *p_object) {
 	QuickJSBinder *binder = get_context_binder(ctx);
 	const ClassBindData **bind_ptr = binder->classname_bindings.getptr(p_object->get_class_name());
 	if (!bind_ptr)
 		bind_ptr = binder->classname_bindings.getptr(p_object->get_parent_class_static());
+	if (!bind_ptr && binder->profile == PROFILE_COMPUTE) {
+		// Only some classes are registered, use the closest registered base class
+		for (StringName cls = ClassDB::get_parent_class_nocheck(p_object->get_class_name()); !bind_ptr && cls != StringName(); cls = ClassDB::get_parent_class_nocheck(cls)) {
+			bind_ptr = binder->classname_bindings.getptr(cls);
+		}
+	}
 	if (!bind_ptr) {
 		bind_ptr = Object::cast_to<RefCounted>(p_object) == NULL ? &binder->godot_object_class : &binder->godot_reference_class;
 #ifdef DEBUG_ENABLED
@@ -1681,9 +2039,12 @@ JSValue QuickJSBinder::object_constructor(JSContext *ctx, JSValueConst new_targe
 	return js_obj;
 }
 
-void QuickJSBinder::initialize_properties(JSContext *ctx, const JavaScriptClassInfo *p_class, JSValue p_object) {
+void QuickJSBinder::initialize_properties(JSContext *ctx, const JavaScriptClassInfo *p_class, JSValue p_object, bool p_unshared_only) {
 	QuickJSBinder *binder = get_context_binder(ctx);
 	for (const KeyValue<StringName, JavaScriptProperyInfo> &pair : p_class->properties) {
+		if (p_unshared_only && is_shared_default(pair.value.default_value)) {
+			continue;
+		}
 		JSAtom pname = get_atom(ctx, pair.key);
 		int ret = JS_SetProperty(ctx, p_object, pname, variant_to_var(ctx, pair.value.default_value));
 		if (ret < 0) {
@@ -1755,12 +2116,22 @@ JSValue QuickJSBinder::godot_register_class(JSContext *ctx, JSValueConst this_va
 	return JS_UNDEFINED;
 }
 
+// The engine calls the batch hook of the class instead of `p_method` of its instances
+static void warn_if_batched(JSContext *ctx, JSValueConst p_prototype, const StringName &p_class_name, const char *p_method) {
+	JSValue method = JS_GetPropertyStr(ctx, p_prototype, p_method);
+	if (JS_IsFunction(ctx, method)) {
+		WARN_PRINT(vformat("%s.%s is never called, the class defines %s_batch which runs for all its instances instead.", p_class_name, p_method, p_method));
+	}
+	JS_FreeValue(ctx, method);
+}
+
 const JavaScriptClassInfo *QuickJSBinder::register_javascript_class(const JSValue &p_constructor, const String &p_path) {
 	QuickJSBinder *binder = get_context_binder(ctx);
 	JSValue prototype = JS_UNDEFINED;
 	JSValue classid = JS_UNDEFINED;
 	JSValue tooled = JS_UNDEFINED;
 	JSValue icon = JS_UNDEFINED;
+	JSValue pooled = JS_UNDEFINED;
 	JSClassID id = 0;
 
 	if (!JS_IsFunction(ctx, p_constructor)) {
@@ -1772,6 +2143,7 @@ const JavaScriptClassInfo *QuickJSBinder::register_javascript_class(const JSValu
 	classid = JS_GetProperty(ctx, prototype, js_key_godot_classid);
 	tooled = JS_GetProperty(ctx, p_constructor, js_key_godot_tooled);
 	icon = JS_GetProperty(ctx, p_constructor, js_key_godot_icon_path);
+	pooled = JS_GetProperty(ctx, p_constructor, js_key_godot_pooled);
 
 	if (JS_IsUndefined(classid)) {
 		JS_ThrowTypeError(ctx, "Godot class expected: %s", p_path.utf8().get_data());
@@ -1800,6 +2172,32 @@ const JavaScriptClassInfo *QuickJSBinder::register_javascript_class(const JSValu
 		if (JS_IsString(icon)) {
 			js_class.icon_path = js_to_string(ctx, icon);
 		}
+		js_class.pool_size = 0;
+		if (JS_IsNumber(pooled)) {
+			int32_t pool_size = 0;
+			JS_ToInt32(ctx, &pool_size, pooled);
+			js_class.pool_size = MAX(pool_size, 0);
+		}
+
+		// batch update hooks, they replace the methods of the instances
+		js_class.process_batch_frame = UINT64_MAX;
+		js_class.physics_process_batch_frame = UINT64_MAX;
+		JSValue process_batch = JS_GetPropertyStr(ctx, p_constructor, "_process_batch");
+		if (JS_IsFunction(ctx, process_batch)) {
+			js_class.process_batch.context = ctx;
+			js_class.process_batch.javascript_object = JS_VALUE_GET_PTR(process_batch);
+			warn_if_batched(ctx, prototype, class_name, "_process");
+		} else {
+			JS_FreeValue(ctx, process_batch);
+		}
+		JSValue physics_process_batch = JS_GetPropertyStr(ctx, p_constructor, "_physics_process_batch");
+		if (JS_IsFunction(ctx, physics_process_batch)) {
+			js_class.physics_process_batch.context = ctx;
+			js_class.physics_process_batch.javascript_object = JS_VALUE_GET_PTR(physics_process_batch);
+			warn_if_batched(ctx, prototype, class_name, "_physics_process");
+		} else {
+			JS_FreeValue(ctx, physics_process_batch);
+		}
 
 		// signals
 		JSValue signals = JS_GetProperty(ctx, prototype, js_key_godot_signals);
@@ -1878,6 +2276,29 @@ const JavaScriptClassInfo *QuickJSBinder::register_javascript_class(const JSValu
 		}
 		JS_FreeValue(ctx, props);
 
+		// instance template, not used if an exported property is also an accessor or method of the class
+		bool template_supported = true;
+		for (const KeyValue<StringName, JavaScriptProperyInfo> &E : js_class.properties) {
+			JSAtom pname = get_atom(ctx, E.key);
+			const bool found = JS_HasProperty(ctx, prototype, pname) > 0;
+			JS_FreeAtom(ctx, pname);
+			if (found) {
+				template_supported = false;
+				break;
+			}
+		}
+		if (template_supported) {
+			JSValue instance_template = JS_NewObjectProto(ctx, prototype);
+			for (const KeyValue<StringName, JavaScriptProperyInfo> &E : js_class.properties) {
+				JSAtom pname = get_atom(ctx, E.key);
+				const Variant &value = E.value.default_value;
+				JS_DefinePropertyValue(ctx, instance_template, pname, is_shared_default(value) ? variant_to_var(ctx, value) : JS_UNDEFINED, JS_PROP_C_W_E);
+				JS_FreeAtom(ctx, pname);
+			}
+			js_class.instance_template.context = ctx;
+			js_class.instance_template.javascript_object = JS_VALUE_GET_PTR(instance_template);
+		}
+
 		// methods
 		HashSet<String> keys;
 		get_own_property_names(ctx, prototype, &keys);
@@ -1907,11 +2328,15 @@ const JavaScriptClassInfo *QuickJSBinder::register_javascript_class(const JSValu
 		}
 		binder->javascript_classes.insert(p_path, js_class);
 		JS_DefinePropertyValue(ctx, prototype, js_key_godot_classname, to_js_string(ctx, p_path), PROP_DEF_DEFAULT);
+		if (js_class.pool_size > 0) {
+			binder->instance_pools[JS_VALUE_GET_PTR(prototype)].capacity = js_class.pool_size;
+		}
 	}
 fail:
 	JS_FreeValue(ctx, classid);
 	JS_FreeValue(ctx, prototype);
 	JS_FreeValue(ctx, icon);
+	JS_FreeValue(ctx, pooled);
 	JS_FreeValue(ctx, tooled);
 	return binder->javascript_classes.getptr(p_path);
 }
@@ -1919,6 +2344,21 @@ fail:
 void QuickJSBinder::free_javascript_class(const JavaScriptClassInfo &p_class) {
 	JSValue class_func = JS_MKPTR(JS_TAG_OBJECT, p_class.constructor.javascript_object);
 	JS_FreeValue(ctx, class_func);
+	if (p_class.process_batch.javascript_object) {
+		JS_FreeValue(ctx, JS_MKPTR(JS_TAG_OBJECT, p_class.process_batch.javascript_object));
+	}
+	if (p_class.physics_process_batch.javascript_object) {
+		JS_FreeValue(ctx, JS_MKPTR(JS_TAG_OBJECT, p_class.physics_process_batch.javascript_object));
+	}
+	if (p_class.instance_template.javascript_object) {
+		JS_FreeValue(ctx, JS_MKPTR(JS_TAG_OBJECT, p_class.instance_template.javascript_object));
+	}
+	// Pooled instances have the prototype of the freed class
+	HashMap<void *, InstancePool>::Iterator E = instance_pools.find(p_class.prototype.javascript_object);
+	if (E) {
+		free_instance_pool(E->value);
+		instance_pools.remove(E);
+	}
 }
 
 JSValue QuickJSBinder::godot_register_signal(JSContext *ctx, JSValue this_val, int argc, JSValue *argv) {
@@ -2003,10 +2443,33 @@ JSValue QuickJSBinder::godot_set_script_meta(JSContext *ctx, JSValue this_val, i
 		case QuickJSBinder::SCRIPT_META_ICON:
 			JS_SetProperty(ctx, constructor, binder->js_key_godot_icon_path, JS_DupValue(ctx, argv[1]));
 			break;
+		case QuickJSBinder::SCRIPT_META_POOLED:
+			ERR_FAIL_COND_V(!JS_IsNumber(argv[1]), JS_ThrowTypeError(ctx, "number expected for argument #1"));
+			JS_SetProperty(ctx, constructor, binder->js_key_godot_pooled, JS_DupValue(ctx, argv[1]));
+			break;
 	}
 	return JS_UNDEFINED;
 }
 
+JSValue QuickJSBinder::godot_get_script_pool_info(JSContext *ctx, JSValue this_val, int argc, JSValue *argv) {
+	ERR_FAIL_COND_V(argc < 1 || !JS_IsFunction(ctx, argv[0]), JS_ThrowTypeError(ctx, "godot class expected for argument #0"));
+	QuickJSBinder *binder = get_context_binder(ctx);
+	JSValue prototype = JS_GetProperty(ctx, argv[0], JS_ATOM_prototype);
+	const InstancePool *pool = binder->instance_pools.getptr(JS_VALUE_GET_PTR(prototype));
+	JS_FreeValue(ctx, prototype);
+	if (pool == NULL) {
+		return JS_NULL;
+	}
+	const uint64_t requests = pool->hits + pool->misses;
+	JSValue info = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, info, "size", JS_NewInt64(ctx, pool->bindings.size()));
+	JS_SetPropertyStr(ctx, info, "capacity", JS_NewInt64(ctx, pool->capacity));
+	JS_SetPropertyStr(ctx, info, "hits", JS_NewInt64(ctx, pool->hits));
+	JS_SetPropertyStr(ctx, info, "misses", JS_NewInt64(ctx, pool->misses));
+	JS_SetPropertyStr(ctx, info, "hit_rate", JS_NewFloat64(ctx, requests ? double(pool->hits) / requests : 0.0));
+	return info;
+}
+
 JSValue QuickJSBinder::global_request_animation_frame(JSContext *ctx, JSValue this_val, int argc, JSValue *argv) {
 	ERR_FAIL_COND_V(argc < 1 || !JS_IsFunction(ctx, argv[0]), JS_ThrowTypeError(ctx, "Function expected for argument #0"));
 	static SafeNumeric<int64_t> id;
@@ -2055,12 +2518,23 @@ JavaScriptGCHandler QuickJSBinder::create_js_instance_for_godot_object(const Jav
 	ERR_FAIL_NULL_V(p_object, JavaScriptGCHandler());
 	ERR_FAIL_NULL_V(p_class, JavaScriptGCHandler());
 
+	if (p_class->pool_size > 0) {
+		if (JavaScriptGCHandler *pooled = reuse_pooled_binding(p_class, p_object)) {
+			return *pooled;
+		}
+	}
+
 	JavaScriptGCHandler *bind = BINDING_DATA_FROM_GD(ctx, p_object);
 	ERR_FAIL_NULL_V(bind, JavaScriptGCHandler());
 
 	JSValue constructor = JS_MKPTR(JS_TAG_OBJECT, p_class->constructor.javascript_object);
 	JSValue object = JS_MKPTR(JS_TAG_OBJECT, bind->javascript_object);
 	JS_CallConstructor2(ctx, constructor, object, 0, NULL);
+	// Take the shape and the defaults of the template at once if the constructor did not add properties
+	if (p_class->instance_template.javascript_object && JS_SetObjectTemplate(ctx, object, GET_JSVALUE(p_class->instance_template)) == 0) {
+		initialize_properties(ctx, p_class, object, true);
+		return *bind;
+	}
 	if (JS_SetPrototype(ctx, object, JS_MKPTR(JS_TAG_OBJECT, p_class->prototype.javascript_object)) < 0) {
 		JSValue e = JS_GetException(ctx);
 		JavaScriptError error;
@@ -2231,6 +2705,37 @@ JSValue QuickJSBinder::worker_constructor(JSContext *ctx, JSValue this_val, int
 	QuickJSBinder *host = QuickJSBinder::get_context_binder(ctx);
 
 	QuickJSWorker *worker = memnew(QuickJSWorker(host));
+	if (argc > 1 && JS_IsObject(argv[1])) {
+		JSValue serialization = JS_GetPropertyStr(ctx, argv[1], "serialization");
+		if (JS_IsString(serialization)) {
+			worker->set_structured_clone(js_to_string(ctx, serialization) == "structured");
+		}
+		JS_FreeValue(ctx, serialization);
+
+		JSValue profile = JS_GetPropertyStr(ctx, argv[1], "profile");
+		if (JS_IsString(profile) && js_to_string(ctx, profile) == "compute") {
+			HashSet<StringName> class_allow_list;
+			JSValue classes = JS_GetPropertyStr(ctx, argv[1], "classes");
+			if (JS_IsArray(ctx, classes)) {
+				int length = get_js_array_length(ctx, classes);
+				for (int i = 0; i < length; i++) {
+					JSValue item = JS_GetPropertyUint32(ctx, classes, i);
+					StringName class_name = js_to_string(ctx, item);
+					JS_FreeValue(ctx, item);
+					if (!ClassDB::class_exists(class_name)) {
+						JS_FreeValue(ctx, classes);
+						JS_FreeValue(ctx, profile);
+						memdelete(worker);
+						return JS_ThrowTypeError(ctx, "unknown class '%s' in the classes of the worker", String(class_name).utf8().get_data());
+					}
+					class_allow_list.insert(class_name);
+				}
+			}
+			JS_FreeValue(ctx, classes);
+			worker->set_profile(PROFILE_COMPUTE, class_allow_list);
+		}
+		JS_FreeValue(ctx, profile);
+	}
 	worker->start(js_to_string(ctx, argv[0]));
 	JSValue obj = JS_NewObjectProtoClass(ctx, host->worker_class_data.prototype, host->worker_class_data.class_id);
 
@@ -2261,7 +2766,14 @@ JSValue QuickJSBinder::worker_post_message(JSContext *ctx, JSValue this_val, int
 	QuickJSBinder *host = QuickJSBinder::get_context_binder(ctx);
 	if (JavaScriptGCHandler *bind = static_cast<JavaScriptGCHandler *>(JS_GetOpaque(this_val, host->worker_class_data.class_id))) {
 		QuickJSWorker *worker = static_cast<QuickJSWorker *>(bind->native_ptr);
-		worker->post_message_from_host(var_to_variant(ctx, argv[0]));
+		QuickJSWorkerMessage message;
+		if (!QuickJSWorker::write_message(ctx, argv[0], argc > 1 ? argv[1] : JS_UNDEFINED, worker->is_structured_clone(), message)) {
+			return JS_EXCEPTION;
+		}
+		if (!worker->post_message_from_host(message)) {
+			QuickJSWorker::free_message(host->runtime, message);
+			return JS_ThrowRangeError(ctx, "the message queue of the worker is full");
+		}
 	}
 	return JS_UNDEFINED;
 }
@@ -2278,34 +2790,80 @@ JSValue QuickJSBinder::worker_terminate(JSContext *ctx, JSValue this_val, int ar
 	return JS_UNDEFINED;
 }
 
+bool QuickJSBinder::abandon_object(JSContext *ctx, JSValueConst p_value) {
+	JavaScriptGCHandler *data = BINDING_DATA_FROM_JS(ctx, p_value);
+	if (!data) {
+		return false;
+	}
+	JS_SetOpaque(p_value, NULL);
+	if (data->is_ref_counted()) {
+		static_cast<RefCounted *>(data->godot_object)->unreference();
+	} else if (data->is_object()) {
+		JS_FreeValue(ctx, p_value);
+	}
+	data->godot_object = NULL;
+	data->javascript_object = NULL;
+	data->context = NULL;
+	data->flags |= JavaScriptGCHandler::FLAG_TRANSFERABLE;
+	return true;
+}
+
+void QuickJSBinder::abandon_array_objects(JSContext *ctx, JSValueConst p_array, const Array &p_value) {
+	// Follows the converted array, the circular references it dropped are not visited
+	int length = MIN(get_js_array_length(ctx, p_array), p_value.size());
+	for (int i = 0; i < length; i++) {
+		JSValue item = JS_GetPropertyUint32(ctx, p_array, i);
+		if (JS_GetOpaque(item, get_origin_class_id(ctx))) {
+			abandon_object(ctx, item);
+		} else if (p_value[i].get_type() == Variant::ARRAY && JS_IsArray(ctx, item)) {
+			abandon_array_objects(ctx, item, p_value[i]);
+		}
+		JS_FreeValue(ctx, item);
+	}
+}
+
+void QuickJSBinder::free_abandoned_values(const LocalVector<Variant> &p_values) {
+	for (uint32_t i = 0; i < p_values.size(); i++) {
+		free_abandoned_objects(p_values[i]);
+	}
+}
+
+void QuickJSBinder::free_abandoned_objects(const Variant &p_value) {
+	if (p_value.get_type() == Variant::ARRAY) {
+		const Array arr = p_value;
+		for (int i = 0; i < arr.size(); i++) {
+			free_abandoned_objects(arr[i]);
+		}
+		return;
+	}
+	// References are released with the value, the validation skips an object listed twice
+	Object *obj = p_value.get_validated_object();
+	if (obj == NULL || obj->is_ref_counted()) {
+		return;
+	}
+	// Objects of the array still bound to a context are not part of the abandoned value
+	JavaScriptGCHandler *data = BINDING_DATA_FROM_GD(obj);
+	if (data && data->context == NULL && (data->flags & JavaScriptGCHandler::FLAG_TRANSFERABLE)) {
+		memdelete(obj);
+	}
+}
+
 JSValue QuickJSBinder::godot_abandon_value(JSContext *ctx, JSValue this_val, int argc, JSValue *argv) {
 	ERR_FAIL_COND_V(argc != 1, JS_ThrowTypeError(ctx, "one argument expected"));
 	JSValue &value = argv[0];
 	bool valid = true;
+	// The Variant keeps the objects alive until they are adopted
 	Variant gd_value = var_to_variant(ctx, value);
 	if (gd_value.get_type() == Variant::OBJECT) {
-		JavaScriptGCHandler *data = BINDING_DATA_FROM_JS(ctx, value);
-		if (data) {
-			JS_SetOpaque(value, NULL);
-			if (data->is_ref_counted()) {
-				static_cast<RefCounted *>(data->godot_object)->unreference();
-			} else if (data->is_object()) {
-				JS_FreeValue(ctx, value);
-			}
-			data->godot_object = NULL;
-			data->javascript_object = NULL;
-			data->context = NULL;
-			data->flags |= JavaScriptGCHandler::FLAG_TRANSFERABLE;
-		} else {
-			valid = false;
-		}
+		valid = abandon_object(ctx, value);
+	} else if (gd_value.get_type() == Variant::ARRAY && JS_IsArray(ctx, value)) {
+		// Abandon all the objects of the array at once, they are adopted together as a new array
+		abandon_array_objects(ctx, value, gd_value);
 	}
 
 	uint64_t id = 0;
 	if (valid) {
-		id = QuickJSBinder::global_transfer_id.increment();
-		GLOBAL_LOCK_FUNCTION
-		transfer_deopot.insert(id, gd_value);
+		id = transfer_depot.store(gd_value);
 	}
 	return JS_NewInt64(ctx, id);
 }
@@ -2316,14 +2874,7 @@ JSValue QuickJSBinder::godot_adopt_value(JSContext *ctx, JSValue this_val, int a
 	ERR_FAIL_COND_V(id == 0, JS_ThrowTypeError(ctx, "id must greater than 0"));
 
 	Variant value;
-	{
-		GLOBAL_LOCK_FUNCTION
-		if (Variant *ptr = transfer_deopot.getptr(id)) {
-			value = *ptr;
-			transfer_deopot.erase(id);
-		}
-	}
-	ERR_FAIL_NULL_V(static_cast<Object *>(value), JS_UNDEFINED);
+	ERR_FAIL_COND_V_MSG(!transfer_depot.take(id, value), JS_UNDEFINED, "The value has already been adopted or has expired.");
 	return variant_to_var(ctx, value);
 }
 
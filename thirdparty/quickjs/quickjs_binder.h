@@ -3,12 +3,19 @@
 
 #include "core/io/resource.h"
 #include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/callable.h"
 
 #include "../../javascript_binder.h"
 #include "quickjs/quickjs.h"
 #include "quickjs_builtin_binder.h"
+#include "quickjs_collection_proxy.h"
+#include "quickjs_object_proxy.h"
+#include "quickjs_transfer_depot.h"
 
 #ifdef QUICKJS_WITH_DEBUGGER
 #include "quickjs_debugger.h"
@@ -22,15 +29,21 @@
 #define MAX_ARGUMENT_COUNT 50
 #define PROP_NAME_CONSOLE_LOG_OBJECT_TO_JSON "LOG_OBJECT_TO_JSON"
 #define ENDL "\r\n"
+#define GC_STEP_VISITS 1024
+#define NAME_CACHE_MAX 4096
+
+struct QuickJSTaskBatch;
 
 class QuickJSBinder : public JavaScriptBinder {
 	friend class QuickJSBuiltinBinder;
 	friend class QuickJSWorker;
+	friend class QuickJSTaskPool;
+	friend class QuickJSObjectProxy;
+	friend class QuickJSCollectionProxy;
 	QuickJSBuiltinBinder builtin_binder;
 
 protected:
 	static SafeNumeric<uint32_t> global_context_id;
-	static SafeNumeric<uint64_t> global_transfer_id;
 	JSRuntime *runtime;
 	JSContext *ctx;
 	JSMallocFunctions godot_allocator;
@@ -92,6 +105,13 @@ public:
 		JS_ATOM_END,
 	};
 
+	enum Profile {
+		// All the engine classes, singletons, constants and the binding script
+		PROFILE_FULL,
+		// Only the builtin types and the classes of `class_allow_list` with their base classes
+		PROFILE_COMPUTE,
+	};
+
 	enum ConsoleLogType {
 		CONSOLE_LOG,
 		CONSOLE_WARN,
@@ -104,6 +124,7 @@ protected:
 	JSAtom js_key_godot_classname;
 	JSAtom js_key_godot_tooled;
 	JSAtom js_key_godot_icon_path;
+	JSAtom js_key_godot_pooled;
 	JSAtom js_key_godot_exports;
 	JSAtom js_key_godot_signals;
 
@@ -115,6 +136,15 @@ protected:
 	JSValue js_operators_create;
 	Vector<JSValue> godot_singletons;
 
+	Profile profile = PROFILE_FULL;
+	HashSet<StringName> class_allow_list;
+	// Time given to the incremental cycle collection each frame, 0 if it is disabled
+	uint64_t gc_step_usec = 0;
+	// Engine arrays and dictionaries are passed to the scripts as proxies sharing them instead of as copies
+	bool live_collections = false;
+	ClassBindData array_proxy_class_data;
+	ClassBindData dictionary_proxy_class_data;
+
 	_FORCE_INLINE_ static void *js_binder_malloc(JSMallocState *s, size_t size) { return memalloc(size); }
 	_FORCE_INLINE_ static void js_binder_free(JSMallocState *s, void *ptr) {
 		if (ptr)
@@ -122,6 +152,11 @@ protected:
 	}
 	_FORCE_INLINE_ static void *js_binder_realloc(JSMallocState *s, void *ptr, size_t size) { return memrealloc(ptr, size); }
 
+	// SharedArrayBuffer memory is reference counted so it can be shared by all runtimes
+	static void *js_binder_sab_alloc(void *opaque, size_t size);
+	static void js_binder_sab_free(void *opaque, void *ptr);
+	static void js_binder_sab_dup(void *opaque, void *ptr);
+
 	static String resolve_module_file(const String &file);
 	static JSModuleDef *js_module_loader(JSContext *ctx, const char *module_name, void *opaque);
 	static JSModuleDef *js_make_module(JSContext *ctx, const String &p_id, const JSValueConst &p_value);
@@ -149,8 +184,34 @@ protected:
 	HashMap<String, CommonJSModule> commonjs_module_cache;
 	ClassBindData worker_class_data;
 	List<JavaScriptGCHandler *> workers;
+	// `godot.parallel` calls started by this context, completed batches are pushed by the task pool threads
+	LocalVector<QuickJSTaskBatch *> pending_task_batches;
+	LocalVector<QuickJSTaskBatch *> completed_task_batches;
+	Mutex task_mutex;
+	// Set while the context waits for its cancelled batches, the runners then post `task_semaphore` for each batch they complete
+	bool cancelling_task_batches = false;
+	Semaphore task_semaphore;
+	// Bindings of the freed instances of pooled script classes, by class prototype
+	struct InstancePool {
+		LocalVector<JavaScriptGCHandler *> bindings;
+		uint32_t capacity = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+	};
+	HashMap<void *, InstancePool> instance_pools;
+	// Commands sent by other contexts to the objects of this context, and replies to the commands this context sent
+	ClassBindData object_proxy_class_data;
+	Mutex proxy_mutex;
+	LocalVector<QuickJSProxyCommand> proxy_commands;
+	LocalVector<QuickJSProxyReply> proxy_replies;
+	HashMap<uint64_t, QuickJSProxyRequest> proxy_requests;
+	uint64_t last_proxy_request = 0;
 	Vector<MethodBind *> godot_methods;
 	int internal_godot_method_id;
+	// Names and paths built from the interned strings of the scripts, like the string literals, by atom
+	HashMap<JSAtom, StringName> string_name_cache;
+	HashMap<JSAtom, NodePath> node_path_cache;
+	void clear_name_caches();
 	Vector<const ClassDB::PropertySetGet *> godot_object_indexed_properties;
 	int internal_godot_indexed_property_id;
 #if NO_MODULE_EXPORT_SUPPORT
@@ -160,13 +221,18 @@ protected:
 	JSClassID register_class(const ClassDB::ClassInfo *p_cls);
 	void add_godot_origin();
 	void add_godot_classes();
+	/* Copies the inherited methods and properties of every engine class onto its own prototype */
+	void flatten_class_prototypes();
 	void add_godot_globals();
 	void add_global_console();
 	void add_global_properties();
 	void add_global_worker();
 
 	static JSValue object_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv, int class_id);
-	static void initialize_properties(JSContext *ctx, const JavaScriptClassInfo *p_class, JSValue p_object);
+	/* Sets the default values of the exported properties, only the ones that are not in the instance template with `p_unshared_only` */
+	static void initialize_properties(JSContext *ctx, const JavaScriptClassInfo *p_class, JSValue p_object, bool p_unshared_only = false);
+	/* Immutable default values that all the instances can share through the instance template */
+	_FORCE_INLINE_ static bool is_shared_default(const Variant &p_value) { return p_value.get_type() <= Variant::STRING; }
 
 	static void object_finalizer(JavaScriptGCHandler *p_bind);
 	static void origin_finalizer(JSRuntime *rt, JSValue val);
@@ -192,8 +258,18 @@ protected:
 	enum {
 		SCRIPT_META_TOOLED,
 		SCRIPT_META_ICON,
+		SCRIPT_META_POOLED,
 	};
 	static JSValue godot_set_script_meta(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv, int magic);
+	static JSValue godot_get_script_pool_info(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+
+	/* Keeps the binding of a freed instance of a pooled class, returns false if it must be freed. Only pools on the thread of the context */
+	bool pool_binding(JavaScriptGCHandler *p_bind);
+	/* Binds `p_object` to a pooled instance of `p_class` and resets it, returns NULL if the pool is empty */
+	JavaScriptGCHandler *reuse_pooled_binding(const JavaScriptClassInfo *p_class, Object *p_object);
+	/* Sets the own data properties of `p_object` to undefined, keeping its shape */
+	static void clear_own_fields(JSContext *ctx, JSValueConst p_object);
+	void free_instance_pool(InstancePool &p_pool);
 
 	static JSValue console_functions(JSContext *ctx, JSValue this_val, int argc, JSValue *argv, int magic);
 	static JSValue global_request_animation_frame(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
@@ -203,6 +279,11 @@ protected:
 	static void worker_finializer(JSRuntime *rt, JSValue val);
 	static JSValue worker_post_message(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
 	static JSValue worker_terminate(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+	static bool abandon_object(JSContext *ctx, JSValueConst p_value);
+	static void abandon_array_objects(JSContext *ctx, JSValueConst p_array, const Array &p_value);
+	// Frees the objects of abandoned values that were never adopted, they have no context left to free them
+	static void free_abandoned_values(const LocalVector<Variant> &p_values);
+	static void free_abandoned_objects(const Variant &p_value);
 	static JSValue godot_abandon_value(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
 	static JSValue godot_adopt_value(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
 
@@ -214,12 +295,13 @@ protected:
 	static void get_own_property_names(JSContext *ctx, JSValue p_object, HashSet<String> *r_list);
 
 	static JSAtom get_atom(JSContext *ctx, const StringName &p_key);
-	static HashMap<uint64_t, Variant> transfer_deopot;
+	static QuickJSTransferDepot transfer_depot;
 	static HashMap<String, const char *> class_remap;
 #ifdef TOOLS_ENABLED
 	Dictionary modified_api;
 #endif
 public:
+	_FORCE_INLINE_ static QuickJSTransferDepot &get_transfer_depot() { return transfer_depot; }
 	static Error define_operators(JSContext *ctx, JSValue p_prototype, JSValue *p_operators, int p_size);
 
 	/**
@@ -233,14 +315,18 @@ public:
 	static Vector<String> get_function_args(JSContext *ctx, JSValue p_val);
 
 	static JSValue variant_to_var(JSContext *ctx, const Variant p_var);
-	static Variant var_to_variant(JSContext *ctx, JSValue p_val);
+	// `p_ancestors` holds the arrays and objects being converted around `p_val`, to stop at circular references
+	static Variant var_to_variant(JSContext *ctx, JSValue p_val, HashSet<void *> *p_ancestors = NULL);
 	static bool validate_type(JSContext *ctx, Variant::Type p_type, JSValueConst &p_val);
 	static void dump_exception(JSContext *ctx, const JSValueConst &p_exception, JavaScriptError *r_error);
 	virtual String error_to_string(const JavaScriptError &p_error) override;
 	virtual Error get_stacks(List<JavaScriptStackInfo> &r_stacks) override;
 	virtual String get_backtrace_message(const List<JavaScriptStackInfo> &stacks) override;
 
-	static Dictionary js_to_dictionary(JSContext *ctx, const JSValueConst &p_val, List<void *> &stack);
+	static Dictionary js_to_dictionary(JSContext *ctx, const JSValueConst &p_val, HashSet<void *> &ancestors);
+	// Cached when `p_val` is an interned string, so passing the same literal does not build the name again
+	static StringName js_to_string_name(JSContext *ctx, const JSValueConst &p_val);
+	static NodePath js_to_node_path(JSContext *ctx, const JSValueConst &p_val);
 
 	_FORCE_INLINE_ static real_t js_to_number(JSContext *ctx, const JSValueConst &p_val) {
 		double_t v = 0;
@@ -249,10 +335,18 @@ public:
 	}
 	_FORCE_INLINE_ static String js_to_string(JSContext *ctx, const JSValueConst &p_val) {
 		String ret;
-		size_t len = 0;
-		const char *utf8 = JS_ToCStringLen(ctx, &len, p_val);
-		ret.parse_utf8(utf8, len);
-		JS_FreeCString(ctx, utf8);
+		// Copied straight from the 8 or 16 bit string, without going through UTF-8
+		JSValue str = JS_ToString(ctx, p_val);
+		if (!JS_IsException(str)) {
+			size_t len = JS_GetStringUTF32(str, nullptr);
+			if (len) {
+				ret.resize(len + 1);
+				char32_t *dst = ret.ptrw();
+				JS_GetStringUTF32(str, reinterpret_cast<uint32_t *>(dst));
+				dst[len] = 0;
+			}
+		}
+		JS_FreeValue(ctx, str);
 		return ret;
 	}
 	_FORCE_INLINE_ static bool js_to_bool(JSContext *ctx, const JSValueConst &p_val) {
@@ -281,9 +375,11 @@ public:
 	_FORCE_INLINE_ static JSValue to_js_number(JSContext *ctx, real_t p_val) {
 		return JS_NewFloat64(ctx, double(p_val));
 	}
+	_FORCE_INLINE_ static JSValue to_js_int64(JSContext *ctx, int64_t p_val) {
+		return JS_NewInt64(ctx, p_val);
+	}
 	_FORCE_INLINE_ static JSValue to_js_string(JSContext *ctx, const String &text) {
-		CharString utf8 = text.utf8();
-		return JS_NewStringLen(ctx, utf8.get_data(), utf8.length());
+		return JS_NewStringUTF32(ctx, reinterpret_cast<const uint32_t *>(text.ptr()), text.length());
 	}
 	_FORCE_INLINE_ static JSValue to_js_bool(JSContext *ctx, bool p_val) {
 		return JS_NewBool(ctx, p_val);
@@ -314,6 +410,11 @@ public:
 
 	virtual Thread::ID get_thread_id() const override { return thread_id; }
 
+	_FORCE_INLINE_ JSRuntime *get_runtime() const { return runtime; }
+	_FORCE_INLINE_ JSContext *get_context() const { return ctx; }
+	_FORCE_INLINE_ int get_string_name_cache_size() const { return string_name_cache.size(); }
+	_FORCE_INLINE_ int get_node_path_cache_size() const { return node_path_cache.size(); }
+
 	_FORCE_INLINE_ static QuickJSBinder *get_runtime_binder(JSRuntime *rt) {
 		return static_cast<QuickJSBinder *>(JS_GetMollocState(rt)->opaque);
 	}
@@ -334,6 +435,15 @@ public:
 	virtual void uninitialize() override;
 	virtual void language_finalize() override;
 	virtual void frame() override;
+	/* Wake up the thread that runs this binder's frame loop if it is blocked waiting for work */
+	virtual void wake_up() const {}
+
+	/* Must be called before `initialize` */
+	_FORCE_INLINE_ void set_profile(Profile p_profile, const HashSet<StringName> &p_class_allow_list) {
+		profile = p_profile;
+		class_allow_list = p_class_allow_list;
+	}
+	_FORCE_INLINE_ Profile get_profile() const { return profile; }
 
 	virtual JavaScriptGCHandler *alloc_object_binding_data(Object *p_object) override;
 	virtual void free_object_binding_data(JavaScriptGCHandler *p_gc_handle) override;
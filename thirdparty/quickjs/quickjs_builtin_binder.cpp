@@ -75,6 +75,36 @@ void QuickJSBuiltinBinder::bind_builtin_object(JSContext *ctx, JSValue target, V
 			bind = memnew_placement(ptr, JavaScriptGCHandler);
 			memnew_placement(bind + 1, AABB(*static_cast<const AABB *>(p_object)));
 			break;
+		case Variant::VECTOR2I:
+			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(Vector2i));
+			bind = memnew_placement(ptr, JavaScriptGCHandler);
+			memnew_placement(bind + 1, Vector2i(*static_cast<const Vector2i *>(p_object)));
+			break;
+		case Variant::VECTOR3I:
+			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(Vector3i));
+			bind = memnew_placement(ptr, JavaScriptGCHandler);
+			memnew_placement(bind + 1, Vector3i(*static_cast<const Vector3i *>(p_object)));
+			break;
+		case Variant::VECTOR4:
+			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(Vector4));
+			bind = memnew_placement(ptr, JavaScriptGCHandler);
+			memnew_placement(bind + 1, Vector4(*static_cast<const Vector4 *>(p_object)));
+			break;
+		case Variant::VECTOR4I:
+			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(Vector4i));
+			bind = memnew_placement(ptr, JavaScriptGCHandler);
+			memnew_placement(bind + 1, Vector4i(*static_cast<const Vector4i *>(p_object)));
+			break;
+		case Variant::RECT2I:
+			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(Rect2i));
+			bind = memnew_placement(ptr, JavaScriptGCHandler);
+			memnew_placement(bind + 1, Rect2i(*static_cast<const Rect2i *>(p_object)));
+			break;
+		case Variant::PROJECTION:
+			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(Projection));
+			bind = memnew_placement(ptr, JavaScriptGCHandler);
+			memnew_placement(bind + 1, Projection(*static_cast<const Projection *>(p_object)));
+			break;
 		case Variant::PACKED_INT32_ARRAY:
 			ptr = memalloc(sizeof(JavaScriptGCHandler) + sizeof(PackedInt32Array));
 			bind = memnew_placement(ptr, JavaScriptGCHandler);
@@ -221,6 +251,14 @@ void QuickJSBuiltinBinder::register_method(Variant::Type p_type, const char *p_n
 	JS_FreeAtom(ctx, atom);
 }
 
+void QuickJSBuiltinBinder::register_static_method(Variant::Type p_type, const char *p_name, JSCFunction *p_func, int p_length) {
+	const BuiltinClass &cls = get_class(p_type);
+	JSValue func = JS_NewCFunction(ctx, p_func, p_name, p_length);
+	JSAtom atom = JS_NewAtom(ctx, p_name);
+	JS_DefinePropertyValue(ctx, cls.class_function, atom, func, QuickJSBinder::PROP_DEF_DEFAULT);
+	JS_FreeAtom(ctx, atom);
+}
+
 void QuickJSBuiltinBinder::register_constant(Variant::Type p_type, const char *p_name, const Variant &p_value) {
 	const BuiltinClass &cls = get_class(p_type);
 	JSValue val = QuickJSBinder::variant_to_var(ctx, p_value);
@@ -229,6 +267,23 @@ void QuickJSBuiltinBinder::register_constant(Variant::Type p_type, const char *p
 	JS_FreeAtom(ctx, atom);
 }
 
+// Integer vectors scaled by an integer stay integer vectors, other numbers give a float vector like in GDScript.
+// Dividing by 0 throws, as dividing by a vector with a zero component does.
+template <class V, class F>
+static JSValue scale_integer_vector(JSContext *ctx, const V &p_vector, JSValueConst p_scalar, bool p_divide) {
+	double scalar = 0;
+	JS_ToFloat64(ctx, &scalar, p_scalar);
+	if (scalar >= INT32_MIN && scalar <= INT32_MAX && scalar == double(int32_t(scalar))) {
+		const int32_t integer = int32_t(scalar);
+		if (p_divide && !QuickJSBuiltinBinder::is_integer_division_defined(p_vector, integer)) {
+			return JS_ThrowRangeError(ctx, integer == 0 ? "Integer division by zero" : "Integer division overflow");
+		}
+		return QuickJSBuiltinBinder::new_object_from(ctx, p_divide ? p_vector / integer : p_vector * integer);
+	}
+	const F vector = F(p_vector);
+	return QuickJSBuiltinBinder::new_object_from(ctx, p_divide ? vector / real_t(scalar) : vector * real_t(scalar));
+}
+
 void QuickJSBuiltinBinder::get_cross_type_operators(Variant::Type p_type, Vector<JSValue> &r_operators) {
 	JSValue Number = JS_GetProperty(ctx, binder->global_object, QuickJSBinder::JS_ATOM_Number);
 
@@ -460,6 +515,171 @@ void QuickJSBuiltinBinder::get_cross_type_operators(Variant::Type p_type, Vector
 							"multiply_number_right", 2),
 					QuickJSBinder::PROP_DEF_DEFAULT);
 		} break;
+		case Variant::VECTOR2I: {
+			JSValue number_left = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_left, "left", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_left);
+
+			JSValue number_right = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_right, "right", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_right);
+
+			// 2 * new godot.Vector2i(2, 3)
+			JS_DefinePropertyValueStr(ctx, number_left, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+								return scale_integer_vector<Vector2i, Vector2>(ctx, *bind->getVector2i(), argv[0], false);
+							},
+							"multiply_number_left", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector2i(2, 3) * 2
+			JS_DefinePropertyValueStr(ctx, number_right, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								return scale_integer_vector<Vector2i, Vector2>(ctx, *bind->getVector2i(), argv[1], false);
+							},
+							"multiply_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector2i(2, 3) / 2
+			JS_DefinePropertyValueStr(ctx, number_right, "/",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								return scale_integer_vector<Vector2i, Vector2>(ctx, *bind->getVector2i(), argv[1], true);
+							},
+							"divide_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+		} break;
+		case Variant::VECTOR3I: {
+			JSValue number_left = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_left, "left", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_left);
+
+			JSValue number_right = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_right, "right", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_right);
+
+			// 2 * new godot.Vector3i(2, 3, 4)
+			JS_DefinePropertyValueStr(ctx, number_left, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+								return scale_integer_vector<Vector3i, Vector3>(ctx, *bind->getVector3i(), argv[0], false);
+							},
+							"multiply_number_left", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector3i(2, 3, 4) * 2
+			JS_DefinePropertyValueStr(ctx, number_right, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								return scale_integer_vector<Vector3i, Vector3>(ctx, *bind->getVector3i(), argv[1], false);
+							},
+							"multiply_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector3i(2, 3, 4) / 2
+			JS_DefinePropertyValueStr(ctx, number_right, "/",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								return scale_integer_vector<Vector3i, Vector3>(ctx, *bind->getVector3i(), argv[1], true);
+							},
+							"divide_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+		} break;
+		case Variant::VECTOR4: {
+			JSValue number_left = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_left, "left", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_left);
+
+			JSValue number_right = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_right, "right", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_right);
+
+			// 2 * new godot.Vector4(2, 3, 4, 5)
+			JS_DefinePropertyValueStr(ctx, number_left, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								real_t scalar = QuickJSBinder::js_to_number(ctx, argv[0]);
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+								Vector4 *ptr = bind->getVector4();
+								Vector4 ret = ptr->operator*(scalar);
+								return QuickJSBuiltinBinder::new_object_from(ctx, ret);
+							},
+							"multiply_number_left", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector4(2, 3, 4, 5) * 2
+			JS_DefinePropertyValueStr(ctx, number_right, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								Vector4 *ptr = bind->getVector4();
+								real_t scalar = QuickJSBinder::js_to_number(ctx, argv[1]);
+								Vector4 ret = ptr->operator*(scalar);
+								return QuickJSBuiltinBinder::new_object_from(ctx, ret);
+							},
+							"multiply_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector4(2, 3, 4, 5) / 2
+			JS_DefinePropertyValueStr(ctx, number_right, "/",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								Vector4 *ptr = bind->getVector4();
+								real_t scalar = QuickJSBinder::js_to_number(ctx, argv[1]);
+								Vector4 ret = ptr->operator/(scalar);
+								return QuickJSBuiltinBinder::new_object_from(ctx, ret);
+							},
+							"divide_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+		} break;
+		case Variant::VECTOR4I: {
+			JSValue number_left = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_left, "left", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_left);
+
+			JSValue number_right = JS_NewObject(ctx);
+			JS_DefinePropertyValueStr(ctx, number_right, "right", JS_DupValue(ctx, Number), QuickJSBinder::PROP_DEF_DEFAULT);
+			r_operators.push_back(number_right);
+
+			// 2 * new godot.Vector4i(2, 3, 4, 5)
+			JS_DefinePropertyValueStr(ctx, number_left, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+								return scale_integer_vector<Vector4i, Vector4>(ctx, *bind->getVector4i(), argv[0], false);
+							},
+							"multiply_number_left", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector4i(2, 3, 4, 5) * 2
+			JS_DefinePropertyValueStr(ctx, number_right, "*",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								return scale_integer_vector<Vector4i, Vector4>(ctx, *bind->getVector4i(), argv[1], false);
+							},
+							"multiply_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+
+			// new godot.Vector4i(2, 3, 4, 5) / 2
+			JS_DefinePropertyValueStr(ctx, number_right, "/",
+					JS_NewCFunction(
+							ctx, [](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) -> JSValue {
+								JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+								return scale_integer_vector<Vector4i, Vector4>(ctx, *bind->getVector4i(), argv[1], true);
+							},
+							"divide_number_right", 2),
+					QuickJSBinder::PROP_DEF_DEFAULT);
+		} break;
 		default:
 			break;
 	}
@@ -529,6 +749,30 @@ JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Variant &p_v
 			AABB tmp = p_val;
 			obj = create_builtin_value(ctx, type, &tmp);
 		} break;
+		case Variant::VECTOR2I: {
+			Vector2i tmp = p_val;
+			obj = create_builtin_value(ctx, type, &tmp);
+		} break;
+		case Variant::VECTOR3I: {
+			Vector3i tmp = p_val;
+			obj = create_builtin_value(ctx, type, &tmp);
+		} break;
+		case Variant::VECTOR4: {
+			Vector4 tmp = p_val;
+			obj = create_builtin_value(ctx, type, &tmp);
+		} break;
+		case Variant::VECTOR4I: {
+			Vector4i tmp = p_val;
+			obj = create_builtin_value(ctx, type, &tmp);
+		} break;
+		case Variant::RECT2I: {
+			Rect2i tmp = p_val;
+			obj = create_builtin_value(ctx, type, &tmp);
+		} break;
+		case Variant::PROJECTION: {
+			Projection tmp = p_val;
+			obj = create_builtin_value(ctx, type, &tmp);
+		} break;
 		case Variant::PACKED_INT32_ARRAY: {
 			PackedInt32Array tmp = p_val;
 			obj = create_builtin_value(ctx, type, &tmp);
@@ -607,6 +851,30 @@ JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Basis &p_val
 	return create_builtin_value(ctx, Variant::BASIS, &p_val);
 }
 
+JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Vector2i &p_val) {
+	return create_builtin_value(ctx, Variant::VECTOR2I, &p_val);
+}
+
+JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Vector3i &p_val) {
+	return create_builtin_value(ctx, Variant::VECTOR3I, &p_val);
+}
+
+JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Vector4 &p_val) {
+	return create_builtin_value(ctx, Variant::VECTOR4, &p_val);
+}
+
+JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Vector4i &p_val) {
+	return create_builtin_value(ctx, Variant::VECTOR4I, &p_val);
+}
+
+JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Rect2i &p_val) {
+	return create_builtin_value(ctx, Variant::RECT2I, &p_val);
+}
+
+JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const Projection &p_val) {
+	return create_builtin_value(ctx, Variant::PROJECTION, &p_val);
+}
+
 JSValue QuickJSBuiltinBinder::new_object_from(JSContext *ctx, const PackedInt32Array &p_val) {
 	return create_builtin_value(ctx, Variant::PACKED_INT32_ARRAY, &p_val);
 }
@@ -785,6 +1053,41 @@ void QuickJSBuiltinBinder::bind_builtin_propties_manually() {
 					ERR_FAIL_V(JS_ThrowTypeError(ctx, "Vector2, Rect2 or PackedVector2Array expected for argument #0 of Transform2D.xform_inv"));
 				},
 				1);
+		// Write the transformed vector into the first argument instead of allocating a new one
+		binder->get_builtin_binder().register_method(
+				Variant::TRANSFORM2D,
+				"xform_into",
+				[](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+					ERR_FAIL_COND_V(argc < 2, (JS_ThrowTypeError(ctx, "Two arguments expected for Transform2D.xform_into")));
+					JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, this_val);
+					Transform2D *ptr = bind->getTransform2D();
+#ifdef DEBUG_METHODS_ENABLED
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR2, argv[0]), (JS_ThrowTypeError(ctx, "Vector2 expected for arguments #0 Transform2D.xform_into")));
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR2, argv[1]), (JS_ThrowTypeError(ctx, "Vector2 expected for arguments #1 Transform2D.xform_into")));
+#endif
+					JavaScriptGCHandler *argv0_bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+					JavaScriptGCHandler *argv1_bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+					*argv0_bind->getVector2() = ptr->xform(*argv1_bind->getVector2());
+					return JS_DupValue(ctx, argv[0]);
+				},
+				2);
+		binder->get_builtin_binder().register_method(
+				Variant::TRANSFORM2D,
+				"xform_inv_into",
+				[](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+					ERR_FAIL_COND_V(argc < 2, (JS_ThrowTypeError(ctx, "Two arguments expected for Transform2D.xform_inv_into")));
+					JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, this_val);
+					Transform2D *ptr = bind->getTransform2D();
+#ifdef DEBUG_METHODS_ENABLED
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR2, argv[0]), (JS_ThrowTypeError(ctx, "Vector2 expected for arguments #0 Transform2D.xform_inv_into")));
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR2, argv[1]), (JS_ThrowTypeError(ctx, "Vector2 expected for arguments #1 Transform2D.xform_inv_into")));
+#endif
+					JavaScriptGCHandler *argv0_bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+					JavaScriptGCHandler *argv1_bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+					*argv0_bind->getVector2() = ptr->xform_inv(*argv1_bind->getVector2());
+					return JS_DupValue(ctx, argv[0]);
+				},
+				2);
 	}
 
 	{ // Basis
@@ -940,6 +1243,41 @@ void QuickJSBuiltinBinder::bind_builtin_propties_manually() {
 					ERR_FAIL_V(JS_ThrowTypeError(ctx, "Vector3, Plane, AABB or PackedVector3Array expected for argument #0 of Transform3D.xform_inv"));
 				},
 				1);
+		// Write the transformed vector into the first argument instead of allocating a new one
+		binder->get_builtin_binder().register_method(
+				Variant::TRANSFORM3D,
+				"xform_into",
+				[](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+					ERR_FAIL_COND_V(argc < 2, (JS_ThrowTypeError(ctx, "Two arguments expected for Transform3D.xform_into")));
+					JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, this_val);
+					Transform3D *ptr = bind->getTransform3D();
+#ifdef DEBUG_METHODS_ENABLED
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR3, argv[0]), (JS_ThrowTypeError(ctx, "Vector3 expected for arguments #0 Transform3D.xform_into")));
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR3, argv[1]), (JS_ThrowTypeError(ctx, "Vector3 expected for arguments #1 Transform3D.xform_into")));
+#endif
+					JavaScriptGCHandler *argv0_bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+					JavaScriptGCHandler *argv1_bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+					*argv0_bind->getVector3() = ptr->xform(*argv1_bind->getVector3());
+					return JS_DupValue(ctx, argv[0]);
+				},
+				2);
+		binder->get_builtin_binder().register_method(
+				Variant::TRANSFORM3D,
+				"xform_inv_into",
+				[](JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+					ERR_FAIL_COND_V(argc < 2, (JS_ThrowTypeError(ctx, "Two arguments expected for Transform3D.xform_inv_into")));
+					JavaScriptGCHandler *bind = BINDING_DATA_FROM_JS(ctx, this_val);
+					Transform3D *ptr = bind->getTransform3D();
+#ifdef DEBUG_METHODS_ENABLED
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR3, argv[0]), (JS_ThrowTypeError(ctx, "Vector3 expected for arguments #0 Transform3D.xform_inv_into")));
+					ERR_FAIL_COND_V(!QuickJSBinder::validate_type(ctx, Variant::VECTOR3, argv[1]), (JS_ThrowTypeError(ctx, "Vector3 expected for arguments #1 Transform3D.xform_inv_into")));
+#endif
+					JavaScriptGCHandler *argv0_bind = BINDING_DATA_FROM_JS(ctx, argv[0]);
+					JavaScriptGCHandler *argv1_bind = BINDING_DATA_FROM_JS(ctx, argv[1]);
+					*argv0_bind->getVector3() = ptr->xform_inv(*argv1_bind->getVector3());
+					return JS_DupValue(ctx, argv[0]);
+				},
+				2);
 	}
 
 	{ // PackedByteArray
@@ -34,9 +34,50 @@ public:
 	void register_property(Variant::Type p_type, const char *p_name, JSCFunctionMagic *p_getter, JSCFunctionMagic *p_setter, int magic);
 	void register_operators(Variant::Type p_type, Vector<JSValue> &p_operators);
 	void register_method(Variant::Type p_type, const char *p_name, JSCFunction *p_func, int p_length);
+	void register_static_method(Variant::Type p_type, const char *p_name, JSCFunction *p_func, int p_length);
 	void register_constant(Variant::Type p_type, const char *p_name, const Variant &p_value);
 	void get_cross_type_operators(Variant::Type p_type, Vector<JSValue> &r_operators);
 
+	/* False if dividing the integer vectors traps, on a zero component or INT32_MIN / -1 */
+	template <class V>
+	static bool is_integer_division_defined(const V &p_dividend, const V &p_divisor) {
+		for (int i = 0; i < int(sizeof(V) / sizeof(int32_t)); i++) {
+			if (p_divisor[i] == 0 || (p_divisor[i] == -1 && p_dividend[i] == INT32_MIN)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	template <class V>
+	static bool is_integer_division_defined(const V &p_dividend, int32_t p_divisor) {
+		for (int i = 0; i < int(sizeof(V) / sizeof(int32_t)); i++) {
+			if (p_divisor == 0 || (p_divisor == -1 && p_dividend[i] == INT32_MIN)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	/* Divides an integer vector by a number for the divide methods, which keep the integer vector type.
+	 * Throws and returns false if the number is not an int32 or the division is not defined. */
+	template <class V>
+	static bool divide_integer_vector(JSContext *ctx, V &r_quotient, const V &p_dividend, JSValueConst p_divisor) {
+		double divisor = 0;
+		if (JS_ToFloat64(ctx, &divisor, p_divisor)) {
+			return false;
+		}
+		if (!(divisor >= INT32_MIN && divisor <= INT32_MAX && divisor == double(int32_t(divisor)))) {
+			JS_ThrowTypeError(ctx, "Integer expected to divide an integer vector");
+			return false;
+		}
+		const int32_t integer = int32_t(divisor);
+		if (!is_integer_division_defined(p_dividend, integer)) {
+			JS_ThrowRangeError(ctx, integer == 0 ? "Integer division by zero" : "Integer division overflow");
+			return false;
+		}
+		r_quotient = p_dividend / integer;
+		return true;
+	}
+
 public:
 	QuickJSBuiltinBinder();
 	~QuickJSBuiltinBinder();
@@ -65,6 +106,12 @@ public:
 	static JSValue new_object_from(JSContext *ctx, const RID &p_val);
 	static JSValue new_object_from(JSContext *ctx, const AABB &p_val);
 	static JSValue new_object_from(JSContext *ctx, const Basis &p_val);
+	static JSValue new_object_from(JSContext *ctx, const Vector2i &p_val);
+	static JSValue new_object_from(JSContext *ctx, const Vector3i &p_val);
+	static JSValue new_object_from(JSContext *ctx, const Vector4 &p_val);
+	static JSValue new_object_from(JSContext *ctx, const Vector4i &p_val);
+	static JSValue new_object_from(JSContext *ctx, const Rect2i &p_val);
+	static JSValue new_object_from(JSContext *ctx, const Projection &p_val);
 	static JSValue new_object_from(JSContext *ctx, const PackedInt32Array &p_val);
 	static JSValue new_object_from(JSContext *ctx, const PackedByteArray &p_val);
 	static JSValue new_object_from(JSContext *ctx, const PackedFloat32Array &p_val);
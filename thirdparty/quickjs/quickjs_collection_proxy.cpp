@@ -0,0 +1,329 @@
+#include "quickjs_collection_proxy.h"
+
+#include "quickjs_binder.h"
+
+JSClassExoticMethods QuickJSCollectionProxy::array_exotic = {
+	array_get_own_property,
+	array_get_own_property_names,
+	array_delete_property,
+	array_define_own_property,
+	NULL,
+	NULL,
+	NULL,
+};
+
+JSClassExoticMethods QuickJSCollectionProxy::dictionary_exotic = {
+	dictionary_get_own_property,
+	dictionary_get_own_property_names,
+	dictionary_delete_property,
+	dictionary_define_own_property,
+	NULL,
+	NULL,
+	NULL,
+};
+
+static int reject_property(JSContext *ctx, int flags, const char *p_message) {
+	if (flags & (JS_PROP_THROW | JS_PROP_THROW_STRICT)) {
+		JS_ThrowTypeError(ctx, "%s", p_message);
+		return -1;
+	}
+	return FALSE;
+}
+
+static void set_descriptor(JSPropertyDescriptor *desc, JSValue p_value, int p_flags) {
+	desc->flags = p_flags;
+	desc->value = p_value;
+	desc->getter = JS_UNDEFINED;
+	desc->setter = JS_UNDEFINED;
+}
+
+JSValue QuickJSCollectionProxy::array_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	return new_array(ctx, Array());
+}
+
+JSValue QuickJSCollectionProxy::dictionary_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	return new_dictionary(ctx, Dictionary());
+}
+
+void QuickJSCollectionProxy::proxy_finalizer(JSRuntime *rt, JSValue val) {
+	QuickJSBinder *binder = QuickJSBinder::get_runtime_binder(rt);
+	Variant *collection = static_cast<Variant *>(JS_GetOpaque(val, binder->array_proxy_class_data.class_id));
+	if (collection == NULL) {
+		collection = static_cast<Variant *>(JS_GetOpaque(val, binder->dictionary_proxy_class_data.class_id));
+	}
+	if (collection) {
+		memdelete(collection);
+	}
+}
+
+int QuickJSCollectionProxy::array_get_own_property(JSContext *ctx, JSPropertyDescriptor *desc, JSValueConst obj, JSAtom prop) {
+	const Variant *collection = get_collection(ctx, obj);
+	ERR_FAIL_NULL_V(collection, FALSE);
+	const Array array = *collection;
+	if (prop == JS_ATOM_length) {
+		if (desc) {
+			set_descriptor(desc, JS_NewInt32(ctx, array.size()), JS_PROP_WRITABLE);
+		}
+		return TRUE;
+	}
+	uint32_t index = 0;
+	if (!JS_AtomIsArrayIndex(ctx, &index, prop) || index >= uint32_t(array.size())) {
+		return FALSE;
+	}
+	if (desc) {
+		set_descriptor(desc, QuickJSBinder::variant_to_var(ctx, array[index]), JS_PROP_WRITABLE | JS_PROP_ENUMERABLE);
+	}
+	return TRUE;
+}
+
+int QuickJSCollectionProxy::array_get_own_property_names(JSContext *ctx, JSPropertyEnum **ptab, uint32_t *plen, JSValueConst obj) {
+	const Variant *collection = get_collection(ctx, obj);
+	ERR_FAIL_NULL_V(collection, -1);
+	const Array array = *collection;
+	const uint32_t size = array.size();
+	JSPropertyEnum *tab = static_cast<JSPropertyEnum *>(js_malloc(ctx, sizeof(JSPropertyEnum) * (size + 1)));
+	if (tab == NULL) {
+		return -1;
+	}
+	for (uint32_t i = 0; i < size; i++) {
+		tab[i].is_enumerable = TRUE;
+		tab[i].atom = JS_NewAtomUInt32(ctx, i);
+	}
+	tab[size].is_enumerable = FALSE;
+	tab[size].atom = JS_DupAtom(ctx, JS_ATOM_length);
+	*ptab = tab;
+	*plen = size + 1;
+	return 0;
+}
+
+int QuickJSCollectionProxy::array_delete_property(JSContext *ctx, JSValueConst obj, JSAtom prop) {
+	const Variant *collection = get_collection(ctx, obj);
+	ERR_FAIL_NULL_V(collection, FALSE);
+	Array array = *collection;
+	uint32_t index = 0;
+	if (!JS_AtomIsArrayIndex(ctx, &index, prop) || index >= uint32_t(array.size())) {
+		return prop == JS_ATOM_length ? FALSE : TRUE;
+	}
+	// The elements cannot be left as holes, only the last one is removed, as pop(), shift() and splice() do
+	if (index + 1 != uint32_t(array.size()) || array.is_read_only()) {
+		return FALSE;
+	}
+	array.resize(index);
+	return TRUE;
+}
+
+int QuickJSCollectionProxy::array_define_own_property(JSContext *ctx, JSValueConst this_obj, JSAtom prop, JSValueConst val, JSValueConst getter, JSValueConst setter, int flags) {
+	const Variant *collection = get_collection(ctx, this_obj);
+	ERR_FAIL_NULL_V(collection, FALSE);
+	Array array = *collection;
+	if (!JS_IsUndefined(getter) || !JS_IsUndefined(setter)) {
+		return reject_property(ctx, flags, "accessors cannot be defined on an ArrayProxy");
+	}
+	if (array.is_read_only()) {
+		return reject_property(ctx, flags, "the array is read-only");
+	}
+	if (prop == JS_ATOM_length) {
+		if (flags & JS_PROP_HAS_VALUE) {
+			uint32_t length = 0;
+			if (JS_ToUint32(ctx, &length, val)) {
+				return -1;
+			}
+			// The new elements are nulls
+			if (length > uint32_t(array.size()) && length > ARRAY_PROXY_MAX_LENGTH) {
+				JS_ThrowRangeError(ctx, "the length of an ArrayProxy cannot exceed %d", ARRAY_PROXY_MAX_LENGTH);
+				return -1;
+			}
+			array.resize(length);
+		}
+		return TRUE;
+	}
+	uint32_t index = 0;
+	if (!JS_AtomIsArrayIndex(ctx, &index, prop)) {
+		return reject_property(ctx, flags, "only indices can be defined on an ArrayProxy");
+	}
+	if (flags & JS_PROP_HAS_VALUE) {
+		// Setting an index past the end fills the elements before it with nulls, as splice() does when it inserts
+		if (index >= uint32_t(array.size())) {
+			if (index >= ARRAY_PROXY_MAX_LENGTH) {
+				JS_ThrowRangeError(ctx, "index %u is out of the bounds of an ArrayProxy, its length cannot exceed %d", index, ARRAY_PROXY_MAX_LENGTH);
+				return -1;
+			}
+			array.resize(index + 1);
+		}
+		array.set(index, QuickJSBinder::var_to_variant(ctx, val));
+	}
+	return TRUE;
+}
+
+Variant QuickJSCollectionProxy::find_dictionary_key(JSContext *ctx, const Dictionary &p_dictionary, JSAtom prop, bool *r_found) {
+	*r_found = false;
+	JSValue name = JS_AtomToValue(ctx, prop);
+	if (!JS_IsString(name)) { // Symbols are not keys of the dictionary
+		JS_FreeValue(ctx, name);
+		return Variant();
+	}
+	Variant key = QuickJSBinder::js_to_string(ctx, name);
+	JS_FreeValue(ctx, name);
+	if (p_dictionary.has(key)) {
+		*r_found = true;
+		return key;
+	}
+	uint32_t index = 0;
+	if (JS_AtomIsArrayIndex(ctx, &index, prop)) {
+		Variant index_key = int64_t(index);
+		if (p_dictionary.has(index_key)) {
+			*r_found = true;
+			return index_key;
+		}
+	}
+	return key;
+}
+
+int QuickJSCollectionProxy::dictionary_get_own_property(JSContext *ctx, JSPropertyDescriptor *desc, JSValueConst obj, JSAtom prop) {
+	const Variant *collection = get_collection(ctx, obj);
+	ERR_FAIL_NULL_V(collection, FALSE);
+	const Dictionary dictionary = *collection;
+	bool found = false;
+	Variant key = find_dictionary_key(ctx, dictionary, prop, &found);
+	if (!found) {
+		return FALSE;
+	}
+	if (desc) {
+		set_descriptor(desc, QuickJSBinder::variant_to_var(ctx, dictionary[key]), JS_PROP_C_W_E);
+	}
+	return TRUE;
+}
+
+int QuickJSCollectionProxy::dictionary_get_own_property_names(JSContext *ctx, JSPropertyEnum **ptab, uint32_t *plen, JSValueConst obj) {
+	const Variant *collection = get_collection(ctx, obj);
+	ERR_FAIL_NULL_V(collection, -1);
+	const Dictionary dictionary = *collection;
+	const Array keys = dictionary.keys();
+	JSPropertyEnum *tab = static_cast<JSPropertyEnum *>(js_malloc(ctx, sizeof(JSPropertyEnum) * MAX(uint32_t(keys.size()), 1u)));
+	if (tab == NULL) {
+		return -1;
+	}
+	// Only the keys find_dictionary_key() resolves are listed: strings, and the integers used as indices
+	// unless the dictionary has the same index as a string too
+	uint32_t count = 0;
+	for (int i = 0; i < keys.size(); i++) {
+		const Variant &key = keys[i];
+		if (key.get_type() == Variant::STRING) {
+			CharString name = String(key).utf8();
+			tab[count].atom = JS_NewAtomLen(ctx, name.get_data(), name.length());
+		} else if (key.get_type() == Variant::INT) {
+			const int64_t index = key;
+			if (index < 0 || index > int64_t(UINT32_MAX - 1) || dictionary.has(itos(index))) {
+				continue;
+			}
+			tab[count].atom = JS_NewAtomUInt32(ctx, uint32_t(index));
+		} else {
+			continue;
+		}
+		tab[count].is_enumerable = TRUE;
+		count++;
+	}
+	*ptab = tab;
+	*plen = count;
+	return 0;
+}
+
+int QuickJSCollectionProxy::dictionary_delete_property(JSContext *ctx, JSValueConst obj, JSAtom prop) {
+	const Variant *collection = get_collection(ctx, obj);
+	ERR_FAIL_NULL_V(collection, FALSE);
+	Dictionary dictionary = *collection;
+	bool found = false;
+	Variant key = find_dictionary_key(ctx, dictionary, prop, &found);
+	if (found) {
+		if (dictionary.is_read_only()) {
+			return FALSE;
+		}
+		dictionary.erase(key);
+	}
+	return TRUE;
+}
+
+int QuickJSCollectionProxy::dictionary_define_own_property(JSContext *ctx, JSValueConst this_obj, JSAtom prop, JSValueConst val, JSValueConst getter, JSValueConst setter, int flags) {
+	const Variant *collection = get_collection(ctx, this_obj);
+	ERR_FAIL_NULL_V(collection, FALSE);
+	Dictionary dictionary = *collection;
+	if (!JS_IsUndefined(getter) || !JS_IsUndefined(setter)) {
+		return reject_property(ctx, flags, "accessors cannot be defined on a DictionaryProxy");
+	}
+	if (dictionary.is_read_only()) {
+		return reject_property(ctx, flags, "the dictionary is read-only");
+	}
+	bool found = false;
+	Variant key = find_dictionary_key(ctx, dictionary, prop, &found);
+	if (!found && key.get_type() == Variant::NIL) {
+		return reject_property(ctx, flags, "symbols cannot be keys of a DictionaryProxy");
+	}
+	if (flags & JS_PROP_HAS_VALUE) {
+		dictionary[key] = QuickJSBinder::var_to_variant(ctx, val);
+	}
+	return TRUE;
+}
+
+void QuickJSCollectionProxy::add_class(QuickJSBinder *p_binder, bool p_is_array) {
+	JSContext *ctx = p_binder->ctx;
+	QuickJSBinder::ClassBindData &data = p_is_array ? p_binder->array_proxy_class_data : p_binder->dictionary_proxy_class_data;
+	data.gdclass = NULL;
+	data.class_id = 0;
+	data.base_class = NULL;
+	data.class_name = p_is_array ? "ArrayProxy" : "DictionaryProxy";
+	data.jsclass.class_name = data.class_name.get_data();
+	data.jsclass.finalizer = proxy_finalizer;
+	data.jsclass.exotic = p_is_array ? &array_exotic : &dictionary_exotic;
+	data.jsclass.gc_mark = NULL;
+	data.jsclass.call = NULL;
+	if (p_is_array) {
+		// The methods of Array.prototype only use the length and the indices, so they work on the proxies as well
+		JSValue array_class = JS_GetPropertyStr(ctx, p_binder->global_object, "Array");
+		JSValue array_prototype = JS_GetProperty(ctx, array_class, JS_ATOM_prototype);
+		data.prototype = JS_NewObjectProto(ctx, array_prototype);
+		JS_FreeValue(ctx, array_prototype);
+		JS_FreeValue(ctx, array_class);
+	} else {
+		data.prototype = JS_NewObject(ctx);
+	}
+	data.constructor = JS_NewCFunction2(ctx, p_is_array ? array_constructor : dictionary_constructor, data.jsclass.class_name, 0, JS_CFUNC_constructor, 0);
+
+	JS_NewClassID(&data.class_id);
+	JS_NewClass(JS_GetRuntime(ctx), data.class_id, &data.jsclass);
+	JS_SetClassProto(ctx, data.class_id, data.prototype);
+	JS_SetConstructor(ctx, data.constructor, data.prototype);
+	JS_DefinePropertyValueStr(ctx, p_binder->godot_object, data.jsclass.class_name, data.constructor, QuickJSBinder::PROP_DEF_DEFAULT);
+}
+
+void QuickJSCollectionProxy::add_proxy_classes(QuickJSBinder *p_binder) {
+	add_class(p_binder, true);
+	add_class(p_binder, false);
+}
+
+JSValue QuickJSCollectionProxy::new_array(JSContext *ctx, const Array &p_array) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	JSValue obj = JS_NewObjectClass(ctx, binder->array_proxy_class_data.class_id);
+	if (JS_IsException(obj)) {
+		return obj;
+	}
+	JS_SetOpaque(obj, memnew(Variant(p_array)));
+	return obj;
+}
+
+JSValue QuickJSCollectionProxy::new_dictionary(JSContext *ctx, const Dictionary &p_dictionary) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	JSValue obj = JS_NewObjectClass(ctx, binder->dictionary_proxy_class_data.class_id);
+	if (JS_IsException(obj)) {
+		return obj;
+	}
+	JS_SetOpaque(obj, memnew(Variant(p_dictionary)));
+	return obj;
+}
+
+const Variant *QuickJSCollectionProxy::get_collection(JSContext *ctx, JSValueConst p_value) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	if (const Variant *collection = static_cast<const Variant *>(JS_GetOpaque(p_value, binder->array_proxy_class_data.class_id))) {
+		return collection;
+	}
+	return static_cast<const Variant *>(JS_GetOpaque(p_value, binder->dictionary_proxy_class_data.class_id));
+}
@@ -0,0 +1,50 @@
+#ifndef QUICKJS_COLLECTION_PROXY_H
+#define QUICKJS_COLLECTION_PROXY_H
+
+#include "core/variant/array.h"
+#include "core/variant/dictionary.h"
+#include "core/variant/variant.h"
+
+#include "quickjs/quickjs.h"
+
+// Setting the length or an index of an ArrayProxy past its end fills it with nulls, up to this many elements
+#define ARRAY_PROXY_MAX_LENGTH (1 << 24)
+
+class QuickJSBinder;
+
+/*
+ * The JavaScript handles of an engine Array or Dictionary, `godot.ArrayProxy` and `godot.DictionaryProxy`.
+ * They share the collection instead of copying it, elements are converted when they are read and
+ * written back to the collection when they are set. A proxy passed to the engine is its collection.
+ */
+class QuickJSCollectionProxy {
+	static JSClassExoticMethods array_exotic;
+	static JSClassExoticMethods dictionary_exotic;
+
+	static JSValue array_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+	static JSValue dictionary_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+	static void proxy_finalizer(JSRuntime *rt, JSValue val);
+
+	static int array_get_own_property(JSContext *ctx, JSPropertyDescriptor *desc, JSValueConst obj, JSAtom prop);
+	static int array_get_own_property_names(JSContext *ctx, JSPropertyEnum **ptab, uint32_t *plen, JSValueConst obj);
+	static int array_delete_property(JSContext *ctx, JSValueConst obj, JSAtom prop);
+	static int array_define_own_property(JSContext *ctx, JSValueConst this_obj, JSAtom prop, JSValueConst val, JSValueConst getter, JSValueConst setter, int flags);
+
+	static int dictionary_get_own_property(JSContext *ctx, JSPropertyDescriptor *desc, JSValueConst obj, JSAtom prop);
+	static int dictionary_get_own_property_names(JSContext *ctx, JSPropertyEnum **ptab, uint32_t *plen, JSValueConst obj);
+	static int dictionary_delete_property(JSContext *ctx, JSValueConst obj, JSAtom prop);
+	static int dictionary_define_own_property(JSContext *ctx, JSValueConst this_obj, JSAtom prop, JSValueConst val, JSValueConst getter, JSValueConst setter, int flags);
+
+	/* The key of `p_dictionary` named by `prop`, a string key or else an integer key for an index */
+	static Variant find_dictionary_key(JSContext *ctx, const Dictionary &p_dictionary, JSAtom prop, bool *r_found);
+	static void add_class(QuickJSBinder *p_binder, bool p_is_array);
+
+public:
+	static void add_proxy_classes(QuickJSBinder *p_binder);
+	static JSValue new_array(JSContext *ctx, const Array &p_array);
+	static JSValue new_dictionary(JSContext *ctx, const Dictionary &p_dictionary);
+	/* Returns the Array or Dictionary shared by a proxy, or NULL if `p_value` is not a collection proxy */
+	static const Variant *get_collection(JSContext *ctx, JSValueConst p_value);
+};
+
+#endif // QUICKJS_COLLECTION_PROXY_H
@@ -1,4 +1,5 @@
 #include "quickjs_debugger.h"
+#include "core/os/os.h"
 #include <stddef.h>
 
 #define QJS_DEBUGGER_DEBUG_LOG 0
@@ -64,6 +65,10 @@ void QuickJSDebugger::transport_close(JSRuntime *rt, void *udata) {
 	ERR_FAIL_COND(debugger == NULL || debugger->peer.is_null());
 	debugger->peer->disconnect_from_host();
 	debugger->peer = Ref<StreamPeerTCP>();
+	if (debugger->request_buffer) {
+		memfree(debugger->request_buffer);
+		debugger->request_buffer = NULL;
+	}
 #if QJS_DEBUGGER_DEBUG_LOG
 	print_line(vformat("[transport_close]"));
 #endif
@@ -73,6 +78,9 @@ Error QuickJSDebugger::attach_js_debugger(JSContext *ctx, Ref<StreamPeerTCP> p_p
 	ERR_FAIL_NULL_V(ctx, ERR_CANT_CONNECT);
 	if (p_peer.is_valid() && p_peer->get_status() == StreamPeerTCP::STATUS_CONNECTED) {
 		this->peer = p_peer;
+		if (request_buffer == NULL) {
+			request_buffer = (uint8_t *)memalloc(QJS_DEBUGGER_MAX_BUFFER_SIZE);
+		}
 		js_debugger_attach(ctx, transport_read, transport_write, transport_peek, transport_close, this);
 		return OK;
 	}
@@ -87,8 +95,17 @@ Error QuickJSDebugger::connect_debugger(JSContext *ctx, const String &address) {
 	Ref<StreamPeerTCP> peer = memnew(StreamPeerTCP);
 	Error err = peer->connect_to_host(c.address, c.port);
 	if (OK == err) {
-		while (peer->get_status() == StreamPeerTCP::STATUS_CONNECTING)
-			; // wait until connected to the debugger
+		// The status of the peer only changes when it is polled
+		const uint64_t deadline = OS::get_singleton()->get_ticks_msec() + QJS_DEBUGGER_CONNECT_TIMEOUT_MSEC;
+		peer->poll();
+		while (peer->get_status() == StreamPeerTCP::STATUS_CONNECTING) {
+			if (OS::get_singleton()->get_ticks_msec() >= deadline) {
+				peer->disconnect_from_host();
+				return ERR_CANT_CONNECT;
+			}
+			OS::get_singleton()->delay_usec(1000);
+			peer->poll();
+		}
 		return attach_js_debugger(ctx, peer);
 	}
 	return err;
@@ -112,10 +129,14 @@ void QuickJSDebugger::poll() {
 			attach_js_debugger(ctx, server->take_connection());
 		}
 	}
-	if (peer.is_valid() && server.is_valid() && server->is_listening()) {
+	if (peer.is_valid()) {
+		peer->poll();
 		if (peer->get_status() == StreamPeerTCP::STATUS_NONE || peer->get_status() == StreamPeerTCP::STATUS_ERROR) {
 			JSDebuggerInfo *info = js_debugger_info(runtime);
 			js_debugger_free(runtime, info);
+		} else {
+			// Messages are only read here, the interpreter does not look at the connection while scripts run
+			js_debugger_poll(ctx);
 		}
 	}
 }
@@ -123,10 +144,14 @@ void QuickJSDebugger::poll() {
 QuickJSDebugger::QuickJSDebugger() {
 	ctx = NULL;
 	runtime = NULL;
+	request_buffer = NULL;
 }
 
 QuickJSDebugger::~QuickJSDebugger() {
 	if (server.is_valid() && server->is_listening()) {
 		server->stop();
 	}
+	if (request_buffer) {
+		memfree(request_buffer);
+	}
 }
@@ -8,6 +8,7 @@
 #include "core/object/ref_counted.h"
 #include "quickjs/quickjs-debugger.h"
 #define QJS_DEBUGGER_MAX_BUFFER_SIZE 4194304
+#define QJS_DEBUGGER_CONNECT_TIMEOUT_MSEC 10000
 
 class QuickJSDebugger : public RefCounted {
 	GDCLASS(QuickJSDebugger, RefCounted)
@@ -16,7 +17,8 @@ class QuickJSDebugger : public RefCounted {
 	Ref<TCPServer> server;
 	JSRuntime *runtime;
 	JSContext *ctx;
-	uint8_t request_buffer[QJS_DEBUGGER_MAX_BUFFER_SIZE];
+	// Only allocated once a client is attached
+	uint8_t *request_buffer;
 
 	struct ConnectionConfig {
 		IPAddress address;
@@ -0,0 +1,49 @@
+#ifndef QUICKJS_MESSAGE_QUEUE_H
+#define QUICKJS_MESSAGE_QUEUE_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+/*
+ * Bounded single-producer/single-consumer ring buffer used to pass messages between two threads without locking.
+ * `push` must only be called by the producer thread and `pop_batch` only by the consumer thread.
+ */
+template <class T, uint32_t CAPACITY>
+class QuickJSMessageQueue {
+	static_assert(CAPACITY && (CAPACITY & (CAPACITY - 1)) == 0, "QuickJSMessageQueue capacity must be a power of 2");
+
+	T items[CAPACITY];
+	// Only written by the consumer
+	SafeNumeric<uint32_t> head;
+	// Only written by the producer
+	SafeNumeric<uint32_t> tail;
+
+public:
+	/* Returns false if the queue is full */
+	bool push(const T &p_item) {
+		const uint32_t pos = tail.get();
+		if (pos - head.get() >= CAPACITY) {
+			return false;
+		}
+		items[pos & (CAPACITY - 1)] = p_item;
+		tail.set(pos + 1);
+		return true;
+	}
+
+	/* Moves all the items available at the time of the call to the end of `r_items`, returns the count of items moved */
+	uint32_t pop_batch(LocalVector<T> &r_items) {
+		const uint32_t from = head.get();
+		const uint32_t to = tail.get();
+		for (uint32_t i = from; i != to; i++) {
+			T &item = items[i & (CAPACITY - 1)];
+			r_items.push_back(item);
+			item = T();
+		}
+		head.set(to);
+		return to - from;
+	}
+
+	_FORCE_INLINE_ bool is_empty() const { return head.get() == tail.get(); }
+};
+
+#endif // QUICKJS_MESSAGE_QUEUE_H
@@ -0,0 +1,270 @@
+#include "quickjs_object_proxy.h"
+#include "core/object/object.h"
+
+#include "quickjs_binder.h"
+
+HashMap<uint32_t, QuickJSBinder *> QuickJSObjectProxy::contexts;
+HashMap<const void *, uint32_t> QuickJSObjectProxy::context_ids;
+Mutex QuickJSObjectProxy::contexts_mutex;
+
+JSValue QuickJSObjectProxy::proxy_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	return JS_ThrowTypeError(ctx, "ObjectProxy cannot be constructed, it is created when an object of another context is passed to this context");
+}
+
+void QuickJSObjectProxy::proxy_finalizer(JSRuntime *rt, JSValue val) {
+	QuickJSBinder *binder = QuickJSBinder::get_runtime_binder(rt);
+	if (QuickJSObjectProxy *proxy = static_cast<QuickJSObjectProxy *>(JS_GetOpaque(val, binder->object_proxy_class_data.class_id))) {
+		memdelete(proxy);
+	}
+}
+
+JSValue QuickJSObjectProxy::proxy_instance_id(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	QuickJSObjectProxy *proxy = static_cast<QuickJSObjectProxy *>(JS_GetOpaque(this_val, binder->object_proxy_class_data.class_id));
+	ERR_FAIL_NULL_V(proxy, JS_ThrowTypeError(ctx, "ObjectProxy expected"));
+	return JS_NewInt64(ctx, int64_t(uint64_t(proxy->object)));
+}
+
+JSValue QuickJSObjectProxy::proxy_command(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv, int magic) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	QuickJSObjectProxy *proxy = static_cast<QuickJSObjectProxy *>(JS_GetOpaque(this_val, binder->object_proxy_class_data.class_id));
+	ERR_FAIL_NULL_V(proxy, JS_ThrowTypeError(ctx, "ObjectProxy expected"));
+	ERR_FAIL_COND_V(argc < 1 || !JS_IsString(argv[0]), JS_ThrowTypeError(ctx, "method or property name expected for argument #0"));
+	ERR_FAIL_COND_V(magic == QuickJSProxyCommand::TYPE_SET && argc < 2, JS_ThrowTypeError(ctx, "value expected for argument #1"));
+
+	QuickJSProxyCommand command;
+	command.type = QuickJSProxyCommand::Type(magic);
+	command.object = proxy->object;
+	command.name = QuickJSBinder::js_to_string(ctx, argv[0]);
+	if (magic != QuickJSProxyCommand::TYPE_GET) {
+		command.arguments.resize(argc - 1);
+		for (int i = 1; i < argc; i++) {
+			command.arguments.write[i - 1] = QuickJSBinder::var_to_variant(ctx, argv[i]);
+		}
+	}
+	command.requester = binder->context_id;
+	command.request = ++binder->last_proxy_request;
+
+	QuickJSProxyRequest request;
+	JSValue promise = JS_NewPromiseCapability(ctx, request.resolving_funcs);
+	if (JS_IsException(promise)) {
+		return promise;
+	}
+
+	bool sent = false;
+	{
+		MutexLock lock(contexts_mutex);
+		if (QuickJSBinder **owner = contexts.getptr(proxy->owner)) {
+			{
+				MutexLock owner_lock((*owner)->proxy_mutex);
+				(*owner)->proxy_commands.push_back(command);
+			}
+			(*owner)->wake_up();
+			sent = true;
+		}
+	}
+
+	if (sent) {
+		binder->proxy_requests.insert(command.request, request);
+	} else {
+		QuickJSProxyReply reply;
+		reply.error = "the context that owns the object has been destroyed";
+		settle_request(ctx, request, reply);
+	}
+	return promise;
+}
+
+QuickJSProxyReply QuickJSObjectProxy::run_command(const QuickJSProxyCommand &p_command) {
+	QuickJSProxyReply reply;
+	reply.request = p_command.request;
+
+	Object *obj = ObjectDB::get_instance(p_command.object);
+	if (obj == NULL) {
+		reply.error = "the object has been freed";
+		return reply;
+	}
+
+	switch (p_command.type) {
+		case QuickJSProxyCommand::TYPE_CALL: {
+			const int argc = p_command.arguments.size();
+			LocalVector<const Variant *> argv;
+			argv.resize(argc);
+			for (int i = 0; i < argc; i++) {
+				argv[i] = &p_command.arguments[i];
+			}
+			Callable::CallError err;
+			reply.value = obj->callp(p_command.name, argv.ptr(), argc, err);
+			if (err.error != Callable::CallError::CALL_OK) {
+				reply.error = Variant::get_call_error_text(obj, p_command.name, argv.ptr(), argc, err);
+				reply.value = Variant();
+			}
+		} break;
+		case QuickJSProxyCommand::TYPE_GET: {
+			bool valid = false;
+			reply.value = obj->get(p_command.name, &valid);
+			if (!valid) {
+				reply.error = vformat("invalid property '%s' of %s", p_command.name, obj->get_class_name());
+			}
+		} break;
+		case QuickJSProxyCommand::TYPE_SET: {
+			bool valid = false;
+			obj->set(p_command.name, p_command.arguments[0], &valid);
+			if (!valid) {
+				reply.error = vformat("invalid property '%s' of %s", p_command.name, obj->get_class_name());
+			}
+		} break;
+	}
+	return reply;
+}
+
+void QuickJSObjectProxy::send_reply(uint32_t p_requester, const QuickJSProxyReply &p_reply) {
+	MutexLock lock(contexts_mutex);
+	if (QuickJSBinder **requester = contexts.getptr(p_requester)) {
+		{
+			MutexLock requester_lock((*requester)->proxy_mutex);
+			(*requester)->proxy_replies.push_back(p_reply);
+		}
+		(*requester)->wake_up();
+	}
+}
+
+void QuickJSObjectProxy::settle_request(JSContext *ctx, const QuickJSProxyRequest &p_request, const QuickJSProxyReply &p_reply) {
+	JSValue value;
+	if (p_reply.error.is_empty()) {
+		value = QuickJSBinder::variant_to_var(ctx, p_reply.value);
+	} else {
+		value = JS_NewError(ctx);
+		JS_DefinePropertyValueStr(ctx, value, "message", QuickJSBinder::to_js_string(ctx, p_reply.error), JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+	}
+	JSValue ret = JS_Call(ctx, p_request.resolving_funcs[p_reply.error.is_empty() ? 0 : 1], JS_UNDEFINED, 1, &value);
+	JS_FreeValue(ctx, ret);
+	JS_FreeValue(ctx, value);
+	JS_FreeValue(ctx, p_request.resolving_funcs[0]);
+	JS_FreeValue(ctx, p_request.resolving_funcs[1]);
+}
+
+void QuickJSObjectProxy::add_proxy_class(QuickJSBinder *p_binder) {
+	JSContext *ctx = p_binder->ctx;
+	QuickJSBinder::ClassBindData &data = p_binder->object_proxy_class_data;
+	data.gdclass = NULL;
+	data.class_id = 0;
+	data.base_class = NULL;
+	data.class_name = "ObjectProxy";
+	data.jsclass.class_name = "ObjectProxy";
+	data.jsclass.finalizer = proxy_finalizer;
+	data.jsclass.exotic = NULL;
+	data.jsclass.gc_mark = NULL;
+	data.jsclass.call = NULL;
+	data.prototype = JS_NewObject(ctx);
+	data.constructor = JS_NewCFunction2(ctx, proxy_constructor, data.jsclass.class_name, 0, JS_CFUNC_constructor, 0);
+
+	// ObjectProxy.prototype.call
+	JSValue call_func = JS_NewCFunctionMagic(ctx, proxy_command, "call", 1, JS_CFUNC_generic_magic, QuickJSProxyCommand::TYPE_CALL);
+	JS_DefinePropertyValueStr(ctx, data.prototype, "call", call_func, QuickJSBinder::PROP_DEF_DEFAULT);
+	// ObjectProxy.prototype.get
+	JSValue get_func = JS_NewCFunctionMagic(ctx, proxy_command, "get", 1, JS_CFUNC_generic_magic, QuickJSProxyCommand::TYPE_GET);
+	JS_DefinePropertyValueStr(ctx, data.prototype, "get", get_func, QuickJSBinder::PROP_DEF_DEFAULT);
+	// ObjectProxy.prototype.set
+	JSValue set_func = JS_NewCFunctionMagic(ctx, proxy_command, "set", 2, JS_CFUNC_generic_magic, QuickJSProxyCommand::TYPE_SET);
+	JS_DefinePropertyValueStr(ctx, data.prototype, "set", set_func, QuickJSBinder::PROP_DEF_DEFAULT);
+	// ObjectProxy.prototype.get_instance_id
+	JSValue instance_id_func = JS_NewCFunction(ctx, proxy_instance_id, "get_instance_id", 0);
+	JS_DefinePropertyValueStr(ctx, data.prototype, "get_instance_id", instance_id_func, QuickJSBinder::PROP_DEF_DEFAULT);
+
+	JS_NewClassID(&data.class_id);
+	JS_NewClass(JS_GetRuntime(ctx), data.class_id, &data.jsclass);
+	JS_SetClassProto(ctx, data.class_id, data.prototype);
+	JS_SetConstructor(ctx, data.constructor, data.prototype);
+	JS_DefinePropertyValueStr(ctx, p_binder->godot_object, "ObjectProxy", data.constructor, QuickJSBinder::PROP_DEF_DEFAULT);
+}
+
+JSValue QuickJSObjectProxy::new_proxy(JSContext *ctx, Object *p_object, const void *p_owner_context) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	// 0 is never a context id, commands to an owner that is gone are rejected
+	uint32_t owner = 0;
+	{
+		MutexLock lock(contexts_mutex);
+		if (const uint32_t *id = context_ids.getptr(p_owner_context)) {
+			owner = *id;
+		}
+	}
+	JSValue obj = JS_NewObjectClass(ctx, binder->object_proxy_class_data.class_id);
+	if (JS_IsException(obj)) {
+		return obj;
+	}
+	QuickJSObjectProxy *proxy = memnew(QuickJSObjectProxy);
+	proxy->object = p_object->get_instance_id();
+	proxy->owner = owner;
+	JS_SetOpaque(obj, proxy);
+	return obj;
+}
+
+Object *QuickJSObjectProxy::get_proxy_object(JSContext *ctx, JSValueConst p_value) {
+	QuickJSBinder *binder = QuickJSBinder::get_context_binder(ctx);
+	if (QuickJSObjectProxy *proxy = static_cast<QuickJSObjectProxy *>(JS_GetOpaque(p_value, binder->object_proxy_class_data.class_id))) {
+		return ObjectDB::get_instance(proxy->object);
+	}
+	return NULL;
+}
+
+void QuickJSObjectProxy::register_context(QuickJSBinder *p_binder) {
+	MutexLock lock(contexts_mutex);
+	contexts.insert(p_binder->context_id, p_binder);
+	context_ids.insert(p_binder->ctx, p_binder->context_id);
+}
+
+void QuickJSObjectProxy::unregister_context(QuickJSBinder *p_binder) {
+	{
+		MutexLock lock(contexts_mutex);
+		contexts.erase(p_binder->context_id);
+		context_ids.erase(p_binder->ctx);
+	}
+
+	// Nothing can be pushed to the context anymore
+	LocalVector<QuickJSProxyCommand> commands;
+	{
+		MutexLock lock(p_binder->proxy_mutex);
+		commands = p_binder->proxy_commands;
+		p_binder->proxy_commands.clear();
+		p_binder->proxy_replies.clear();
+	}
+	for (uint32_t i = 0; i < commands.size(); i++) {
+		QuickJSProxyReply reply;
+		reply.request = commands[i].request;
+		reply.error = "the context that owns the object has been destroyed";
+		send_reply(commands[i].requester, reply);
+	}
+	for (const KeyValue<uint64_t, QuickJSProxyRequest> &E : p_binder->proxy_requests) {
+		JS_FreeValue(p_binder->ctx, E.value.resolving_funcs[0]);
+		JS_FreeValue(p_binder->ctx, E.value.resolving_funcs[1]);
+	}
+	p_binder->proxy_requests.clear();
+}
+
+void QuickJSObjectProxy::flush(QuickJSBinder *p_binder) {
+	LocalVector<QuickJSProxyCommand> commands;
+	LocalVector<QuickJSProxyReply> replies;
+	{
+		MutexLock lock(p_binder->proxy_mutex);
+		if (p_binder->proxy_commands.is_empty() && p_binder->proxy_replies.is_empty()) {
+			return;
+		}
+		commands = p_binder->proxy_commands;
+		replies = p_binder->proxy_replies;
+		p_binder->proxy_commands.clear();
+		p_binder->proxy_replies.clear();
+	}
+
+	for (uint32_t i = 0; i < commands.size(); i++) {
+		send_reply(commands[i].requester, run_command(commands[i]));
+	}
+
+	for (uint32_t i = 0; i < replies.size(); i++) {
+		HashMap<uint64_t, QuickJSProxyRequest>::Iterator E = p_binder->proxy_requests.find(replies[i].request);
+		if (E) {
+			QuickJSProxyRequest request = E->value;
+			p_binder->proxy_requests.remove(E);
+			settle_request(p_binder->ctx, request, replies[i]);
+		}
+	}
+}
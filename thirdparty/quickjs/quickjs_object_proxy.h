@@ -0,0 +1,80 @@
+#ifndef QUICKJS_OBJECT_PROXY_H
+#define QUICKJS_OBJECT_PROXY_H
+
+#include "core/object/object_id.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+#include "quickjs/quickjs.h"
+
+class QuickJSBinder;
+
+/* A method call or property access on an object of another context, run by the context that owns the object */
+struct QuickJSProxyCommand {
+	enum Type {
+		TYPE_CALL,
+		TYPE_GET,
+		TYPE_SET,
+	};
+	Type type = TYPE_CALL;
+	ObjectID object;
+	StringName name;
+	Vector<Variant> arguments;
+	// Context id of the sender and the id of the request to settle in the sender
+	uint32_t requester = 0;
+	uint64_t request = 0;
+};
+
+struct QuickJSProxyReply {
+	uint64_t request = 0;
+	Variant value;
+	// The promise of the request is rejected if this is not empty
+	String error;
+};
+
+/* Promise of a command waiting for its reply in the context that sent it */
+struct QuickJSProxyRequest {
+	JSValue resolving_funcs[2];
+};
+
+/*
+ * The JavaScript handle of an object bound to another context, `godot.ObjectProxy`.
+ * It only keeps the id of the object so it never extends its lifetime.
+ */
+class QuickJSObjectProxy {
+	ObjectID object;
+	uint32_t owner = 0;
+
+	// Live contexts by context id, commands and replies are only pushed to contexts found here
+	static HashMap<uint32_t, QuickJSBinder *> contexts;
+	// Ids of the live contexts by JSContext, so a proxy finds its owner without touching the context of another thread
+	static HashMap<const void *, uint32_t> context_ids;
+	static Mutex contexts_mutex;
+
+	static JSValue proxy_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+	static void proxy_finalizer(JSRuntime *rt, JSValue val);
+	static JSValue proxy_command(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv, int magic);
+	static JSValue proxy_instance_id(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+
+	static QuickJSProxyReply run_command(const QuickJSProxyCommand &p_command);
+	static void send_reply(uint32_t p_requester, const QuickJSProxyReply &p_reply);
+	static void settle_request(JSContext *ctx, const QuickJSProxyRequest &p_request, const QuickJSProxyReply &p_reply);
+
+public:
+	static void add_proxy_class(QuickJSBinder *p_binder);
+	/* Creates the proxy of an object bound to `p_owner_context`, its commands are rejected if that context is already destroyed */
+	static JSValue new_proxy(JSContext *ctx, Object *p_object, const void *p_owner_context);
+	/* Returns the object of a proxy, or NULL if `p_value` is not a proxy or its object was freed */
+	static Object *get_proxy_object(JSContext *ctx, JSValueConst p_value);
+
+	static void register_context(QuickJSBinder *p_binder);
+	/* Rejects the commands sent to `p_binder` and drops its own pending requests */
+	static void unregister_context(QuickJSBinder *p_binder);
+
+	/* Runs the commands sent to the objects of `p_binder` and settles the replies of its requests, called from its frame */
+	static void flush(QuickJSBinder *p_binder);
+};
+
+#endif // QUICKJS_OBJECT_PROXY_H
@@ -0,0 +1,501 @@
+#include "quickjs_task_pool.h"
+#include "core/config/project_settings.h"
+#include "core/os/os.h"
+
+// Chunks per runner, more chunks balance better but cost more synchronization
+#define TASK_POOL_CHUNKS_PER_RUNNER 4
+
+QuickJSTaskPool *QuickJSTaskPool::singleton = NULL;
+Mutex QuickJSTaskPool::singleton_mutex;
+
+void QuickJSTaskRunner::initialize() {
+	QuickJSBinder::initialize();
+	// Runners have their own thread so Atomics.wait is allowed to block
+	JS_SetCanBlock(runtime, true);
+	JS_SetInterruptHandler(runtime, interrupt_handler, this);
+	// Tasks cannot start other tasks
+	JSAtom parallel_atom = JS_NewAtom(ctx, "parallel");
+	JS_DeleteProperty(ctx, godot_object, parallel_atom, 0);
+	JS_FreeAtom(ctx, parallel_atom);
+}
+
+void QuickJSTaskRunner::uninitialize() {
+	for (const KeyValue<String, JSValue> &E : task_functions) {
+		JS_FreeValue(ctx, E.value);
+	}
+	task_functions.clear();
+	QuickJSBinder::uninitialize();
+}
+
+JSValue QuickJSTaskRunner::get_task_function(const String &p_module, const String &p_function) {
+	const String key = p_module + "#" + p_function;
+	if (const JSValue *ptr = task_functions.getptr(key)) {
+		return JS_DupValue(ctx, *ptr);
+	}
+
+	CharString module_name = p_module.utf8();
+	JSModuleDef *m = js_module_loader(ctx, module_name.get_data(), this);
+	if (!m) {
+		return JS_ThrowReferenceError(ctx, "Could not load module '%s'", module_name.get_data());
+	}
+	if (ModuleCache *module = module_cache.getptr(resolve_module_file(p_module))) {
+		JavaScriptError err;
+		if ((module->flags & MODULE_FLAG_SCRIPT) && js_evalute_module(ctx, module, &err) != OK) {
+			return JS_EXCEPTION;
+		}
+	}
+
+	JSValue func = JS_UNDEFINED;
+	JSAtom function_atom = JS_NewAtom(ctx, p_function.utf8().get_data());
+	for (int i = 0; i < JS_GetModuleExportEntriesCount(m); i++) {
+		JSAtom name = JS_GetModuleExportEntryName(ctx, m, i);
+		if (name == function_atom) {
+			func = JS_GetModuleExportEntry(ctx, m, i);
+			JS_FreeAtom(ctx, name);
+			break;
+		}
+		JS_FreeAtom(ctx, name);
+	}
+	JS_FreeAtom(ctx, function_atom);
+
+	if (!JS_IsFunction(ctx, func)) {
+		JS_FreeValue(ctx, func);
+		return JS_ThrowTypeError(ctx, "'%s' is not a function exported by module '%s'", p_function.utf8().get_data(), module_name.get_data());
+	}
+	task_functions.insert(key, JS_DupValue(ctx, func));
+	return func;
+}
+
+int QuickJSTaskRunner::interrupt_handler(JSRuntime *rt, void *p_runner) {
+	const QuickJSTaskRunner *runner = static_cast<const QuickJSTaskRunner *>(p_runner);
+	if (runner->exiting && runner->exiting->is_set()) {
+		return 1;
+	}
+	return runner->current_batch && runner->current_batch->cancelled.is_set();
+}
+
+void QuickJSTaskRunner::fail(QuickJSTaskBatch *p_batch) {
+	JSValue e = JS_GetException(ctx);
+	JavaScriptError err;
+	dump_exception(ctx, e, &err);
+	JS_FreeValue(ctx, e);
+
+	MutexLock lock(p_batch->error_mutex);
+	if (p_batch->error.is_empty()) {
+		p_batch->error = error_to_string(err);
+	}
+	p_batch->cancelled.set();
+}
+
+void QuickJSTaskRunner::run(const QuickJSTaskChunk &p_chunk) {
+	QuickJSTaskBatch *batch = p_chunk.batch;
+	if (batch->cancelled.is_set()) {
+		return;
+	}
+	current_batch = batch;
+
+	JSValue func = get_task_function(batch->module, batch->function);
+	JSValue data = JS_UNDEFINED;
+	if (!JS_IsException(func) && batch->has_data) {
+		data = QuickJSWorker::read_message(ctx, batch->data, false);
+	}
+
+	if (JS_IsException(func) || JS_IsException(data)) {
+		fail(batch);
+	} else {
+		for (int64_t i = p_chunk.from; i < p_chunk.to && !batch->cancelled.is_set(); i++) {
+			JSValue ret;
+			if (batch->map) {
+				JSValue argv[] = { QuickJSWorker::read_message(ctx, batch->inputs[i]), JS_NewInt64(ctx, i) };
+				batch->inputs[i] = QuickJSWorkerMessage();
+				if (JS_IsException(argv[0])) {
+					ret = JS_EXCEPTION;
+				} else {
+					ret = JS_Call(ctx, func, global_object, 2, argv);
+					JS_FreeValue(ctx, argv[0]);
+				}
+				// The engine objects of this context cannot be handed to the owner
+				if (!JS_IsException(ret) && !QuickJSWorker::write_message(ctx, ret, JS_UNDEFINED, true, batch->results[i], false)) {
+					JS_FreeValue(ctx, ret);
+					ret = JS_EXCEPTION;
+				}
+			} else {
+				JSValue argv[] = { JS_NewInt64(ctx, batch->begin + i), data };
+				ret = JS_Call(ctx, func, global_object, 2, argv);
+			}
+			if (JS_IsException(ret)) {
+				fail(batch);
+				break;
+			}
+			JS_FreeValue(ctx, ret);
+		}
+	}
+
+	JS_FreeValue(ctx, data);
+	JS_FreeValue(ctx, func);
+	// Run the jobs queued by the tasks
+	frame();
+	current_batch = NULL;
+}
+
+void QuickJSTaskPool::thread_main(void *p_runner) {
+	Runner *runner = static_cast<Runner *>(p_runner);
+	QuickJSTaskPool *pool = runner->pool;
+
+	runner->binder.set_exiting_flag(&pool->exiting);
+	runner->binder.initialize();
+	{
+		MutexLock lock(runner->mutex);
+		runner->runtime = runner->binder.get_runtime();
+	}
+	while (true) {
+		runner->binder.wait();
+		if (pool->exiting.is_set()) {
+			break;
+		}
+		// Run the commands sent to the objects of this context and settle the replies of its requests
+		runner->binder.frame();
+		// Drain the own deque then steal, the extra posts of the chunks taken here only cost an empty loop
+		QuickJSTaskChunk chunk;
+		while (!pool->exiting.is_set() && pool->pop_chunk(runner->index, chunk)) {
+			runner->binder.run(chunk);
+			finish_chunk(chunk);
+		}
+	}
+	{
+		MutexLock lock(runner->mutex);
+		runner->runtime = NULL;
+	}
+	runner->binder.uninitialize();
+}
+
+bool QuickJSTaskPool::pop_chunk(uint32_t p_runner, QuickJSTaskChunk &r_chunk) {
+	{
+		Runner *runner = runners[p_runner];
+		MutexLock lock(runner->mutex);
+		if (!runner->deque.is_empty()) {
+			r_chunk = runner->deque.back()->get();
+			runner->deque.pop_back();
+			return true;
+		}
+	}
+	for (uint32_t i = 1; i < runners.size(); i++) {
+		Runner *victim = runners[(p_runner + i) % runners.size()];
+		MutexLock lock(victim->mutex);
+		if (!victim->deque.is_empty()) {
+			r_chunk = victim->deque.front()->get();
+			victim->deque.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void QuickJSTaskPool::submit(QuickJSTaskBatch *p_batch, int64_t p_count) {
+	const int64_t max_chunks = runners.size() * TASK_POOL_CHUNKS_PER_RUNNER;
+	const int64_t chunk_size = (p_count + max_chunks - 1) / max_chunks;
+	const uint32_t chunk_count = (p_count + chunk_size - 1) / chunk_size;
+	p_batch->pending_chunks.set(chunk_count);
+
+	for (int64_t from = 0; from < p_count; from += chunk_size) {
+		QuickJSTaskChunk chunk;
+		chunk.batch = p_batch;
+		chunk.from = from;
+		chunk.to = MIN(from + chunk_size, p_count);
+		Runner *runner = runners[next_runner.postincrement() % runners.size()];
+		{
+			MutexLock lock(runner->mutex);
+			runner->deque.push_back(chunk);
+		}
+		runner->binder.wake_up();
+	}
+}
+
+void QuickJSTaskPool::finish_chunk(const QuickJSTaskChunk &p_chunk) {
+	QuickJSTaskBatch *batch = p_chunk.batch;
+	if (batch->pending_chunks.decrement() == 0) {
+		QuickJSBinder *owner = batch->owner;
+		// A cancelling owner can be destroyed once the lock is released, it is not touched after that
+		MutexLock lock(owner->task_mutex);
+		owner->completed_task_batches.push_back(batch);
+		if (owner->cancelling_task_batches) {
+			owner->task_semaphore.post();
+		}
+		owner->wake_up();
+	}
+}
+
+void QuickJSTaskPool::interrupt_runners() {
+	for (uint32_t i = 0; i < runners.size(); i++) {
+		MutexLock lock(runners[i]->mutex);
+		if (runners[i]->runtime) {
+			JS_InterruptAtomicsWait(runners[i]->runtime);
+		}
+	}
+}
+
+QuickJSTaskPool::QuickJSTaskPool(uint32_t p_thread_count) {
+	runners.resize(MAX(p_thread_count, 1u));
+	for (uint32_t i = 0; i < runners.size(); i++) {
+		Runner *runner = memnew(Runner);
+		runner->pool = this;
+		runner->index = i;
+		runners[i] = runner;
+	}
+	for (uint32_t i = 0; i < runners.size(); i++) {
+		runners[i]->thread.start(thread_main, runners[i]);
+	}
+}
+
+QuickJSTaskPool::~QuickJSTaskPool() {
+	exiting.set();
+	interrupt_runners();
+	for (uint32_t i = 0; i < runners.size(); i++) {
+		runners[i]->binder.wake_up();
+	}
+	for (uint32_t i = 0; i < runners.size(); i++) {
+		runners[i]->thread.wait_to_finish();
+	}
+	// The chunks that were never run still complete their batches, which are rejected
+	for (uint32_t i = 0; i < runners.size(); i++) {
+		for (const QuickJSTaskChunk &chunk : runners[i]->deque) {
+			{
+				MutexLock lock(chunk.batch->error_mutex);
+				if (chunk.batch->error.is_empty()) {
+					chunk.batch->error = "the task pool was shut down";
+				}
+			}
+			chunk.batch->cancelled.set();
+			finish_chunk(chunk);
+		}
+		memdelete(runners[i]);
+	}
+	runners.clear();
+}
+
+QuickJSTaskPool *QuickJSTaskPool::get_singleton() {
+	MutexLock lock(singleton_mutex);
+	if (!singleton) {
+		int thread_count = GLOBAL_GET("JavaScript/parallel/thread_count");
+		if (thread_count <= 0) {
+			thread_count = OS::get_singleton()->get_processor_count() - 1;
+		}
+		singleton = memnew(QuickJSTaskPool(MAX(thread_count, 1)));
+	}
+	return singleton;
+}
+
+void QuickJSTaskPool::finalize() {
+	MutexLock lock(singleton_mutex);
+	if (singleton) {
+		memdelete(singleton);
+		singleton = NULL;
+	}
+}
+
+void QuickJSTaskPool::free_batch(QuickJSBinder *p_owner, QuickJSTaskBatch *p_batch) {
+	JS_FreeValue(p_owner->ctx, p_batch->resolving_funcs[0]);
+	JS_FreeValue(p_owner->ctx, p_batch->resolving_funcs[1]);
+	for (uint32_t i = 0; i < p_batch->inputs.size(); i++) {
+		QuickJSWorker::free_message(p_owner->runtime, p_batch->inputs[i]);
+	}
+	for (uint32_t i = 0; i < p_batch->results.size(); i++) {
+		QuickJSWorker::free_message(p_owner->runtime, p_batch->results[i]);
+	}
+	QuickJSWorker::free_message(p_owner->runtime, p_batch->data);
+	memdelete(p_batch);
+}
+
+void QuickJSTaskPool::process_completions(QuickJSBinder *p_owner) {
+	LocalVector<QuickJSTaskBatch *> batches;
+	{
+		MutexLock lock(p_owner->task_mutex);
+		batches = p_owner->completed_task_batches;
+		p_owner->completed_task_batches.clear();
+	}
+
+	JSContext *ctx = p_owner->ctx;
+	for (uint32_t i = 0; i < batches.size(); i++) {
+		QuickJSTaskBatch *batch = batches[i];
+		p_owner->pending_task_batches.erase(batch);
+
+		bool resolved = batch->error.is_empty();
+		JSValue value = JS_UNDEFINED;
+		if (resolved && batch->map) {
+			value = JS_NewArray(ctx);
+			for (uint32_t j = 0; j < batch->results.size(); j++) {
+				JSValue item = QuickJSWorker::read_message(ctx, batch->results[j]);
+				batch->results[j] = QuickJSWorkerMessage();
+				if (JS_IsException(item)) {
+					JS_FreeValue(ctx, value);
+					value = JS_GetException(ctx);
+					resolved = false;
+					break;
+				}
+				JS_SetPropertyUint32(ctx, value, j, item);
+			}
+		} else if (!resolved) {
+			value = JS_NewError(ctx);
+			JS_DefinePropertyValueStr(ctx, value, "message", QuickJSBinder::to_js_string(ctx, batch->error), JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+		}
+
+		JSValue ret = JS_Call(ctx, batch->resolving_funcs[resolved ? 0 : 1], JS_UNDEFINED, 1, &value);
+		JS_FreeValue(ctx, ret);
+		JS_FreeValue(ctx, value);
+		free_batch(p_owner, batch);
+	}
+}
+
+void QuickJSTaskPool::cancel_batches(QuickJSBinder *p_owner) {
+	if (p_owner->pending_task_batches.is_empty()) {
+		return;
+	}
+	{
+		MutexLock lock(p_owner->task_mutex);
+		p_owner->cancelling_task_batches = true;
+	}
+	for (uint32_t i = 0; i < p_owner->pending_task_batches.size(); i++) {
+		p_owner->pending_task_batches[i]->cancelled.set();
+	}
+	{
+		// The flags are set before the waiters are woken, so a task cannot block again without seeing them
+		MutexLock lock(singleton_mutex);
+		if (singleton) {
+			singleton->interrupt_runners();
+		}
+	}
+	while (p_owner->pending_task_batches.size()) {
+		LocalVector<QuickJSTaskBatch *> batches;
+		{
+			MutexLock lock(p_owner->task_mutex);
+			batches = p_owner->completed_task_batches;
+			p_owner->completed_task_batches.clear();
+		}
+		for (uint32_t i = 0; i < batches.size(); i++) {
+			p_owner->pending_task_batches.erase(batches[i]);
+			free_batch(p_owner, batches[i]);
+		}
+		if (p_owner->pending_task_batches.size()) {
+			// Posted by the runners for each batch they complete from now on
+			p_owner->task_semaphore.wait();
+		}
+	}
+	{
+		MutexLock lock(p_owner->task_mutex);
+		p_owner->cancelling_task_batches = false;
+	}
+}
+
+bool QuickJSTaskPool::parse_task_function(JSContext *ctx, JSValueConst p_value, String &r_module, String &r_function) {
+	if (JS_IsString(p_value)) {
+		String path = QuickJSBinder::js_to_string(ctx, p_value);
+		int separator = path.rfind("#");
+		if (separator == -1) {
+			r_module = path;
+			r_function = "default";
+		} else {
+			r_module = path.substr(0, separator);
+			r_function = path.substr(separator + 1);
+		}
+	} else if (JS_IsObject(p_value)) {
+		JSValue module = JS_GetPropertyStr(ctx, p_value, "module");
+		JSValue function = JS_GetPropertyStr(ctx, p_value, "export");
+		if (JS_IsString(module)) {
+			r_module = QuickJSBinder::js_to_string(ctx, module);
+		}
+		r_function = JS_IsString(function) ? QuickJSBinder::js_to_string(ctx, function) : String("default");
+		JS_FreeValue(ctx, module);
+		JS_FreeValue(ctx, function);
+	}
+	if (r_module.is_empty() || r_function.is_empty()) {
+		JS_ThrowTypeError(ctx, "task function must be a 'module#export' string or a { module, export } object");
+		return false;
+	}
+	return true;
+}
+
+JSValue QuickJSTaskPool::start_batch(JSContext *ctx, QuickJSTaskBatch *p_batch, int64_t p_count) {
+	QuickJSBinder *owner = QuickJSBinder::get_context_binder(ctx);
+	JSValue promise = JS_NewPromiseCapability(ctx, p_batch->resolving_funcs);
+	if (JS_IsException(promise)) {
+		p_batch->resolving_funcs[0] = JS_UNDEFINED;
+		p_batch->resolving_funcs[1] = JS_UNDEFINED;
+		free_batch(owner, p_batch);
+		return promise;
+	}
+
+	p_batch->owner = owner;
+	owner->pending_task_batches.push_back(p_batch);
+	if (p_count > 0) {
+		get_singleton()->submit(p_batch, p_count);
+	} else {
+		{
+			MutexLock lock(owner->task_mutex);
+			owner->completed_task_batches.push_back(p_batch);
+		}
+		owner->wake_up();
+	}
+	return promise;
+}
+
+JSValue QuickJSTaskPool::parallel_for(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	ERR_FAIL_COND_V(argc < 2, JS_ThrowTypeError(ctx, "range and task function expected"));
+
+	int64_t begin = 0;
+	int64_t end = 0;
+	if (JS_IsArray(ctx, argv[0])) {
+		JSValue from = JS_GetPropertyUint32(ctx, argv[0], 0);
+		JSValue to = JS_GetPropertyUint32(ctx, argv[0], 1);
+		int err = JS_ToInt64(ctx, &begin, from) | JS_ToInt64(ctx, &end, to);
+		JS_FreeValue(ctx, from);
+		JS_FreeValue(ctx, to);
+		if (err) {
+			return JS_EXCEPTION;
+		}
+	} else if (JS_ToInt64(ctx, &end, argv[0])) {
+		return JS_EXCEPTION;
+	}
+
+	QuickJSTaskBatch *batch = memnew(QuickJSTaskBatch);
+	batch->begin = begin;
+	if (!parse_task_function(ctx, argv[1], batch->module, batch->function)) {
+		memdelete(batch);
+		return JS_EXCEPTION;
+	}
+	if (argc > 2 && !JS_IsUndefined(argv[2])) {
+		if (!QuickJSWorker::write_message(ctx, argv[2], JS_UNDEFINED, true, batch->data)) {
+			memdelete(batch);
+			return JS_EXCEPTION;
+		}
+		batch->has_data = true;
+	}
+	return start_batch(ctx, batch, MAX(end - begin, 0));
+}
+
+JSValue QuickJSTaskPool::parallel_map(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+	ERR_FAIL_COND_V(argc < 2 || !JS_IsArray(ctx, argv[0]), JS_ThrowTypeError(ctx, "array and task function expected"));
+
+	QuickJSTaskBatch *batch = memnew(QuickJSTaskBatch);
+	batch->map = true;
+	if (!parse_task_function(ctx, argv[1], batch->module, batch->function)) {
+		memdelete(batch);
+		return JS_EXCEPTION;
+	}
+
+	const int length = QuickJSBinder::get_js_array_length(ctx, argv[0]);
+	batch->inputs.resize(length);
+	batch->results.resize(length);
+	for (int i = 0; i < length; i++) {
+		JSValue item = JS_GetPropertyUint32(ctx, argv[0], i);
+		bool valid = QuickJSWorker::write_message(ctx, item, JS_UNDEFINED, true, batch->inputs[i]);
+		JS_FreeValue(ctx, item);
+		if (!valid) {
+			for (int j = 0; j < i; j++) {
+				QuickJSWorker::free_message(JS_GetRuntime(ctx), batch->inputs[j]);
+			}
+			memdelete(batch);
+			return JS_EXCEPTION;
+		}
+	}
+	return start_batch(ctx, batch, length);
+}
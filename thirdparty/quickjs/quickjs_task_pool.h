@@ -0,0 +1,116 @@
+#ifndef QUICKJS_TASK_POOL_H
+#define QUICKJS_TASK_POOL_H
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+#include "quickjs_binder.h"
+#include "quickjs_worker.h"
+
+/* A `godot.parallel` call, owned by the binder that started it until its promise is settled */
+struct QuickJSTaskBatch {
+	QuickJSBinder *owner = NULL;
+	String module;
+	String function;
+	bool map = false;
+	// First index passed to the function by `parallelFor`
+	int64_t begin = 0;
+	// Elements of the array passed to `map`, consumed by the runners
+	LocalVector<QuickJSWorkerMessage> inputs;
+	// Values returned by the function for each element of `map`, consumed by the owner
+	LocalVector<QuickJSWorkerMessage> results;
+	// Extra argument shared by all the calls of `parallelFor`
+	QuickJSWorkerMessage data;
+	bool has_data = false;
+
+	SafeNumeric<uint32_t> pending_chunks;
+	SafeFlag cancelled;
+	Mutex error_mutex;
+	String error;
+	JSValue resolving_funcs[2];
+};
+
+/* A contiguous range of a batch, the unit of work that runners pop and steal */
+struct QuickJSTaskChunk {
+	QuickJSTaskBatch *batch = NULL;
+	int64_t from = 0;
+	int64_t to = 0;
+};
+
+/* A context running on a thread of the task pool, task functions are loaded once per runner and cached */
+class QuickJSTaskRunner : public QuickJSBinder {
+	HashMap<String, JSValue> task_functions;
+	// Posted for the chunks pushed to this runner and the proxy commands and replies sent to its context
+	Semaphore semaphore;
+	// The running tasks are interrupted when their batch is cancelled or the pool exits
+	QuickJSTaskBatch *current_batch = NULL;
+	const SafeFlag *exiting = NULL;
+
+	JSValue get_task_function(const String &p_module, const String &p_function);
+	void fail(QuickJSTaskBatch *p_batch);
+	static int interrupt_handler(JSRuntime *rt, void *p_runner);
+
+public:
+	virtual void initialize() override;
+	virtual void uninitialize() override;
+	virtual void wake_up() const override { semaphore.post(); }
+
+	_FORCE_INLINE_ void wait() const { semaphore.wait(); }
+	_FORCE_INLINE_ void set_exiting_flag(const SafeFlag *p_exiting) { exiting = p_exiting; }
+
+	void run(const QuickJSTaskChunk &p_chunk);
+};
+
+class QuickJSTaskPool {
+	struct Runner {
+		QuickJSTaskPool *pool = NULL;
+		uint32_t index = 0;
+		QuickJSTaskRunner binder;
+		Thread thread;
+		Mutex mutex;
+		// The owner of the deque pops from the back, idle runners steal from the front
+		List<QuickJSTaskChunk> deque;
+		// Runtime of `binder` while it is initialized, guarded by `mutex`
+		JSRuntime *runtime = NULL;
+	};
+
+	LocalVector<Runner *> runners;
+	SafeFlag exiting;
+	SafeNumeric<uint32_t> next_runner;
+
+	static QuickJSTaskPool *singleton;
+	static Mutex singleton_mutex;
+
+	static void thread_main(void *p_runner);
+	bool pop_chunk(uint32_t p_runner, QuickJSTaskChunk &r_chunk);
+	void submit(QuickJSTaskBatch *p_batch, int64_t p_count);
+	static void finish_chunk(const QuickJSTaskChunk &p_chunk);
+	/* Wakes the tasks blocked in `Atomics.wait` so they check whether they are interrupted */
+	void interrupt_runners();
+
+	static bool parse_task_function(JSContext *ctx, JSValueConst p_value, String &r_module, String &r_function);
+	static JSValue start_batch(JSContext *ctx, QuickJSTaskBatch *p_batch, int64_t p_count);
+	static void free_batch(QuickJSBinder *p_owner, QuickJSTaskBatch *p_batch);
+
+public:
+	QuickJSTaskPool(uint32_t p_thread_count);
+	~QuickJSTaskPool();
+
+	/* Creates the pool on first use, the thread count is read from the `JavaScript/parallel/thread_count` project setting */
+	static QuickJSTaskPool *get_singleton();
+	static void finalize();
+
+	/* Settles the promises of the batches of `p_owner` that are done, called from the frame of the owner */
+	static void process_completions(QuickJSBinder *p_owner);
+	/* Cancels the batches of `p_owner`, interrupts their running tasks and waits for the runners to drop them, their promises are never settled */
+	static void cancel_batches(QuickJSBinder *p_owner);
+
+	static JSValue parallel_for(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+	static JSValue parallel_map(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+};
+
+#endif // QUICKJS_TASK_POOL_H
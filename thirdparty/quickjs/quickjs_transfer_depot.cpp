@@ -0,0 +1,60 @@
+#include "quickjs_transfer_depot.h"
+#include "core/os/os.h"
+
+uint64_t QuickJSTransferDepot::store(const Variant &p_value) {
+	const uint64_t id = next_id.increment();
+	Shard &shard = get_shard(id);
+	Entry entry;
+	entry.value = p_value;
+	entry.time = OS::get_singleton()->get_ticks_msec();
+	MutexLock lock(shard.mutex);
+	shard.entries.insert(id, entry);
+	return id;
+}
+
+bool QuickJSTransferDepot::take(uint64_t p_id, Variant &r_value) {
+	Shard &shard = get_shard(p_id);
+	MutexLock lock(shard.mutex);
+	HashMap<uint64_t, Entry>::Iterator E = shard.entries.find(p_id);
+	if (!E) {
+		return false;
+	}
+	r_value = E->value.value;
+	shard.entries.remove(E);
+	return true;
+}
+
+void QuickJSTransferDepot::sweep(LocalVector<Variant> &r_values) {
+	const uint64_t timeout = timeout_msec.get();
+	const uint64_t now = OS::get_singleton()->get_ticks_msec();
+	if (timeout == 0 || now - last_sweep < 1000) {
+		return;
+	}
+	last_sweep = now;
+
+	LocalVector<uint64_t> expired;
+	for (int i = 0; i < TRANSFER_DEPOT_SHARD_COUNT; i++) {
+		Shard &shard = shards[i];
+		MutexLock lock(shard.mutex);
+		expired.clear();
+		for (const KeyValue<uint64_t, Entry> &E : shard.entries) {
+			if (now - E.value.time > timeout) {
+				expired.push_back(E.key);
+			}
+		}
+		for (uint32_t j = 0; j < expired.size(); j++) {
+			r_values.push_back(shard.entries[expired[j]].value);
+			shard.entries.erase(expired[j]);
+		}
+	}
+}
+
+void QuickJSTransferDepot::clear(LocalVector<Variant> &r_values) {
+	for (int i = 0; i < TRANSFER_DEPOT_SHARD_COUNT; i++) {
+		MutexLock lock(shards[i].mutex);
+		for (const KeyValue<uint64_t, Entry> &E : shards[i].entries) {
+			r_values.push_back(E.value.value);
+		}
+		shards[i].entries.clear();
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef QUICKJS_TRANSFER_DEPOT_H
+#define QUICKJS_TRANSFER_DEPOT_H
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/variant/variant.h"
+
+#define TRANSFER_DEPOT_SHARD_COUNT 16
+
+/*
+ * Values abandoned by a context until they are adopted by another one.
+ * Entries are spread over shards by transfer id so contexts handing values over at the same time rarely wait on the same lock.
+ */
+class QuickJSTransferDepot {
+	struct Entry {
+		Variant value;
+		uint64_t time = 0;
+	};
+	struct Shard {
+		Mutex mutex;
+		HashMap<uint64_t, Entry> entries;
+	};
+
+	Shard shards[TRANSFER_DEPOT_SHARD_COUNT];
+	SafeNumeric<uint64_t> next_id;
+	// Entries older than this are dropped by `sweep`, 0 keeps them until they are adopted
+	SafeNumeric<uint64_t> timeout_msec;
+	uint64_t last_sweep = 0;
+
+	_FORCE_INLINE_ Shard &get_shard(uint64_t p_id) { return shards[p_id % TRANSFER_DEPOT_SHARD_COUNT]; }
+
+public:
+	/* Returns the non zero transfer id of the value */
+	uint64_t store(const Variant &p_value);
+	/* Removes the value from the depot, returns false if the id is unknown or expired */
+	bool take(uint64_t p_id, Variant &r_value);
+	/* Moves the expired entries to `r_values`, at most once per second. Only called from the main thread */
+	void sweep(LocalVector<Variant> &r_values);
+	/* Moves all the entries to `r_values` */
+	void clear(LocalVector<Variant> &r_values);
+
+	_FORCE_INLINE_ void set_timeout(uint64_t p_msec) { timeout_msec.set(p_msec); }
+};
+
+#endif // QUICKJS_TRANSFER_DEPOT_H
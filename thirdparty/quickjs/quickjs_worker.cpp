@@ -5,7 +5,6 @@ void QuickJSWorker::thread_main(void *p_this) {
 	QuickJSWorker *self = static_cast<QuickJSWorker *>(p_this);
 
 	self->initialize();
-	self->running = true;
 
 	Error err;
 	String text = FileAccess::get_file_as_string(self->entry_script, &err);
@@ -17,32 +16,28 @@ void QuickJSWorker::thread_main(void *p_this) {
 		if (err == OK) {
 			JSValue onmessage_callback = JS_GetPropertyStr(self->ctx, self->global_object, "onmessage");
 			bool onmessage_valid = JS_IsFunction(self->ctx, onmessage_callback);
-			while (self->running) {
+			LocalVector<QuickJSWorkerMessage> messages;
+			while (self->running.is_set()) {
 				self->frame();
 
 				if (onmessage_valid) {
-					List<Variant> messages;
-					{
-						GLOBAL_LOCK_FUNCTION
-						for (List<Variant>::Element *E = self->input_message_queue.front(); E; E = E->next()) {
-							messages.push_back(E->get());
-						}
-						self->input_message_queue.clear();
-					}
-					for (List<Variant>::Element *E = messages.front(); E; E = E->next()) {
-						JSValue argv[] = { variant_to_var(self->ctx, E->get()) };
-						JSValue ret = JS_Call(self->ctx, onmessage_callback, self->global_object, 1, argv);
-						if (JS_IsException(ret)) {
-							JSValue e = JS_GetException(self->ctx);
-							JavaScriptError err;
-							dump_exception(self->ctx, e, &err);
-							ERR_PRINT(String("Error in worker onmessage callback") + ENDL + self->error_to_string(err));
-							JS_FreeValue(self->ctx, e);
-						}
-						JS_FreeValue(self->ctx, argv[0]);
+					messages.clear();
+					self->input_message_queue.pop_batch(messages);
+					for (uint32_t i = 0; i < messages.size(); i++) {
+						call_onmessage(self, onmessage_callback, self->global_object, messages[i]);
 					}
 				}
-				OS::get_singleton()->delay_usec(1000);
+
+				if (!self->running.is_set()) {
+					break;
+				}
+				// Promise jobs are only queued by this thread, keep looping until they are drained
+				if (JS_IsJobPending(self->runtime)) {
+					continue;
+				}
+				// Animation frame callbacks are driven by the frames of the host
+				self->frame_requested.set_to(!self->frame_callbacks.is_empty());
+				self->wake_semaphore.wait();
 			}
 			JS_FreeValue(self->ctx, onmessage_callback);
 		} else {
@@ -53,12 +48,13 @@ void QuickJSWorker::thread_main(void *p_this) {
 	}
 
 	self->uninitialize();
+	self->running.clear();
 }
 
 JSValue QuickJSWorker::global_worker_close(JSContext *ctx, JSValue this_val, int argc, JSValue *argv) {
 	QuickJSWorker *worker = static_cast<QuickJSWorker *>(get_context_binder(ctx));
 	if (worker) {
-		worker->running = false;
+		worker->running.clear();
 	}
 	return JS_UNDEFINED;
 }
@@ -67,8 +63,15 @@ JSValue QuickJSWorker::global_worker_post_message(JSContext *ctx, JSValue this_v
 	ERR_FAIL_COND_V(argc < 1, JS_ThrowTypeError(ctx, "message value expected of argument #0"));
 	QuickJSWorker *worker = static_cast<QuickJSWorker *>(get_context_binder(ctx));
 	if (worker) {
-		GLOBAL_LOCK_FUNCTION
-		worker->output_message_queue.push_back(var_to_variant(ctx, argv[0]));
+		QuickJSWorkerMessage message;
+		if (!write_message(ctx, argv[0], argc > 1 ? argv[1] : JS_UNDEFINED, worker->structured_clone, message)) {
+			return JS_EXCEPTION;
+		}
+		if (!worker->output_message_queue.push(message)) {
+			free_message(worker->runtime, message);
+			return JS_ThrowRangeError(ctx, "the message queue of the worker is full");
+		}
+		worker->host_context->wake_up();
 	}
 	return JS_UNDEFINED;
 }
@@ -89,16 +92,24 @@ JSValue QuickJSWorker::global_import_scripts(JSContext *ctx, JSValue this_val, i
 
 QuickJSWorker::QuickJSWorker(const QuickJSBinder *p_host_context) :
 		QuickJSBinder() {
-	running = false;
 	host_context = p_host_context;
 }
 
 QuickJSWorker::~QuickJSWorker() {
 	stop();
+	// Release the buffers transferred by the messages that were never read
+	LocalVector<QuickJSWorkerMessage> messages;
+	input_message_queue.pop_batch(messages);
+	output_message_queue.pop_batch(messages);
+	for (uint32_t i = 0; i < messages.size(); i++) {
+		free_message(host_context->runtime, messages[i]);
+	}
 }
 
 void QuickJSWorker::initialize() {
 	QuickJSBinder::initialize();
+	// Workers run on their own thread so Atomics.wait is allowed to block
+	JS_SetCanBlock(runtime, true);
 	// onmessage
 	JS_SetPropertyStr(ctx, global_object, "onmessage", JS_NULL);
 	// close
@@ -117,52 +128,206 @@ void QuickJSWorker::uninitialize() {
 	QuickJSBinder::uninitialize();
 }
 
-bool QuickJSWorker::frame_of_host(QuickJSBinder *host, const JSValueConst &value) {
+void QuickJSWorker::wake_up() const {
+	wake_semaphore.post();
+}
 
-	JSValue onmessage_callback = JS_GetPropertyStr(host->ctx, value, "onmessage");
-	if (JS_IsFunction(host->ctx, onmessage_callback)) {
+static bool variant_has_object(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::OBJECT:
+			return true;
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			for (int i = 0; i < array.size(); i++) {
+				if (variant_has_object(array[i])) {
+					return true;
+				}
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			const Dictionary dict = p_value;
+			const Array keys = dict.keys();
+			for (int i = 0; i < keys.size(); i++) {
+				if (variant_has_object(keys[i]) || variant_has_object(dict[keys[i]])) {
+					return true;
+				}
+			}
+		} break;
+		default:
+			break;
+	}
+	return false;
+}
+
+bool QuickJSWorker::write_message(JSContext *ctx, const JSValueConst &p_value, const JSValueConst &p_transfer, bool p_structured_clone, QuickJSWorkerMessage &r_message, bool p_objects_allowed) {
+	LocalVector<JSValue> transfer_list;
+	if (!JS_IsUndefined(p_transfer)) {
+		if (!JS_IsArray(ctx, p_transfer)) {
+			JS_ThrowTypeError(ctx, "transfer list must be an array of ArrayBuffer");
+			return false;
+		}
+		int length = get_js_array_length(ctx, p_transfer);
+		for (int i = 0; i < length; i++) {
+			transfer_list.push_back(JS_GetPropertyUint32(ctx, p_transfer, i));
+		}
+	}
 
-		List<Variant> messages;
-		{
-			GLOBAL_LOCK_FUNCTION
-			for (List<Variant>::Element *E = output_message_queue.front(); E; E = E->next()) {
-				messages.push_back(E->get());
+	bool valid = true;
+	// Nothing is detached unless the whole message can be sent
+	for (uint32_t i = 0; i < transfer_list.size() && valid; i++) {
+		for (uint32_t j = 0; j < i && valid; j++) {
+			if (JS_VALUE_GET_PTR(transfer_list[i]) == JS_VALUE_GET_PTR(transfer_list[j])) {
+				JS_ThrowTypeError(ctx, "ArrayBuffer at index %d is already in the transfer list", (int)i);
+				valid = false;
 			}
-			output_message_queue.clear();
 		}
+		valid = valid && JS_TransferArrayBuffer(ctx, NULL, transfer_list[i]) == 0;
+	}
 
-		for (List<Variant>::Element *E = messages.front(); E; E = E->next()) {
-			JSValue argv[] = { variant_to_var(host->ctx, E->get()) };
-			JSValue ret = JS_Call(host->ctx, onmessage_callback, JS_NULL, 1, argv);
-			if (JS_IsException(ret)) {
-				JSValue e = JS_GetException(host->ctx);
-				JavaScriptError err;
-				dump_exception(host->ctx, e, &err);
-				ERR_PRINT(String("Error in worker onmessage callback") + ENDL + error_to_string(err));
-				JS_FreeValue(host->ctx, e);
+	if (valid && (p_structured_clone || transfer_list.size())) {
+		size_t size = 0;
+		uint8_t **sab_tab = NULL;
+		size_t sab_tab_len = 0;
+		if (uint8_t *buf = JS_WriteObject3(ctx, &size, p_value, JS_WRITE_OBJ_REFERENCE | JS_WRITE_OBJ_SAB, &sab_tab, &sab_tab_len, transfer_list.ptr(), transfer_list.size())) {
+			r_message.data.resize(size);
+			memcpy(r_message.data.ptrw(), buf, size);
+			js_free(ctx, buf);
+			// Keep the shared memory alive even if the sender releases its buffers before the message is read
+			r_message.shared_buffers.resize(sab_tab_len);
+			for (size_t i = 0; i < sab_tab_len; i++) {
+				js_binder_sab_dup(NULL, sab_tab[i]);
+				r_message.shared_buffers[i] = sab_tab[i];
+			}
+			js_free(ctx, sab_tab);
+			r_message.transfers.resize(transfer_list.size());
+			for (uint32_t i = 0; i < transfer_list.size(); i++) {
+				JS_TransferArrayBuffer(ctx, &r_message.transfers[i], transfer_list[i]);
 			}
-			JS_FreeValue(host->ctx, argv[0]);
+		} else if (transfer_list.size()) {
+			valid = false;
+		} else {
+			// Values that cannot be cloned (engine objects and builtin types) are converted to Variant instead
+			JS_FreeValue(ctx, JS_GetException(ctx));
+			r_message.value = var_to_variant(ctx, p_value);
+		}
+	} else if (valid) {
+		r_message.value = var_to_variant(ctx, p_value);
+	}
+
+	if (valid && !p_objects_allowed && variant_has_object(r_message.value)) {
+		r_message.value = Variant();
+		JS_ThrowTypeError(ctx, "engine objects cannot be sent to another context");
+		valid = false;
+	}
+
+	for (uint32_t i = 0; i < transfer_list.size(); i++) {
+		JS_FreeValue(ctx, transfer_list[i]);
+	}
+	return valid;
+}
+
+JSValue QuickJSWorker::read_message(JSContext *ctx, const QuickJSWorkerMessage &p_message, bool p_consume) {
+	ERR_FAIL_COND_V(!p_consume && p_message.transfers.size(), JS_ThrowTypeError(ctx, "transferred buffers can only be read once"));
+	if (p_message.data.size()) {
+		LocalVector<JSValue> transfer_list;
+		for (uint32_t i = 0; i < p_message.transfers.size(); i++) {
+			JSValue buffer = JS_NewTransferredArrayBuffer(ctx, &p_message.transfers[i]);
+			if (JS_IsException(buffer)) {
+				// The failed buffer is already freed, the others still belong to the message
+				for (uint32_t j = 0; j < transfer_list.size(); j++) {
+					JS_FreeValue(ctx, transfer_list[j]);
+				}
+				for (uint32_t j = i + 1; j < p_message.transfers.size(); j++) {
+					JS_FreeTransferredArrayBuffer(JS_GetRuntime(ctx), &p_message.transfers[j]);
+				}
+				for (uint32_t j = 0; j < p_message.shared_buffers.size(); j++) {
+					js_binder_sab_free(NULL, p_message.shared_buffers[j]);
+				}
+				return buffer;
+			}
+			transfer_list.push_back(buffer);
+		}
+		JSValue ret = JS_ReadObject2(ctx, p_message.data.ptr(), p_message.data.size(), JS_READ_OBJ_REFERENCE | JS_READ_OBJ_SAB, transfer_list.ptr(), transfer_list.size());
+		for (uint32_t i = 0; i < transfer_list.size(); i++) {
+			JS_FreeValue(ctx, transfer_list[i]);
+		}
+		// The SharedArrayBuffers created by the reader hold their own references now
+		for (uint32_t i = 0; i < p_message.shared_buffers.size() && p_consume; i++) {
+			js_binder_sab_free(NULL, p_message.shared_buffers[i]);
+		}
+		return ret;
+	}
+	return variant_to_var(ctx, p_message.value);
+}
+
+void QuickJSWorker::free_message(JSRuntime *rt, const QuickJSWorkerMessage &p_message) {
+	for (uint32_t i = 0; i < p_message.transfers.size(); i++) {
+		JS_FreeTransferredArrayBuffer(rt, &p_message.transfers[i]);
+	}
+	for (uint32_t i = 0; i < p_message.shared_buffers.size(); i++) {
+		js_binder_sab_free(NULL, p_message.shared_buffers[i]);
+	}
+}
+
+void QuickJSWorker::call_onmessage(QuickJSBinder *p_binder, const JSValueConst &p_callback, const JSValueConst &p_this, const QuickJSWorkerMessage &p_message) {
+	JSContext *ctx = p_binder->ctx;
+	JSValue ret = JS_EXCEPTION;
+	JSValue argv[] = { read_message(ctx, p_message) };
+	if (!JS_IsException(argv[0])) {
+		ret = JS_Call(ctx, p_callback, p_this, 1, argv);
+		JS_FreeValue(ctx, argv[0]);
+	}
+	if (JS_IsException(ret)) {
+		JSValue e = JS_GetException(ctx);
+		JavaScriptError err;
+		dump_exception(ctx, e, &err);
+		ERR_PRINT(String("Error in worker onmessage callback") + ENDL + p_binder->error_to_string(err));
+		JS_FreeValue(ctx, e);
+	}
+	JS_FreeValue(ctx, ret);
+}
+
+bool QuickJSWorker::frame_of_host(QuickJSBinder *host, const JSValueConst &value) {
+
+	JSValue onmessage_callback = JS_GetPropertyStr(host->ctx, value, "onmessage");
+	if (JS_IsFunction(host->ctx, onmessage_callback)) {
+
+		LocalVector<QuickJSWorkerMessage> messages;
+		output_message_queue.pop_batch(messages);
+
+		for (uint32_t i = 0; i < messages.size(); i++) {
+			call_onmessage(host, onmessage_callback, JS_NULL, messages[i]);
 		}
 	}
 
 	JS_FreeValue(host->ctx, onmessage_callback);
-	return running;
+
+	if (frame_requested.is_set()) {
+		frame_requested.clear();
+		wake_up();
+	}
+	return running.is_set();
 }
 
-void QuickJSWorker::post_message_from_host(const Variant &p_message) {
-	GLOBAL_LOCK_FUNCTION
-	input_message_queue.push_back(p_message);
+bool QuickJSWorker::post_message_from_host(const QuickJSWorkerMessage &p_message) {
+	if (!input_message_queue.push(p_message)) {
+		return false;
+	}
+	wake_up();
+	return true;
 }
 
 void QuickJSWorker::start(const String &p_path) {
-	ERR_FAIL_COND(running || thread.is_started());
+	ERR_FAIL_COND(running.is_set() || thread.is_started());
 	entry_script = p_path;
+	running.set();
 	thread.start(thread_main, this);
 }
 
 void QuickJSWorker::stop() {
 	if (thread.is_started()) {
-		running = false;
+		running.clear();
+		wake_up();
 		thread.wait_to_finish();
 	}
 }
@@ -1,19 +1,39 @@
 #ifndef QUICKJS_WORKER_H
 #define QUICKJS_WORKER_H
 
+#include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
 
 #include "quickjs_binder.h"
+#include "quickjs_message_queue.h"
+
+#define WORKER_MESSAGE_QUEUE_CAPACITY 1024
+
+struct QuickJSWorkerMessage {
+	Variant value;
+	// Structured clone of the message written by `JS_WriteObject`, `value` is ignored if it is not empty
+	Vector<uint8_t> data;
+	// ArrayBuffers moved out of the sender, owned by the message until it is read
+	LocalVector<JSTransferredArrayBuffer> transfers;
+	// SharedArrayBuffer memory referenced by `data`, the message holds one reference to each until it is read
+	LocalVector<void *> shared_buffers;
+};
 
 class QuickJSWorker : public QuickJSBinder {
 	Thread thread;
-	bool running = false;
+	SafeFlag running;
+	SafeFlag frame_requested;
+	Semaphore wake_semaphore;
 	static void thread_main(void *p_self);
 	String entry_script;
 
 	const QuickJSBinder *host_context;
-	List<Variant> input_message_queue;
-	List<Variant> output_message_queue;
+	bool structured_clone = false;
+	QuickJSMessageQueue<QuickJSWorkerMessage, WORKER_MESSAGE_QUEUE_CAPACITY> input_message_queue;
+	QuickJSMessageQueue<QuickJSWorkerMessage, WORKER_MESSAGE_QUEUE_CAPACITY> output_message_queue;
+
+	static void call_onmessage(QuickJSBinder *p_binder, const JSValueConst &p_callback, const JSValueConst &p_this, const QuickJSWorkerMessage &p_message);
 
 	static JSValue global_worker_close(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
 	static JSValue global_worker_post_message(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
@@ -25,9 +45,19 @@ public:
 
 	virtual void initialize();
 	virtual void uninitialize();
+	virtual void wake_up() const;
+
+	/* Values that cannot be cloned are converted to Variant, which fails if they hold engine objects and `p_objects_allowed` is false */
+	static bool write_message(JSContext *ctx, const JSValueConst &p_value, const JSValueConst &p_transfer, bool p_structured_clone, QuickJSWorkerMessage &r_message, bool p_objects_allowed = true);
+	/* Messages are consumed by the read unless `p_consume` is false, which is only allowed for messages without transferred buffers */
+	static JSValue read_message(JSContext *ctx, const QuickJSWorkerMessage &p_message, bool p_consume = true);
+	static void free_message(JSRuntime *rt, const QuickJSWorkerMessage &p_message);
+
+	_FORCE_INLINE_ void set_structured_clone(bool p_enabled) { structured_clone = p_enabled; }
+	_FORCE_INLINE_ bool is_structured_clone() const { return structured_clone; }
 
 	bool frame_of_host(QuickJSBinder *host, const JSValueConst &value);
-	void post_message_from_host(const Variant &p_message);
+	bool post_message_from_host(const QuickJSWorkerMessage &p_message);
 	void start(const String &p_path);
 	void stop();
 };